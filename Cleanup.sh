@@ -59,6 +59,12 @@ rm *.o
 rm *.d
 rm *.out
 
+#
+# Delete host test programs
+#
+
+rm -r $CurDir/tests/build
+
 #
 # Return to folder started from
 #
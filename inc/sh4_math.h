@@ -1,6 +1,6 @@
 // ---- sh4_math.h - SH7091 Math Module ----
 //
-// Version 1.1.4
+// Version 1.1.5
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -925,6 +925,22 @@ static inline __attribute__((always_inline)) _Complex float MATH_fsca_Float_Rad(
 
   // Get 2x2 matrix from XMTRX quadrant
   RETURN_VECTOR_STRUCT MATH_Get_XMTRX_2x2(unsigned int which)
+
+  //------------------------------------------------------------------------------
+  // Matrix inverse operations
+  //------------------------------------------------------------------------------
+
+  // General 4x4 matrix inverse (returns determinant, 0 if singular)
+  float MATH_Matrix_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+
+  // Affine 4x4 matrix inverse (returns determinant of upper 3x3, 0 if singular)
+  float MATH_Matrix_Affine_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+
+  // Orthonormal affine 4x4 matrix inverse (rotation + translation only)
+  ALL_FLOATS_STRUCT * MATH_Matrix_Orthonormal_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+
+  // Normal matrix, inverse-transpose of upper 3x3 (returns determinant, 0 if singular)
+  float MATH_Normal_Matrix(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
 */
 
 //------------------------------------------------------------------------------
@@ -1802,6 +1818,284 @@ static inline __attribute__((always_inline)) RETURN_VECTOR_STRUCT MATH_Get_XMTRX
 // the best way to go for performance reasons anyways, and in that situation one
 // can just throw calling convention to the wind until returning back to C.
 
+//------------------------------------------------------------------------------
+// Matrix inverse operations
+//------------------------------------------------------------------------------
+//
+// These take an ALL_FLOATS_STRUCT matrix in the same column-major layout used by
+// XMTRX (FV0 is the first column, FV12 is the fourth column), and write the
+// result to another ALL_FLOATS_STRUCT. The input and output may not be the same
+// struct. If 'load_xmtrx' is nonzero, the result is also loaded into XMTRX so
+// that it can go straight into MATH_Matrix_Transform() or MATH_Matrix_Product().
+//
+// An affine matrix here means that the bottom row is [ 0 0 0 1 ], i.e. that fr3,
+// fr7, and fr11 are 0 and fr15 is 1. The translation is stored in fr12-fr14:
+//
+//    FV0 FV4 FV8  FV12
+//    --- --- ---  ----
+//  [ fr0 fr4 fr8  fr12 ]
+//  [ fr1 fr5 fr9  fr13 ]
+//  [ fr2 fr6 fr10 fr14 ]
+//  [  0   0   0    1   ]
+//
+// The functions that can fail return the determinant of the input matrix (or of
+// its upper 3x3 for the affine versions). If it is 0, the matrix is singular and
+// the output is left untouched (and XMTRX is not loaded).
+//
+// NOTE: These clobber XMTRX, even if 'load_xmtrx' is 0. The general inverse
+// does not use XMTRX, but the affine and orthonormal versions use 'ftrv' to do
+// the translation part of the inverse.
+//
+
+// Internal helper: finishes an affine inverse whose upper 3x3 has already been
+// written to 'output' by computing the inverted translation with 'ftrv':
+//
+//  translation' = -(upper 3x3 of output) * translation
+//
+static inline __attribute__((always_inline)) void xMATH_Finish_Affine_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+{
+  output->fr3 = 0.0f;
+  output->fr7 = 0.0f;
+  output->fr11 = 0.0f;
+  output->fr12 = 0.0f;
+  output->fr13 = 0.0f;
+  output->fr14 = 0.0f;
+  output->fr15 = 1.0f;
+
+  MATH_Load_XMTRX(output);
+  RETURN_VECTOR_STRUCT translation = MATH_Matrix_Transform(-input->fr12, -input->fr13, -input->fr14, 0.0f);
+
+  output->fr12 = translation.z1;
+  output->fr13 = translation.z2;
+  output->fr14 = translation.z3;
+
+  if(load_xmtrx)
+  {
+    // The translation column in XMTRX is still 0, so just reload the whole thing.
+    MATH_Load_XMTRX(output);
+  }
+}
+
+// General 4x4 matrix inverse
+//
+// This uses the Laplace expansion of 2x2 sub-determinants, which only needs 12
+// 2x2 determinants and one divide to get the whole inverse. Since the inverse
+// of a transpose is the transpose of the inverse, the formula works the same
+// way regardless of row- or column-major storage.
+//
+// PLEASE NOTE: This is written in C on purpose, as MATH_fipr() pins its inputs
+// to FV4 and FV8, which would serialize all 16 of the cofactor dot products.
+// Plain fmul/fmac lets GCC interleave the loads and keep the FE pipe full.
+// Also, a real divide is used for 1/det instead of MATH_Fast_Invert(), as the
+// fsrra error would get multiplied into every element of the result.
+//
+// Use MATH_Matrix_Affine_Inverse() or MATH_Matrix_Orthonormal_Inverse() when
+// the bottom row is known to be [ 0 0 0 1 ]--they are much faster.
+static inline __attribute__((always_inline)) float MATH_Matrix_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+{
+  float m0 = input->fr0, m1 = input->fr1, m2 = input->fr2, m3 = input->fr3;
+  float m4 = input->fr4, m5 = input->fr5, m6 = input->fr6, m7 = input->fr7;
+  float m8 = input->fr8, m9 = input->fr9, m10 = input->fr10, m11 = input->fr11;
+  float m12 = input->fr12, m13 = input->fr13, m14 = input->fr14, m15 = input->fr15;
+
+  // 2x2 sub-determinants of the first two columns
+  float s0 = m0 * m5 - m4 * m1;
+  float s1 = m0 * m6 - m4 * m2;
+  float s2 = m0 * m7 - m4 * m3;
+  float s3 = m1 * m6 - m5 * m2;
+  float s4 = m1 * m7 - m5 * m3;
+  float s5 = m2 * m7 - m6 * m3;
+
+  // 2x2 sub-determinants of the last two columns
+  float c5 = m10 * m15 - m14 * m11;
+  float c4 = m9 * m15 - m13 * m11;
+  float c3 = m9 * m14 - m13 * m10;
+  float c2 = m8 * m15 - m12 * m11;
+  float c1 = m8 * m14 - m12 * m10;
+  float c0 = m8 * m13 - m12 * m9;
+
+  float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+  if(det == 0.0f)
+  {
+    return 0.0f;
+  }
+
+  float inv_det = 1.0f / det;
+
+  output->fr0 = (m5 * c5 - m6 * c4 + m7 * c3) * inv_det;
+  output->fr1 = (-m1 * c5 + m2 * c4 - m3 * c3) * inv_det;
+  output->fr2 = (m13 * s5 - m14 * s4 + m15 * s3) * inv_det;
+  output->fr3 = (-m9 * s5 + m10 * s4 - m11 * s3) * inv_det;
+
+  output->fr4 = (-m4 * c5 + m6 * c2 - m7 * c1) * inv_det;
+  output->fr5 = (m0 * c5 - m2 * c2 + m3 * c1) * inv_det;
+  output->fr6 = (-m12 * s5 + m14 * s2 - m15 * s1) * inv_det;
+  output->fr7 = (m8 * s5 - m10 * s2 + m11 * s1) * inv_det;
+
+  output->fr8 = (m4 * c4 - m5 * c2 + m7 * c0) * inv_det;
+  output->fr9 = (-m0 * c4 + m1 * c2 - m3 * c0) * inv_det;
+  output->fr10 = (m12 * s4 - m13 * s2 + m15 * s0) * inv_det;
+  output->fr11 = (-m8 * s4 + m9 * s2 - m11 * s0) * inv_det;
+
+  output->fr12 = (-m4 * c3 + m5 * c1 - m6 * c0) * inv_det;
+  output->fr13 = (m0 * c3 - m1 * c1 + m2 * c0) * inv_det;
+  output->fr14 = (-m12 * s3 + m13 * s1 - m14 * s0) * inv_det;
+  output->fr15 = (m8 * s3 - m9 * s1 + m10 * s0) * inv_det;
+
+  if(load_xmtrx)
+  {
+    MATH_Load_XMTRX(output);
+  }
+
+  return det;
+}
+
+// Affine 4x4 matrix inverse
+//
+//  [ A t ] -1   [ A^-1  -A^-1 * t ]
+//  [ 0 1 ]    = [  0        1     ]
+//
+// The rows of A^-1 are the cross products of the columns of A divided by the
+// determinant of A, and the new translation is done with a single 'ftrv'. Use
+// this for model/view matrices that contain scaling or shearing.
+static inline __attribute__((always_inline)) float MATH_Matrix_Affine_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+{
+  float a0 = input->fr0, a1 = input->fr1, a2 = input->fr2; // Column 0
+  float b0 = input->fr4, b1 = input->fr5, b2 = input->fr6; // Column 1
+  float c0 = input->fr8, c1 = input->fr9, c2 = input->fr10; // Column 2
+
+  // Column 1 X column 2
+  float bc0 = b1 * c2 - b2 * c1;
+  float bc1 = b2 * c0 - b0 * c2;
+  float bc2 = b0 * c1 - b1 * c0;
+
+  // Column 2 X column 0
+  float ca0 = c1 * a2 - c2 * a1;
+  float ca1 = c2 * a0 - c0 * a2;
+  float ca2 = c0 * a1 - c1 * a0;
+
+  // Column 0 X column 1
+  float ab0 = a1 * b2 - a2 * b1;
+  float ab1 = a2 * b0 - a0 * b2;
+  float ab2 = a0 * b1 - a1 * b0;
+
+  float det = MATH_fipr(a0, a1, a2, 0.0f, bc0, bc1, bc2, 0.0f);
+
+  if(det == 0.0f)
+  {
+    return 0.0f;
+  }
+
+  float inv_det = 1.0f / det;
+
+  // Each cross product is a row of the inverse
+  output->fr0 = bc0 * inv_det;
+  output->fr4 = bc1 * inv_det;
+  output->fr8 = bc2 * inv_det;
+
+  output->fr1 = ca0 * inv_det;
+  output->fr5 = ca1 * inv_det;
+  output->fr9 = ca2 * inv_det;
+
+  output->fr2 = ab0 * inv_det;
+  output->fr6 = ab1 * inv_det;
+  output->fr10 = ab2 * inv_det;
+
+  xMATH_Finish_Affine_Inverse(input, output, load_xmtrx);
+
+  return det;
+}
+
+// Orthonormal affine 4x4 matrix inverse
+//
+//  [ R t ] -1   [ R^T  -R^T * t ]
+//  [ 0 1 ]    = [  0       1    ]
+//
+// For rotation + translation matrices (e.g. cameras) with no scaling, the
+// inverse of the rotation part is just its transpose, so this can't fail and
+// doesn't need a divide. The result is undefined if R isn't orthonormal.
+static inline __attribute__((always_inline)) ALL_FLOATS_STRUCT * MATH_Matrix_Orthonormal_Inverse(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+{
+  output->fr0 = input->fr0;
+  output->fr1 = input->fr4;
+  output->fr2 = input->fr8;
+
+  output->fr4 = input->fr1;
+  output->fr5 = input->fr5;
+  output->fr6 = input->fr9;
+
+  output->fr8 = input->fr2;
+  output->fr9 = input->fr6;
+  output->fr10 = input->fr10;
+
+  xMATH_Finish_Affine_Inverse(input, output, load_xmtrx);
+
+  return output;
+}
+
+// Normal matrix (inverse-transpose of the upper 3x3)
+//
+//  [ A t ]
+//  [ 0 1 ]  -->  [ (A^-1)^T  0 ]
+//                [    0      1 ]
+//
+// Transforming normals by the model matrix only works right if the matrix has
+// no non-uniform scaling or shearing. This makes the matrix that works for any
+// invertible A. The columns of (A^-1)^T are the cross products of the columns
+// of A divided by the determinant of A, so no full inverse is needed.
+//
+// Pass 'load_xmtrx' to put it straight into XMTRX for transforming normals
+// with MATH_Matrix_Transform() (use w = 0 for each normal).
+static inline __attribute__((always_inline)) float MATH_Normal_Matrix(ALL_FLOATS_STRUCT * input, ALL_FLOATS_STRUCT * output, unsigned int load_xmtrx)
+{
+  float a0 = input->fr0, a1 = input->fr1, a2 = input->fr2; // Column 0
+  float b0 = input->fr4, b1 = input->fr5, b2 = input->fr6; // Column 1
+  float c0 = input->fr8, c1 = input->fr9, c2 = input->fr10; // Column 2
+
+  // Column 1 X column 2
+  float bc0 = b1 * c2 - b2 * c1;
+  float bc1 = b2 * c0 - b0 * c2;
+  float bc2 = b0 * c1 - b1 * c0;
+
+  float det = MATH_fipr(a0, a1, a2, 0.0f, bc0, bc1, bc2, 0.0f);
+
+  if(det == 0.0f)
+  {
+    return 0.0f;
+  }
+
+  float inv_det = 1.0f / det;
+
+  // Same cross products as MATH_Matrix_Affine_Inverse(), but stored as columns
+  output->fr0 = bc0 * inv_det;
+  output->fr1 = bc1 * inv_det;
+  output->fr2 = bc2 * inv_det;
+  output->fr3 = 0.0f;
+
+  output->fr4 = (c1 * a2 - c2 * a1) * inv_det;
+  output->fr5 = (c2 * a0 - c0 * a2) * inv_det;
+  output->fr6 = (c0 * a1 - c1 * a0) * inv_det;
+  output->fr7 = 0.0f;
+
+  output->fr8 = (a1 * b2 - a2 * b1) * inv_det;
+  output->fr9 = (a2 * b0 - a0 * b2) * inv_det;
+  output->fr10 = (a0 * b1 - a1 * b0) * inv_det;
+  output->fr11 = 0.0f;
+
+  output->fr12 = 0.0f;
+  output->fr13 = 0.0f;
+  output->fr14 = 0.0f;
+  output->fr15 = 1.0f;
+
+  if(load_xmtrx)
+  {
+    MATH_Load_XMTRX(output);
+  }
+
+  return det;
+}
+
 //==============================================================================
 // Miscellaneous Functions
 //==============================================================================
@@ -1,6 +1,6 @@
 // ---- startup_support.h - Dreamcast Startup Support Module Header ----
 //
-// Version 1.1.2
+// Version 1.1.4
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -58,6 +58,26 @@ extern uint32_t STARTUP_cable_type;
 // This is a global console region type for user reference (0 = JP, 1 = NA, 2 = PAL)
 extern uint32_t STARTUP_console_region;
 
+//==============================================================================
+// Exit Support
+//==============================================================================
+//
+// Functions added with STARTUP_Add_Exit_Hook() are run by startup.S when the
+// program exits, either by returning from dreamcast_main() or by jumping to
+// arch_real_exit, while dcload and the exception handlers are still set up.
+// They run most recently added first, and only once each.
+//
+
+#define STARTUP_MAX_EXIT_HOOKS 8
+
+typedef void (*STARTUP_EXIT_HOOK)(void);
+
+// Returns 1 on success, or 0 if there are already STARTUP_MAX_EXIT_HOOKS
+uint32_t STARTUP_Add_Exit_Hook(STARTUP_EXIT_HOOK hook);
+
+// startup.S calls this on exit
+void STARTUP_Run_Exit_Hooks(void);
+
 //==============================================================================
 // FPSCR Support
 //==============================================================================
@@ -197,7 +217,8 @@ extern VIDEO_PARAMS_STRUCT STARTUP_video_params;
 // everything set up the first time. Use STARTUP_Set_Video() for any runtime
 // changes. STARTUP_Init_Video() will also set the cable_type and region variables.
 //
-// The framebuffer address will always be 0xa5000000 after either runs.
+// The framebuffer address will always be 0xa5000000 after either runs, and the
+// framebuffer gets cleared to STARTUP_video_clear_color.
 //
 
 // These definitions correspond to 'fbuffer_color_mode' in the video setup and
@@ -211,13 +232,298 @@ extern VIDEO_PARAMS_STRUCT STARTUP_video_params;
 // 32-bit
 #define FB_RGB0888 3
 
+// Bytes per pixel for a 'fbuffer_color_mode': {RGB0555, RGB565} = 2Bpp,
+// {RGB888} = 3Bpp, {RGB0888} = 4Bpp (add another 1 only if 0b00)
+#define FB_BYTES_PER_PIXEL(fbuffer_color_mode) ((fbuffer_color_mode) + 1 + (0x1 ^ (((fbuffer_color_mode) & 0x1) | ((fbuffer_color_mode) >> 1))))
+
 // For "use_320x240" in STARTUP_Init_Video() and STARTUP_Set_Video()
 #define USE_640x480 0
 #define USE_320x240 1
 
+// Every video mode function clears the framebuffer to this RGB0888 color
+// (0x00RRGGBB). The default is black.
+extern uint32_t STARTUP_video_clear_color;
+
 void STARTUP_Init_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240);
 void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240);
 
+//------------------------------------------------------------------------------
+// Framebuffer Management
+//------------------------------------------------------------------------------
+//
+// Double and triple buffering for the current video mode.
+//
+// STARTUP_Set_Framebuffers() lays out 'count' framebuffers back to back in VRAM
+// starting at 0xa5000000, each sized according to STARTUP_video_params. The
+// first one is the one being displayed (the front buffer), and drawing should
+// go to STARTUP_Get_Back_Buffer(). Flipping points the display at the back
+// buffer by rewriting the framebuffer address registers (0xa05f8050/0xa05f8054)
+// during vblank, so there's no tearing and nothing gets copied.
+//
+// There are two ways to flip:
+// - STARTUP_Flip_Framebuffers() waits for vblank and flips right then. It's
+//  the simple way, but the CPU sits in a loop until vblank every frame.
+// - STARTUP_Queue_Flip() just marks the back buffer as the next one to show
+//  and returns right away, and STARTUP_Vblank_Flip() does the flip. Call that
+//  from a vblank interrupt handler, or from a loop that is waiting for vblank
+//  anyway.
+//  With 3 buffers, STARTUP_Get_Back_Buffer() then returns the third buffer,
+//  which is free to be drawn into straight away while the queued one waits
+//  for vblank; that's where triple buffering actually helps. With 2 buffers,
+//  the back buffer is still being displayed until the queued flip happens, so
+//  wait for STARTUP_Flip_Pending() to return 0 before drawing into it.
+//
+// Notes:
+// - Video mode functions always reset to a single framebuffer at 0xa5000000
+//  (and drop any queued flip), so call STARTUP_Set_Framebuffers() again after
+//  any video mode change.
+// - The framebuffers are not cleared by STARTUP_Set_Framebuffers().
+// - VRAM is 8MB, and any VRAM after the last framebuffer is free for other uses
+//  (e.g. textures). See STARTUP_Get_Framebuffers_End().
+// - Without calling STARTUP_Set_Framebuffers(), STARTUP_Get_Back_Buffer() and
+//  STARTUP_Get_Front_Buffer() both return 0xa5000000.
+//
+
+// Max number of framebuffers for STARTUP_Set_Framebuffers()
+#define MAX_FRAMEBUFFERS 3
+
+// Set up 'count' framebuffers (1 to MAX_FRAMEBUFFERS) for the current video
+// mode. The display is reset to show the first one.
+// Returns the number of framebuffers actually set up, which will be less than
+// 'count' if they don't all fit in VRAM.
+uint32_t STARTUP_Set_Framebuffers(uint32_t count);
+
+// Framebuffer currently being displayed
+void * STARTUP_Get_Front_Buffer(void);
+
+// Framebuffer to draw the next frame into: the one after the front buffer, or
+// after the queued one if there's a queued flip. It's the same as the front
+// buffer when there's only one framebuffer.
+void * STARTUP_Get_Back_Buffer(void);
+
+// First byte of VRAM (in the 0xa5000000 area) after the last framebuffer
+void * STARTUP_Get_Framebuffers_End(void);
+
+// Wait for the start of the next vertical sync
+void STARTUP_Wait_Vblank(void);
+
+// Wait for vblank, then display the back buffer. The old front buffer goes to
+// the end of the rotation. A flip that was already queued gets its own vblank
+// first.
+void STARTUP_Flip_Framebuffers(void);
+
+// Queue the back buffer to be displayed by the next STARTUP_Vblank_Flip(), and
+// return without waiting. Returns 1 if it was queued, or 0 if a flip is already
+// queued (only one can be queued at a time).
+uint32_t STARTUP_Queue_Flip(void);
+
+// Display the queued back buffer, if there is one. Call this during vblank,
+// e.g. from the vblank-in interrupt handler. It's safe to call with nothing
+// queued.
+void STARTUP_Vblank_Flip(void);
+
+// Returns 1 while a queued flip is waiting for STARTUP_Vblank_Flip()
+uint32_t STARTUP_Flip_Pending(void);
+
+// Fill a whole framebuffer of the current video mode with an RGB0888 color
+// (0x00RRGGBB), converted to the framebuffer's color mode. Writes go out as
+// 32-byte store queue bursts, so 'framebuffer' must be a 32-byte aligned VRAM
+// address, e.g. from STARTUP_Get_Back_Buffer(). This uses QACR0/1.
+void STARTUP_Fill_Framebuffer(void * framebuffer, uint32_t color);
+
+//------------------------------------------------------------------------------
+// VRAM Writes
+//------------------------------------------------------------------------------
+//
+// Uncached VRAM writes go out one bus transaction at a time, so everything that
+// writes a lot of VRAM (the video mode functions, STARTUP_Fill_Framebuffer(),
+// and the rasterizer, pixconv, and blit modules) sends it as 32-byte store
+// queue (SQ) bursts through STARTUP_SQ_Fill() and STARTUP_SQ_Copy() instead.
+//
+// VRAM also doesn't take 8-bit writes reliably, which matters for 24-bit color
+// where pixels don't line up with 16-bit halves. STARTUP_VRAM_Write_Bytes() is
+// for the odd bytes at the ends of rows and single pixels.
+//
+// Notes:
+// - SQ 'dest' must be 32-byte aligned, and only whole 32-byte blocks are written.
+// - The SQ functions set QACR0/1 for 'dest' every time, so don't call them at
+//  the same time as other SQ code that expects QACR0/1 to be set to something
+//  else (e.g. from an interrupt).
+//
+
+// Write 'blocks' 32-byte blocks to 'dest' from a pattern of words that repeats
+// every 24 words (96 bytes, a whole number of pixels in every color mode). Each
+// block takes 8 words starting at pattern[index] (index is 0 to 23), and the
+// index to use for the next block is returned. 'pattern' needs 32 words, with
+// the last 8 the same as the first 8, unless 'index' is always a multiple of 8.
+uint32_t STARTUP_SQ_Fill(void * dest, uint32_t blocks, const uint32_t * pattern, uint32_t index);
+
+// Copy 'blocks' 32-byte blocks from 'src' (4-byte aligned) to 'dest'
+void STARTUP_SQ_Copy(void * dest, const void * src, uint32_t blocks);
+
+// Write the low 'count' (0 to 4) bytes of 'bytes', lowest byte first, to 'dest'
+// at any alignment. Only 16-bit accesses are used: an odd byte at either end
+// is merged into its 16-bit half with a read-modify-write. This is plain C, so
+// it works on any memory and on any host.
+static inline __attribute__((always_inline)) void STARTUP_VRAM_Write_Bytes(void * dest, uint32_t bytes, uint32_t count)
+{
+  uint8_t * address = (uint8_t*)dest;
+
+  if(((uintptr_t)address & 0x1) && count)
+  {
+    volatile uint16_t * half = (volatile uint16_t*)(address - 1);
+    *half = (uint16_t)((*half & 0x00ff) | ((bytes & 0xff) << 8));
+    address++;
+    bytes >>= 8;
+    count--;
+  }
+
+  while(count >= 2)
+  {
+    *(volatile uint16_t*)address = (uint16_t)bytes;
+    address += 2;
+    bytes >>= 16;
+    count -= 2;
+  }
+
+  if(count)
+  {
+    volatile uint16_t * half = (volatile uint16_t*)address;
+    *half = (uint16_t)((*half & 0xff00) | (bytes & 0xff));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Table-Driven Video Modes
+//------------------------------------------------------------------------------
+//
+// Every extra VGA video mode is described by a VIDEO_TIMING_STRUCT, and
+// STARTUP_Set_Video_Mode() programs the video registers from one. The extra
+// mode functions below are just wrappers around entries in STARTUP_video_timings
+// (see video_timings.c), so adding a mode only needs a new table entry.
+//
+// Like the extra video modes, this only does something with a VGA cable, and
+// STARTUP_Init_Video() must have been run first.
+//
+
+typedef struct {
+  // Output resolution and refresh rate, as the display sees it. Fractional
+  // rates are rounded down (239.76Hz is 239) so they don't share a key with the
+  // whole-number rate in STARTUP_Find_Video_Timing().
+  uint16_t video_width;
+  uint16_t video_height;
+  uint16_t refresh_rate;
+
+  // Framebuffer size in pixels. video_scale is video_width / fb_width.
+  uint16_t fb_width;
+  uint16_t fb_height;
+
+  // Totals, including blanking. Horizontal values are all in Dreamcast pixels
+  // (27MHz), vertical values are in lines.
+  uint16_t h_total;
+  uint16_t v_total;
+
+  // Blanking periods (SPG_HBLANK, SPG_VBLANK)
+  uint16_t hblank_start;
+  uint16_t hblank_end;
+  uint16_t vblank_start;
+  uint16_t vblank_end;
+
+  // Lines on which the vblank in and vblank out interrupts fire (SPG_VBLANK_INT)
+  uint16_t vblank_in_line;
+  uint16_t vblank_out_line;
+
+  // Position of the first framebuffer pixel (VO_STARTX, VO_STARTY)
+  uint16_t start_x;
+  uint16_t start_y;
+
+  // Sync pulse widths (SPG_WIDTH). All are in pixels except for vsync_width,
+  // which is in lines. bp_width and eq_width are the broad and equalizing
+  // pulse widths.
+  uint16_t hsync_width;
+  uint16_t vsync_width;
+  uint16_t bp_width;
+  uint16_t eq_width;
+} VIDEO_TIMING_STRUCT;
+
+// Indices into STARTUP_video_timings
+#define VIDEO_TIMING_640x480_VGA 0
+#define VIDEO_TIMING_848x480_VGA 1
+#define VIDEO_TIMING_848x480_VGA_PVR 2
+#define VIDEO_TIMING_800x600_VGA 3
+#define VIDEO_TIMING_800x600_VGA_PVR 4
+#define VIDEO_TIMING_800x600_VGA_CVT 5
+#define VIDEO_TIMING_800x600_VGA_CVT_PVR 6
+#define VIDEO_TIMING_1024x768_VGA 7
+#define VIDEO_TIMING_1024x768_VGA_PVR 8
+#define VIDEO_TIMING_1152x864_VGA 9
+#define VIDEO_TIMING_1152x864_VGA_PVR 10
+#define VIDEO_TIMING_720p_VGA 11
+#define VIDEO_TIMING_720p_VGA_PVR 12
+#define VIDEO_TIMING_1280x720_VGA 13
+#define VIDEO_TIMING_1280x720_VGA_PVR 14
+#define VIDEO_TIMING_1280x800_VGA 15
+#define VIDEO_TIMING_1280x800_VGA_PVR 16
+#define VIDEO_TIMING_1280x960_VGA 17
+#define VIDEO_TIMING_1440x900_VGA 18
+#define VIDEO_TIMING_1440x900_VGA_PVR 19
+#define VIDEO_TIMING_640x480_VGA_75 20
+#define VIDEO_TIMING_640x480_VGA_75_PVR 21
+#define VIDEO_TIMING_800x600_VGA_75 22
+#define VIDEO_TIMING_800x600_VGA_75_PVR 23
+#define VIDEO_TIMING_1024x768_VGA_75 24
+#define VIDEO_TIMING_1152x864_VGA_75 25
+#define VIDEO_TIMING_480p_VGA_120 26
+#define VIDEO_TIMING_640x480_VGA_120 27
+#define VIDEO_TIMING_640x480_VGA_120_PVR 28
+#define VIDEO_TIMING_800x600_VGA_120 29
+#define VIDEO_TIMING_1024x768_VGA_120 30
+#define VIDEO_TIMING_480p_VGA_240 31
+#define VIDEO_TIMING_480p_VGA_239 32
+#define VIDEO_TIMING_640x480_VGA_75_CVT_RBv2 33
+#define VIDEO_TIMING_848x480_VGA_CVT_RBv2 34
+
+#define VIDEO_TIMING_COUNT 35
+
+// The timing table, in the same order as the mode list above (plus standard
+// 640x480 VGA first)
+extern const VIDEO_TIMING_STRUCT STARTUP_video_timings[VIDEO_TIMING_COUNT];
+
+// Set a VGA video mode from a timing description
+void STARTUP_Set_Video_Mode(const VIDEO_TIMING_STRUCT * timing, uint8_t fbuffer_color_mode);
+
+// Find a mode in STARTUP_video_timings by its output resolution and refresh
+// rate. Set 'pvr_32x32' to only match modes with a framebuffer that is a
+// multiple of 32x32. When there's more than one match, the first one in the
+// table wins, which is the raw mode before its PVR 32x32 version. Alternate
+// timings for a resolution and refresh rate that's already in the table (the
+// _CVT and _CVT_RBv2 modes, 1280x720 after 720p, and 640x480@120 after
+// 480p@120) can only be used by index.
+// Returns 0 (NULL) if no mode matches.
+const VIDEO_TIMING_STRUCT * STARTUP_Find_Video_Timing(uint32_t video_width, uint32_t video_height, uint32_t refresh_rate, uint32_t pvr_32x32);
+
+// For 'cvt_type' in STARTUP_Generate_Video_Timing()
+#define CVT_STANDARD 0
+#define CVT_RB 1
+#define CVT_RBV2 2
+
+// Generate a VGA mode for any resolution and refresh rate using VESA CVT
+// (standard, reduced blanking, or reduced blanking v2) timings, scaled to the
+// Dreamcast's 27MHz pixel clock with the same trick as the extra video modes.
+// Pass the result to STARTUP_Set_Video_Mode(). The hsync gets capped at 64
+// Dreamcast pixels, just like some of the DMT modes.
+// This is pure math, so it can run anywhere (tests/video_timings_test.c checks
+// it on a PC). Against the CVT-derived entries in STARTUP_video_timings, the
+// output is exact for 800x600, 1152x864, 1280x720, and 1280x800 @ 60Hz and for
+// 640x480 and 800x600 @ 120Hz RB. 1440x900 has bp_width off by 1, the RBv2
+// entries are the PVR 32x32 versions and differ by up to 2 pixels, and
+// 1024x768 @ 120Hz RB has a hand-tuned hsync and start_x that differ by up to
+// 9 pixels.
+// Returns the mode's video_scale, or 0.0f if the mode can't be done (e.g. it
+// needs more than 1024 total lines or pixels, or is under 8 pixels wide), in
+// which case 'timing' is left alone.
+float STARTUP_Generate_Video_Timing(VIDEO_TIMING_STRUCT * timing, uint32_t width, uint32_t height, uint32_t refresh_rate, uint32_t cvt_type);
+
 //------------------------------------------------------------------------------
 // Extra Video Modes
 //------------------------------------------------------------------------------
@@ -226,6 +532,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240);
 //
 // Notes:
 // - The framebuffer address will always be set to 0xa5000000 after any of these run.
+// - The framebuffer gets cleared to STARTUP_video_clear_color, same as with
+// STARTUP_Set_Video().
 // - Modes marked "PVR 32x32" have a framebuffer that is an integer multiple of 32x32.
 // - Some of the raw modes are naturally 32x32-aligned, but some are not. A function
 // with "_PVR" appended to its name means it is a modified version of a non-multiple
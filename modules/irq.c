@@ -0,0 +1,465 @@
+// ---- irq.c - Interrupt and Exception Dispatch Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module installs a VBR table that sends interrupts and exceptions to C
+// handlers, one per event code. It is hereby released into the public domain in
+// the hope that it may prove useful.
+//
+
+// See irq.h for usage notes.
+#include <stddef.h>
+#include "irq.h"
+
+// Interrupt priority registers (16-bit)
+#define IRQ_INTC_IPRA 0xFFD00004
+
+// Low half of performance counter 1
+#define IRQ_PMCTR1L 0xFF100008
+
+// SR fields
+#define IRQ_SR_BL 0x10000000
+#define IRQ_SR_IMASK 0x000000f0
+#define IRQ_SR_IMASK_SHIFT 4
+
+// For putting C constants into the vector table
+#define IRQ_STRINGIFY_VALUE(x) #x
+#define IRQ_STRINGIFY(x) IRQ_STRINGIFY_VALUE(x)
+
+IRQ_CONTEXT_STRUCT IRQ_context;
+
+// These are used by the vector table, so they can't be optimized out or renamed
+__attribute__((used)) static IRQ_HANDLER irq_handlers[IRQ_EVENT_COUNT];
+__attribute__((used)) static uint32_t irq_old_vbr = 0;
+
+static IRQ_STATS_STRUCT irq_stats[IRQ_EVENT_COUNT];
+
+// Vector table, below
+extern const char irq_vbr_table[];
+
+//------------------------------------------------------------------------------
+// Dispatch
+//------------------------------------------------------------------------------
+//
+// The vector table has to be in a .c file so that it gets picked up by the
+// default compile script with the rest of the module, so here it is as a
+// top-level asm block. It gets its own section so that .org offsets are from
+// the start of the table.
+//
+// On entry to any vector the CPU has set SR.MD, SR.RB, and SR.BL, so R0-R7 are
+// bank 1 and free to use, and SPC/SSR hold the interrupted PC/SR. The first
+// thing each vector does is read performance counter 1 into r6, so that the
+// stats include the time it takes to get to the handler.
+//
+
+__asm__ (
+  ".pushsection .text.irq_vbr_table, \"ax\", @progbits\n"
+  ".balign 32\n"
+"_irq_vbr_table:\n"
+
+  //
+  // VBR + 0x100: General exceptions
+  //
+  ".org 0x100\n"
+"irq_vector_general:\n\t"
+    "mov.l IRQ_general_pmctr1l_address, r6\n\t"
+    "mov.l @r6, r6\n\t" // r6 = entry time
+    "mov.l IRQ_general_expevt_address, r0\n\t"
+    "mov.l @r0, r4\n\t" // r4 = event code
+    "bra irq_dispatch_asm\n\t"
+    " mov #1, r5\n" // r5 = vector offset >> 8
+  // The main literal pool is too far away from here
+  ".align 2\n"
+"IRQ_general_expevt_address:\n\t"
+    ".long 0xff000024\n"
+"IRQ_general_pmctr1l_address:\n\t"
+    ".long " IRQ_STRINGIFY(IRQ_PMCTR1L) "\n"
+
+  //
+  // VBR + 0x400: TLB miss exceptions (always passed along)
+  //
+  ".org 0x400\n"
+"irq_vector_tlb_miss:\n\t"
+    "mov.l IRQ_pmctr1l_address, r6\n\t"
+    "mov.l @r6, r6\n\t" // r6 = entry time
+    "mov.l IRQ_expevt_address, r0\n\t"
+    "mov.l @r0, r4\n\t" // r4 = event code
+    "bra irq_chain_asm\n\t"
+    " mov #4, r5\n"
+
+  //
+  // VBR + 0x600: Interrupts
+  //
+  ".org 0x600\n"
+"irq_vector_interrupt:\n\t"
+    "mov.l IRQ_pmctr1l_address, r6\n\t"
+    "mov.l @r6, r6\n\t" // r6 = entry time
+    "mov.l IRQ_intevt_address, r0\n\t"
+    "mov.l @r0, r4\n\t" // r4 = event code
+    "mov #6, r5\n" // r5 = vector offset >> 8
+
+    // Fall through
+
+  //
+  // Common dispatch: r4 = event code, r5 = vector offset >> 8, r6 = entry time
+  //
+"irq_dispatch_asm:\n\t"
+    "mov r4, r0\n\t"
+    "shlr2 r0\n\t"
+    "shlr r0\n\t" // r0 = (event code >> 5) * 4, the handler's offset in the table
+    "mov.w IRQ_table_bytes, r1\n\t"
+    "cmp/hs r1, r0\n\t"
+    "bt irq_chain_asm\n\t" // Out of range
+    "mov.l IRQ_handlers_address, r1\n\t"
+    "mov.l @(r0, r1), r2\n\t" // r2 = handler
+    "tst r2, r2\n\t"
+    "bt irq_chain_asm\n\t" // No handler
+
+    // Call the handler in r2
+"irq_call_asm:\n\t"
+    // Save what C code can clobber outside of bank 1
+    "sts.l pr, @-r15\n\t"
+    "sts.l mach, @-r15\n\t"
+    "sts.l macl, @-r15\n\t"
+    "sts.l fpul, @-r15\n\t"
+    "sts.l fpscr, @-r15\n\t"
+
+    // Default FPU mode (single precision, 32-bit moves, DN = 1), but keep FR
+    // so the same bank gets saved and restored
+    "sts fpscr, r1\n\t"
+    "mov.l IRQ_fpscr_fr_bit, r3\n\t"
+    "and r3, r1\n\t"
+    "mov.l IRQ_fpscr_default, r3\n\t"
+    "or r3, r1\n\t"
+    "lds r1, fpscr\n\t"
+
+    "fmov.s fr11, @-r15\n\t"
+    "fmov.s fr10, @-r15\n\t"
+    "fmov.s fr9, @-r15\n\t"
+    "fmov.s fr8, @-r15\n\t"
+    "fmov.s fr7, @-r15\n\t"
+    "fmov.s fr6, @-r15\n\t"
+    "fmov.s fr5, @-r15\n\t"
+    "fmov.s fr4, @-r15\n\t"
+    "fmov.s fr3, @-r15\n\t"
+    "fmov.s fr2, @-r15\n\t"
+    "fmov.s fr1, @-r15\n\t"
+    "fmov.s fr0, @-r15\n\t"
+
+    // Fill in IRQ_context
+    "mov.l IRQ_context_address, r1\n\t"
+    "stc spc, r3\n\t"
+    "mov.l r3, @r1\n\t"
+    "stc ssr, r3\n\t"
+    "mov.l r3, @(4, r1)\n\t"
+    "sts pr, r3\n\t"
+    "mov.l r3, @(8, r1)\n\t"
+    "mov.l r4, @(12, r1)\n\t"
+
+    // irq_dispatch(event code, handler, entry time)
+    "mov.l IRQ_dispatch_address, r0\n\t"
+    "jsr @r0\n\t"
+    " mov r2, r5\n\t"
+
+    // The handler may have changed where to return to
+    "mov.l IRQ_context_address, r1\n\t"
+    "mov.l @r1, r3\n\t"
+    "ldc r3, spc\n\t"
+    "mov.l @(4, r1), r3\n\t"
+    "ldc r3, ssr\n\t"
+
+    // Restore everything in reverse (FPSCR last, since the FR restores need
+    // 32-bit moves)
+    "fmov.s @r15+, fr0\n\t"
+    "fmov.s @r15+, fr1\n\t"
+    "fmov.s @r15+, fr2\n\t"
+    "fmov.s @r15+, fr3\n\t"
+    "fmov.s @r15+, fr4\n\t"
+    "fmov.s @r15+, fr5\n\t"
+    "fmov.s @r15+, fr6\n\t"
+    "fmov.s @r15+, fr7\n\t"
+    "fmov.s @r15+, fr8\n\t"
+    "fmov.s @r15+, fr9\n\t"
+    "fmov.s @r15+, fr10\n\t"
+    "fmov.s @r15+, fr11\n\t"
+    "lds.l @r15+, fpscr\n\t"
+    "lds.l @r15+, fpul\n\t"
+    "lds.l @r15+, macl\n\t"
+    "lds.l @r15+, mach\n\t"
+    "lds.l @r15+, pr\n\t"
+    "rte\n\t"
+    " nop\n"
+
+  //
+  // Pass the event along to the old VBR: r5 = vector offset >> 8. If there
+  // isn't one, irq_unhandled() deals with it instead.
+  //
+"irq_chain_asm:\n\t"
+    "mov.l IRQ_old_vbr_address, r0\n\t"
+    "mov.l @r0, r0\n\t"
+    "tst r0, r0\n\t"
+    "bt irq_unhandled_asm\n\t"
+    "shll8 r5\n\t"
+    "add r5, r0\n\t"
+    "jmp @r0\n\t"
+    " nop\n"
+
+"irq_unhandled_asm:\n\t"
+    "mov.l IRQ_unhandled_address, r2\n\t"
+    "bra irq_call_asm\n\t"
+    " nop\n"
+
+  // Read-only data
+  ".align 2\n"
+"IRQ_expevt_address:\n\t"
+    ".long 0xff000024\n"
+"IRQ_intevt_address:\n\t"
+    ".long 0xff000028\n"
+"IRQ_pmctr1l_address:\n\t"
+    ".long " IRQ_STRINGIFY(IRQ_PMCTR1L) "\n"
+"IRQ_handlers_address:\n\t"
+    ".long _irq_handlers\n"
+"IRQ_old_vbr_address:\n\t"
+    ".long _irq_old_vbr\n"
+"IRQ_context_address:\n\t"
+    ".long _IRQ_context\n"
+"IRQ_dispatch_address:\n\t"
+    ".long _irq_dispatch\n"
+"IRQ_unhandled_address:\n\t"
+    ".long _irq_unhandled\n"
+"IRQ_fpscr_fr_bit:\n\t"
+    ".long 0x00200000\n"
+"IRQ_fpscr_default:\n\t"
+    ".long 0x00040000\n"
+"IRQ_table_bytes:\n\t"
+    ".word (" IRQ_STRINGIFY(IRQ_EVENT_COUNT) ") * 4\n"
+
+  ".popsection\n"
+);
+
+// Called from the vector table with a handler that exists, or irq_unhandled()
+__attribute__((used)) static void irq_dispatch(uint32_t event_code, IRQ_HANDLER handler, uint32_t entry_time)
+{
+  handler(event_code);
+
+  uint32_t time = *(volatile uint32_t*)IRQ_PMCTR1L - entry_time;
+  uint32_t index = event_code >> 5;
+
+  if(index >= IRQ_EVENT_COUNT)
+  {
+    return;
+  }
+
+  IRQ_STATS_STRUCT * stats = &irq_stats[index];
+  stats->count++;
+  stats->total_time += time;
+  if(time > stats->max_time)
+  {
+    stats->max_time = time;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Unhandled events
+//------------------------------------------------------------------------------
+//
+// These have no handler and no old VBR to go to. Just returning would take the
+// same interrupt again right away, forever, so its source gets shut off first.
+//
+
+// On-chip interrupt sources, by event code range
+static const struct {
+  uint16_t first_event;
+  uint16_t last_event;
+  uint16_t source;
+} irq_onchip_sources[] = {
+  {IRQ_EVENT_TMU0, IRQ_EVENT_TMU0, IRQ_SOURCE_TMU0},
+  {IRQ_EVENT_TMU1, IRQ_EVENT_TMU1, IRQ_SOURCE_TMU1},
+  {IRQ_EVENT_TMU2, IRQ_EVENT_TMU2_INPUT_CAPTURE, IRQ_SOURCE_TMU2},
+  {IRQ_EVENT_RTC_ALARM, IRQ_EVENT_RTC_CARRY, IRQ_SOURCE_RTC},
+  {IRQ_EVENT_SCI_ERI, IRQ_EVENT_SCI_TEI, IRQ_SOURCE_SCI},
+  {IRQ_EVENT_WDT, IRQ_EVENT_WDT, IRQ_SOURCE_WDT},
+  {IRQ_EVENT_REF_RCMI, IRQ_EVENT_REF_ROVI, IRQ_SOURCE_REF},
+  {IRQ_EVENT_UDI, IRQ_EVENT_UDI, IRQ_SOURCE_UDI},
+  {IRQ_EVENT_GPIO, IRQ_EVENT_GPIO, IRQ_SOURCE_GPIO},
+  {IRQ_EVENT_DMAC_DMTE0, IRQ_EVENT_DMAC_DMAE, IRQ_SOURCE_DMAC},
+  {IRQ_EVENT_SCIF_ERI, IRQ_EVENT_SCIF_TXI, IRQ_SOURCE_SCIF}
+};
+
+#define IRQ_ONCHIP_SOURCE_COUNT (sizeof(irq_onchip_sources) / sizeof(irq_onchip_sources[0]))
+
+__attribute__((used)) static void irq_unhandled(uint32_t event_code)
+{
+  // External interrupts: Holly's own mask registers aren't this module's
+  // business, so mask the level (and everything below it) in the SR that gets
+  // restored. A handler registered later won't see it until the interrupted
+  // code lowers SR.IMASK again.
+  if((event_code >= IRQ_EVENT_IRL(15)) && (event_code <= IRQ_EVENT_IRL(1)))
+  {
+    uint32_t level = 15 - ((event_code - IRQ_EVENT_IRL(15)) >> 5);
+
+    if(((IRQ_context.ssr & IRQ_SR_IMASK) >> IRQ_SR_IMASK_SHIFT) < level)
+    {
+      IRQ_context.ssr = (IRQ_context.ssr & ~IRQ_SR_IMASK) | (level << IRQ_SR_IMASK_SHIFT);
+    }
+    return;
+  }
+
+  // On-chip interrupts: disable the source by setting its priority to 0
+  for(uint32_t i = 0; i < IRQ_ONCHIP_SOURCE_COUNT; i++)
+  {
+    if((event_code >= irq_onchip_sources[i].first_event) && (event_code <= irq_onchip_sources[i].last_event))
+    {
+      IRQ_Set_Priority(irq_onchip_sources[i].source, 0);
+      return;
+    }
+  }
+
+  // NMI is edge-triggered, and TRAPA returns to the instruction after it, so
+  // it's fine to just return from those. Any other exception would re-run the
+  // instruction that caused it, so stop here instead, where IRQ_context still
+  // shows what happened.
+  if((event_code != IRQ_EVENT_NMI) && (event_code != IRQ_EVENT_TRAPA))
+  {
+    while(1)
+    {
+      // Nowhere to go
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Setup
+//------------------------------------------------------------------------------
+
+static inline __attribute__((always_inline)) uint32_t irq_get_sr(void)
+{
+  uint32_t sr;
+  asm volatile ("stc sr, %[out]\n" : [out] "=r" (sr) : : );
+  return sr;
+}
+
+static inline __attribute__((always_inline)) void irq_set_sr(uint32_t sr)
+{
+  asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr) : "memory");
+}
+
+void IRQ_Init(void)
+{
+  uint32_t old_sr = irq_get_sr();
+
+  // Nothing can be taken while the table is being set up
+  irq_set_sr(old_sr | IRQ_SR_BL);
+
+  for(uint32_t i = 0; i < IRQ_EVENT_COUNT; i++)
+  {
+    irq_handlers[i] = NULL;
+  }
+
+  IRQ_Reset_Stats();
+
+  uint32_t vbr;
+  asm volatile ("stc vbr, %[out]\n" : [out] "=r" (vbr) : : );
+
+  // Don't chain to ourselves if this is called twice
+  if(vbr != (uint32_t)irq_vbr_table)
+  {
+    irq_old_vbr = vbr;
+    asm volatile ("ldc %[in], vbr\n" : : [in] "r" ((uint32_t)irq_vbr_table) : "memory");
+  }
+
+  irq_set_sr(old_sr & ~IRQ_SR_BL);
+}
+
+void IRQ_Shutdown(void)
+{
+  IRQ_Set_Mask_Level(15);
+
+  if(irq_old_vbr)
+  {
+    asm volatile ("ldc %[in], vbr\n" : : [in] "r" (irq_old_vbr) : "memory");
+    irq_old_vbr = 0;
+  }
+}
+
+IRQ_HANDLER IRQ_Set_Handler(uint32_t event_code, IRQ_HANDLER handler)
+{
+  uint32_t index = event_code >> 5;
+
+  if(index >= IRQ_EVENT_COUNT)
+  {
+    return NULL;
+  }
+
+  // A single aligned store, so this is safe even with interrupts enabled
+  IRQ_HANDLER old_handler = irq_handlers[index];
+  irq_handlers[index] = handler;
+
+  return old_handler;
+}
+
+void IRQ_Set_Priority(uint32_t source, uint32_t priority)
+{
+  volatile uint16_t * ipr = (volatile uint16_t*)(IRQ_INTC_IPRA + ((source >> 4) << 2));
+  uint32_t shift = source & 0xf;
+
+  uint32_t old_level = IRQ_Set_Mask_Level(15);
+  *ipr = (uint16_t)((*ipr & ~(0xf << shift)) | ((priority & 0xf) << shift));
+  IRQ_Set_Mask_Level(old_level);
+}
+
+uint32_t IRQ_Set_Mask_Level(uint32_t level)
+{
+  uint32_t sr = irq_get_sr();
+  irq_set_sr((sr & ~IRQ_SR_IMASK) | ((level & 0xf) << IRQ_SR_IMASK_SHIFT));
+
+  return (sr & IRQ_SR_IMASK) >> IRQ_SR_IMASK_SHIFT;
+}
+
+void IRQ_Sleep_Until(volatile uint32_t * flag)
+{
+  uint32_t sr = irq_get_sr();
+
+  // With SR.BL set, interrupts are held pending instead of taken, except in
+  // sleep mode, where one that isn't masked by SR.IMASK still wakes the CPU
+  // and gets taken. So nothing can set the flag between checking it and
+  // sleeping.
+  irq_set_sr(sr | IRQ_SR_BL);
+
+  while(!*flag)
+  {
+    asm volatile ("sleep\n" : : : "memory");
+  }
+
+  irq_set_sr(sr);
+}
+
+//------------------------------------------------------------------------------
+// Stats
+//------------------------------------------------------------------------------
+
+const IRQ_STATS_STRUCT * IRQ_Get_Stats(uint32_t event_code)
+{
+  uint32_t index = event_code >> 5;
+
+  if(index >= IRQ_EVENT_COUNT)
+  {
+    return NULL;
+  }
+
+  return &irq_stats[index];
+}
+
+void IRQ_Reset_Stats(void)
+{
+  for(uint32_t i = 0; i < IRQ_EVENT_COUNT; i++)
+  {
+    irq_stats[i].count = 0;
+    irq_stats[i].max_time = 0;
+    irq_stats[i].total_time = 0;
+  }
+}
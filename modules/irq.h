@@ -0,0 +1,203 @@
+// ---- irq.h - Interrupt and Exception Dispatch Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module installs a VBR table that sends interrupts and exceptions to C
+// handlers, one per event code. It is hereby released into the public domain in
+// the hope that it may prove useful.
+//
+
+#ifndef __IRQ_H_
+#define __IRQ_H_
+
+#include <stdint.h>
+
+// Notes:
+// - IRQ_Init() points VBR at this module's vector table. Anything that doesn't
+//  have a handler registered gets passed along to whatever VBR was set to
+//  before (e.g. dcload's exception handler), exactly as if this module weren't
+//  there. TLB miss exceptions are always passed along, since DreamHAL doesn't
+//  use the MMU. If VBR was 0 there's nothing to pass things along to, so an
+//  unhandled interrupt gets shut off instead of being taken again forever: an
+//  on-chip source has its priority set to 0, and an external (IRL) one has
+//  SR.IMASK raised to its level in the SR that gets restored. An unhandled NMI
+//  or TRAPA just returns, and any other unhandled exception stops in a loop.
+// - Handlers are looked up by event code, which is the value the CPU puts in
+//  INTEVT (interrupts) or EXPEVT (general exceptions). These are the IRQ_EVENT_*
+//  values below. The code is also passed to the handler, so one handler can
+//  serve several events.
+// - Handlers run with SR.BL = 1 on register bank 1, so entering a handler only
+//  saves what a C function is allowed to clobber outside of bank 1: PR, MACH,
+//  MACL, FPUL, FPSCR, and FR0-FR11. R8-R14 and FR12-FR15 are callee-saved, and
+//  bank 0's R0-R7 (the interrupted code's registers) are never touched. Handlers
+//  run on the interrupted code's stack with the FPU in the default mode (single
+//  precision, DN = 1).
+// - Since SR.BL = 1, handlers can't be interrupted, so there is no nesting.
+//  Priorities only decide which pending interrupt goes first. This also means
+//  handlers must not cause exceptions of their own, as that would reset the
+//  system. Keep handlers short.
+// - IRQ_context holds SPC, SSR, and PR of the interrupted code while a handler
+//  runs. Handlers can change IRQ_context.spc to return somewhere else (e.g. to
+//  skip over an instruction that caused an exception).
+// - Each event has an occurrence count and the time from its vector being taken
+//  until its handler returns, so the time includes the cost of getting to the
+//  handler (reading the event code, looking it up, and saving registers). Time
+//  is read from the low 32 bits of performance counter 1, so it's only
+//  meaningful when that counter is running in elapsed time mode, for example
+//  after PMCR_Init(1, PMCR_ELAPSED_TIME_MODE, PMCR_COUNT_CPU_CYCLES). The units
+//  are whatever the counter counts in.
+// - On-chip peripheral interrupt priorities are set with IRQ_Set_Priority(). A
+//  priority of 0 disables that source. External interrupts (IRL, which is how
+//  the Dreamcast's Holly chip interrupts the CPU) have a fixed priority equal to
+//  their level. An interrupt is only accepted when its priority is higher than
+//  SR.IMASK, which is 15 (everything masked) until IRQ_Set_Mask_Level() lowers it.
+//
+
+//------------------------------------------------------------------------------
+// Event codes
+//------------------------------------------------------------------------------
+//
+// General exceptions (EXPEVT)
+//
+
+#define IRQ_EVENT_ADDRESS_ERROR_READ 0x0E0
+#define IRQ_EVENT_ADDRESS_ERROR_WRITE 0x100
+#define IRQ_EVENT_FPU_EXCEPTION 0x120
+#define IRQ_EVENT_TRAPA 0x160
+#define IRQ_EVENT_ILLEGAL_INSTRUCTION 0x180
+#define IRQ_EVENT_ILLEGAL_SLOT_INSTRUCTION 0x1A0
+#define IRQ_EVENT_USER_BREAK 0x1E0
+#define IRQ_EVENT_FPU_DISABLED 0x800
+#define IRQ_EVENT_SLOT_FPU_DISABLED 0x820
+
+//
+// Interrupts (INTEVT)
+//
+
+#define IRQ_EVENT_NMI 0x1C0
+
+// External interrupts, where 'level' is 1-15 (the Dreamcast's Holly chip uses
+// levels 6, 4, and 2, i.e. 0x320, 0x360, and 0x3A0)
+#define IRQ_EVENT_IRL(level) (0x200 + ((15 - (level)) << 5))
+
+#define IRQ_EVENT_TMU0 0x400
+#define IRQ_EVENT_TMU1 0x420
+#define IRQ_EVENT_TMU2 0x440
+#define IRQ_EVENT_TMU2_INPUT_CAPTURE 0x460
+#define IRQ_EVENT_RTC_ALARM 0x480
+#define IRQ_EVENT_RTC_PERIODIC 0x4A0
+#define IRQ_EVENT_RTC_CARRY 0x4C0
+#define IRQ_EVENT_SCI_ERI 0x4E0
+#define IRQ_EVENT_SCI_RXI 0x500
+#define IRQ_EVENT_SCI_TXI 0x520
+#define IRQ_EVENT_SCI_TEI 0x540
+#define IRQ_EVENT_WDT 0x560
+#define IRQ_EVENT_REF_RCMI 0x580
+#define IRQ_EVENT_REF_ROVI 0x5A0
+#define IRQ_EVENT_UDI 0x600
+#define IRQ_EVENT_GPIO 0x620
+#define IRQ_EVENT_DMAC_DMTE0 0x640
+#define IRQ_EVENT_DMAC_DMTE1 0x660
+#define IRQ_EVENT_DMAC_DMTE2 0x680
+#define IRQ_EVENT_DMAC_DMTE3 0x6A0
+#define IRQ_EVENT_DMAC_DMAE 0x6C0
+#define IRQ_EVENT_SCIF_ERI 0x700
+#define IRQ_EVENT_SCIF_RXI 0x720
+#define IRQ_EVENT_SCIF_BRI 0x740
+#define IRQ_EVENT_SCIF_TXI 0x760
+
+// Event codes are multiples of 0x20 up to 0x820
+#define IRQ_EVENT_COUNT ((0x820 >> 5) + 1)
+
+//------------------------------------------------------------------------------
+// Interrupt priority sources
+//------------------------------------------------------------------------------
+//
+// These are (IPR register index << 4) | bit position, where IPRA is index 0,
+// IPRB is 1, and IPRC is 2.
+//
+
+#define IRQ_SOURCE_TMU0 ((0 << 4) | 12)
+#define IRQ_SOURCE_TMU1 ((0 << 4) | 8)
+#define IRQ_SOURCE_TMU2 ((0 << 4) | 4)
+#define IRQ_SOURCE_RTC ((0 << 4) | 0)
+#define IRQ_SOURCE_WDT ((1 << 4) | 12)
+#define IRQ_SOURCE_REF ((1 << 4) | 8)
+#define IRQ_SOURCE_SCI ((1 << 4) | 4)
+#define IRQ_SOURCE_GPIO ((2 << 4) | 12)
+#define IRQ_SOURCE_DMAC ((2 << 4) | 8)
+#define IRQ_SOURCE_SCIF ((2 << 4) | 4)
+#define IRQ_SOURCE_UDI ((2 << 4) | 0)
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+
+typedef void (*IRQ_HANDLER)(uint32_t event_code);
+
+typedef struct {
+  // Where the interrupted code will resume (can be changed by a handler)
+  uint32_t spc;
+  // SR of the interrupted code
+  uint32_t ssr;
+  // PR of the interrupted code
+  uint32_t pr;
+  // Event code being handled
+  uint32_t event_code;
+} IRQ_CONTEXT_STRUCT;
+
+typedef struct {
+  // Number of times the handler ran
+  uint32_t count;
+  // Time from the vector being taken until the handler returned, in
+  // performance counter 1 units
+  uint32_t max_time;
+  uint64_t total_time;
+} IRQ_STATS_STRUCT;
+
+// Only valid inside a handler
+extern IRQ_CONTEXT_STRUCT IRQ_context;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Install the vector table and clear SR.BL so that exceptions and interrupts
+// can be taken. SR.IMASK is left alone. Calling this again after it's already
+// installed just removes all of the handlers.
+void IRQ_Init(void);
+
+// Mask all interrupts and put VBR back the way it was
+void IRQ_Shutdown(void);
+
+// Set the handler for an event code. Pass NULL to remove it, which sends the
+// event back to the previous VBR. Returns the handler that was there before.
+IRQ_HANDLER IRQ_Set_Handler(uint32_t event_code, IRQ_HANDLER handler);
+
+// Set the priority (0-15) of an on-chip interrupt source (IRQ_SOURCE_*)
+void IRQ_Set_Priority(uint32_t source, uint32_t priority);
+
+// Set SR.IMASK (0-15) and return what it was before. Only interrupts with a
+// priority above the mask level are accepted, so 15 masks everything and 0
+// allows everything. To protect a critical section, use:
+//  uint32_t old_level = IRQ_Set_Mask_Level(15);
+//  ...
+//  IRQ_Set_Mask_Level(old_level);
+uint32_t IRQ_Set_Mask_Level(uint32_t level);
+
+// Put the CPU to sleep until an interrupt handler sets *flag to nonzero. The
+// flag is checked with SR.BL set, so an interrupt that comes in between the
+// check and the sleep stays pending and wakes the CPU right away instead of
+// being missed. Something that can set the flag must be unmasked by SR.IMASK,
+// or this never returns.
+void IRQ_Sleep_Until(volatile uint32_t * flag);
+
+// Occurrence and timing stats for an event code
+const IRQ_STATS_STRUCT * IRQ_Get_Stats(uint32_t event_code);
+void IRQ_Reset_Stats(void);
+
+#endif /* __IRQ_H_ */
@@ -0,0 +1,378 @@
+// ---- mipmap.c - Kaiser Mipmap Generator Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module builds mipmap chains with the Kaiser window functions from the
+// math module. It is hereby released into the public domain in the hope that it
+// may prove useful.
+//
+
+// See mipmap.h for usage notes.
+#include "mipmap.h"
+#include "sh4_math.h"
+#include "startup_support.h"
+
+// Filter state, set up once by MIPMAP_Init()
+static int32_t mipmap_taps[MIPMAP_MAX_TAPS];
+static uint32_t mipmap_num_taps = 0;
+static const int32_t mipmap_passthrough_tap[1] = {1 << MIPMAP_TAP_SHIFT};
+
+// Row and unpacked span buffers
+static uint32_t * mipmap_rows;
+static uint32_t * mipmap_span;
+
+// The row buffer fills the first 4kB OCRAM area (the linker script's .ocram
+// section). With CCR.OIX = 0, the 8kB of OCRAM is two separate 4kB areas, so
+// nothing else fits in this one. See section 4.3.6 "RAM Mode" in the SH7750
+// hardware manual.
+static uint32_t mipmap_ocram_rows[MIPMAP_RING_ROWS * MIPMAP_STRIP_WIDTH] __attribute__((section(".ocram"), aligned(32)));
+
+// These are only used if no workspace was given. The row buffer is only used
+// if OCRAM is disabled; the span is small enough to stay in the cache.
+static uint32_t mipmap_internal_rows[MIPMAP_RING_ROWS * MIPMAP_STRIP_WIDTH] __attribute__((aligned(32)));
+static uint32_t mipmap_internal_span[MIPMAP_SPAN_PIXELS] __attribute__((aligned(32)));
+
+//------------------------------------------------------------------------------
+// Pixel format helpers
+//------------------------------------------------------------------------------
+//
+// Everything gets filtered as 8 bits per channel, packed as 0xAARRGGBB.
+//
+
+static inline __attribute__((always_inline)) uint32_t unpack_pixel(const void * src, uint32_t index, uint32_t format)
+{
+  if(format == MIPMAP_FORMAT_RGB0888)
+  {
+    return ((const uint32_t*)src)[index] | 0xff000000;
+  }
+
+  uint32_t pixel = ((const uint16_t*)src)[index];
+
+  if(format == MIPMAP_FORMAT_RGB565)
+  {
+    uint32_t r = pixel >> 11;
+    uint32_t g = (pixel >> 5) & 0x3f;
+    uint32_t b = pixel & 0x1f;
+
+    // Replicate the top bits into the bottom so that full intensity stays full intensity
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+
+    return 0xff000000 | (r << 16) | (g << 8) | b;
+  }
+  else // MIPMAP_FORMAT_ARGB4444
+  {
+    // x * 17 is the same as (x << 4) | x for a nibble
+    uint32_t a = (pixel >> 12) * 17;
+    uint32_t r = ((pixel >> 8) & 0xf) * 17;
+    uint32_t g = ((pixel >> 4) & 0xf) * 17;
+    uint32_t b = (pixel & 0xf) * 17;
+
+    return (a << 24) | (r << 16) | (g << 8) | b;
+  }
+}
+
+static inline __attribute__((always_inline)) void pack_pixel(void * dst, uint32_t index, uint32_t pixel, uint32_t format)
+{
+  if(format == MIPMAP_FORMAT_RGB0888)
+  {
+    ((uint32_t*)dst)[index] = pixel & 0x00ffffff;
+    return;
+  }
+
+  uint32_t a = pixel >> 24;
+  uint32_t r = (pixel >> 16) & 0xff;
+  uint32_t g = (pixel >> 8) & 0xff;
+  uint32_t b = pixel & 0xff;
+
+  // Round to nearest instead of truncating (these are all constant divides)
+  if(format == MIPMAP_FORMAT_RGB565)
+  {
+    r = (r * 31 + 127) / 255;
+    g = (g * 63 + 127) / 255;
+    b = (b * 31 + 127) / 255;
+
+    ((uint16_t*)dst)[index] = (uint16_t)((r << 11) | (g << 5) | b);
+  }
+  else // MIPMAP_FORMAT_ARGB4444
+  {
+    a = (a + 8) / 17;
+    r = (r + 8) / 17;
+    g = (g + 8) / 17;
+    b = (b + 8) / 17;
+
+    ((uint16_t*)dst)[index] = (uint16_t)((a << 12) | (r << 8) | (g << 4) | b);
+  }
+}
+
+// Round a Q14 channel sum back to 8 bits. Negative lobes of the window can push
+// it out of range, so it needs to be clamped.
+static inline __attribute__((always_inline)) uint32_t round_channel(int32_t sum)
+{
+  sum = (sum + (1 << (MIPMAP_TAP_SHIFT - 1))) >> MIPMAP_TAP_SHIFT;
+
+  if(sum < 0)
+  {
+    return 0;
+  }
+  else if(sum > 255)
+  {
+    return 255;
+  }
+
+  return (uint32_t)sum;
+}
+
+// Apply 'num_taps' taps to 'num_taps' packed pixels spaced 'stride' words apart
+static inline __attribute__((always_inline)) uint32_t filter_pixels(const uint32_t * pixels, uint32_t stride, const int32_t * taps, uint32_t num_taps)
+{
+  int32_t a = 0, r = 0, g = 0, b = 0;
+
+  for(uint32_t k = 0; k < num_taps; k++)
+  {
+    uint32_t pixel = *pixels;
+    int32_t tap = taps[k];
+
+    a += (int32_t)(pixel >> 24) * tap;
+    r += (int32_t)((pixel >> 16) & 0xff) * tap;
+    g += (int32_t)((pixel >> 8) & 0xff) * tap;
+    b += (int32_t)(pixel & 0xff) * tap;
+
+    pixels += stride;
+  }
+
+  return (round_channel(a) << 24) | (round_channel(r) << 16) | (round_channel(g) << 8) | round_channel(b);
+}
+
+static inline __attribute__((always_inline)) int32_t clamp_index(int32_t index, int32_t size)
+{
+  if(index < 0)
+  {
+    return 0;
+  }
+  else if(index >= size)
+  {
+    return size - 1;
+  }
+
+  return index;
+}
+
+//------------------------------------------------------------------------------
+// Setup
+//------------------------------------------------------------------------------
+
+uint32_t MIPMAP_Init(float alpha, float stretch, float width, void * workspace)
+{
+  float float_taps[MIPMAP_MAX_TAPS];
+  float sum = 0.0f;
+
+  if((width <= 0.0f) || (width > (float)(MIPMAP_MAX_TAPS / 4)))
+  {
+    width = MIPMAP_DEFAULT_WIDTH;
+  }
+
+  // Window covers +/- 'width' output pixels, which is 2 * 'width' source pixels
+  // on each side. Round up to an even count so the taps are symmetric.
+  int32_t half_taps = (int32_t)(width * 2.0f);
+  if((float)half_taps < (width * 2.0f))
+  {
+    half_taps++;
+  }
+  uint32_t num_taps = (uint32_t)(half_taps * 2);
+
+  // Source pixel k of each output pixel is centered (k - half_taps + 0.5) source
+  // pixels away from the output pixel's center, which is half that in output pixels.
+  for(uint32_t k = 0; k < num_taps; k++)
+  {
+    float x = ((float)((int32_t)k - half_taps) + 0.5f) * 0.5f;
+    float_taps[k] = MATH_Kaiser_Window_Rad(x, alpha, stretch, width);
+    sum += float_taps[k];
+  }
+
+  // Normalize to Q14 and put any rounding error in the center tap so that flat
+  // colors stay exactly the same
+  float scale = (float)(1 << MIPMAP_TAP_SHIFT) / sum;
+  int32_t fixed_sum = 0;
+
+  for(uint32_t k = 0; k < num_taps; k++)
+  {
+    float tap = float_taps[k] * scale;
+    mipmap_taps[k] = (int32_t)((tap >= 0.0f) ? (tap + 0.5f) : (tap - 0.5f));
+    fixed_sum += mipmap_taps[k];
+  }
+  mipmap_taps[half_taps] += (1 << MIPMAP_TAP_SHIFT) - fixed_sum;
+
+  mipmap_num_taps = num_taps;
+
+  if(workspace)
+  {
+    mipmap_rows = (uint32_t*)workspace;
+    mipmap_span = mipmap_rows + MIPMAP_RING_ROWS * MIPMAP_STRIP_WIDTH;
+  }
+  else
+  {
+    mipmap_rows = STARTUP_use_ocram ? mipmap_ocram_rows : mipmap_internal_rows;
+    mipmap_span = mipmap_internal_span;
+  }
+
+  return num_taps;
+}
+
+//------------------------------------------------------------------------------
+// Downsampling
+//------------------------------------------------------------------------------
+
+uint32_t MIPMAP_Downsample(const void * src, void * dst, uint32_t width, uint32_t height, uint32_t format)
+{
+  uint32_t pixel_shift = (format == MIPMAP_FORMAT_RGB0888) ? 2 : 1;
+  uint32_t out_width = (width > 1) ? (width >> 1) : 1;
+  uint32_t out_height = (height > 1) ? (height >> 1) : 1;
+
+  // An axis that's already 1 pixel just gets copied through
+  const int32_t * h_taps = mipmap_taps;
+  uint32_t h_num_taps = mipmap_num_taps;
+  if(width == 1)
+  {
+    h_taps = mipmap_passthrough_tap;
+    h_num_taps = 1;
+  }
+
+  const int32_t * v_taps = mipmap_taps;
+  uint32_t v_num_taps = mipmap_num_taps;
+  if(height == 1)
+  {
+    v_taps = mipmap_passthrough_tap;
+    v_num_taps = 1;
+  }
+
+  // Source index of the first tap relative to 2 * output index
+  int32_t h_offset = 1 - (int32_t)(h_num_taps >> 1);
+  int32_t v_offset = 1 - (int32_t)(v_num_taps >> 1);
+
+  for(uint32_t strip_x = 0; strip_x < out_width; strip_x += MIPMAP_STRIP_WIDTH)
+  {
+    uint32_t strip_width = out_width - strip_x;
+    if(strip_width > MIPMAP_STRIP_WIDTH)
+    {
+      strip_width = MIPMAP_STRIP_WIDTH;
+    }
+
+    int32_t span_start = (int32_t)(strip_x << 1) + h_offset;
+    uint32_t span_length = (strip_width << 1) + h_num_taps - 2;
+
+    // Next (unclamped) source row to filter horizontally into the row buffer,
+    // and the row that's at the start of the buffer
+    int32_t next_row = v_offset;
+    int32_t base_row = v_offset;
+
+    for(uint32_t y = 0; y < out_height; y++)
+    {
+      int32_t first_row = (int32_t)(y << 1) + v_offset;
+      int32_t last_row = first_row + (int32_t)v_num_taps - 1;
+
+      // Rows before this output row's first one are never needed
+      if(next_row < first_row)
+      {
+        next_row = first_row;
+      }
+
+      // When the rest of this output row's rows won't fit, slide the ones that
+      // are still needed down to the start of the buffer. This keeps each
+      // output row's rows contiguous, so the vertical pass is just a strided
+      // filter_pixels().
+      if(last_row - base_row >= MIPMAP_RING_ROWS)
+      {
+        uint32_t * to = mipmap_rows;
+        const uint32_t * from = mipmap_rows + (uint32_t)(first_row - base_row) * MIPMAP_STRIP_WIDTH;
+
+        for(int32_t row = first_row; row < next_row; row++)
+        {
+          for(uint32_t x = 0; x < strip_width; x++)
+          {
+            to[x] = from[x];
+          }
+
+          to += MIPMAP_STRIP_WIDTH;
+          from += MIPMAP_STRIP_WIDTH;
+        }
+
+        base_row = first_row;
+      }
+
+      //
+      // Horizontal pass: fill the buffer up to the last row this output row needs
+      //
+
+      while(next_row <= last_row)
+      {
+        const uint8_t * src_row = (const uint8_t*)src + ((uint32_t)clamp_index(next_row, (int32_t)height) * (width << pixel_shift));
+
+        // Get a head start on the next row while this one gets filtered
+        const uint8_t * pref_row = (const uint8_t*)src + ((uint32_t)clamp_index(next_row + 1, (int32_t)height) * (width << pixel_shift));
+        const uint8_t * pref_start = pref_row + ((uint32_t)clamp_index(span_start, (int32_t)width) << pixel_shift);
+        const uint8_t * pref_end = pref_row + ((uint32_t)clamp_index(span_start + (int32_t)span_length - 1, (int32_t)width) << pixel_shift);
+        for(const uint8_t * pref = pref_start; pref <= pref_end; pref += 32)
+        {
+          __builtin_prefetch(pref);
+        }
+
+        // Unpack the span once, doing the edge clamping here so that the filter
+        // loop doesn't need to
+        for(uint32_t i = 0; i < span_length; i++)
+        {
+          mipmap_span[i] = unpack_pixel(src_row, (uint32_t)clamp_index(span_start + (int32_t)i, (int32_t)width), format);
+        }
+
+        uint32_t * filtered_row = mipmap_rows + (uint32_t)(next_row - base_row) * MIPMAP_STRIP_WIDTH;
+
+        for(uint32_t x = 0; x < strip_width; x++)
+        {
+          filtered_row[x] = filter_pixels(mipmap_span + (x << 1), 1, h_taps, h_num_taps);
+        }
+
+        next_row++;
+      }
+
+      //
+      // Vertical pass: filter down the buffer to make the output row
+      //
+
+      const uint32_t * window = mipmap_rows + (uint32_t)(first_row - base_row) * MIPMAP_STRIP_WIDTH;
+      uint8_t * dst_row = (uint8_t*)dst + ((y * out_width) << pixel_shift);
+
+      for(uint32_t x = 0; x < strip_width; x++)
+      {
+        pack_pixel(dst_row, strip_x + x, filter_pixels(window + x, MIPMAP_STRIP_WIDTH, v_taps, v_num_taps), format);
+      }
+    }
+  }
+
+  return (out_width * out_height) << pixel_shift;
+}
+
+uint32_t MIPMAP_Generate_Chain(const void * src, void * dst, uint32_t width, uint32_t height, uint32_t format)
+{
+  uint32_t levels = 0;
+  uint8_t * out = (uint8_t*)dst;
+
+  while((width > 1) || (height > 1))
+  {
+    uint32_t level_size = MIPMAP_Downsample(src, out, width, height, format);
+
+    // Each level is made from the previous one, which is still in the cache
+    src = out;
+    out += level_size;
+
+    width = (width > 1) ? (width >> 1) : 1;
+    height = (height > 1) ? (height >> 1) : 1;
+    levels++;
+  }
+
+  return levels;
+}
@@ -0,0 +1,107 @@
+// ---- mipmap.h - Kaiser Mipmap Generator Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module builds mipmap chains with the Kaiser window functions from the
+// math module. It is hereby released into the public domain in the hope that it
+// may prove useful.
+//
+
+#ifndef __MIPMAP_H_
+#define __MIPMAP_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires sh4_math.h (for the Kaiser window) and startup_support.h (to know
+//  whether OCRAM is enabled).
+// - Textures must be power-of-two sized, 1x1 up to 1024x1024 (rectangular is
+//  fine). Each level is an exact 2:1 decimation of the previous one, so the
+//  filter taps are the same for every level and only need to be computed once.
+//  Once an axis reaches 1 pixel, that axis is just passed through.
+// - Filtering is separable: each source row is filtered horizontally into a
+//  buffer of rows, and the buffer is then filtered vertically to make each
+//  output row. When the buffer fills up, the rows that are still needed slide
+//  down to its start, so each output row's rows are always contiguous. The row
+//  buffer lives in OCRAM when it is enabled, so the vertical pass never touches
+//  the operand cache and the source rows stream through the cache without
+//  getting evicted by the intermediate data.
+// - The row buffer is placed in the linker script's .ocram section, and it
+//  fills the first 4kB OCRAM area, so nothing else can go in .ocram when this
+//  module is linked in.
+// - The image is processed in vertical strips of MIPMAP_STRIP_WIDTH output
+//  pixels so that the row buffer always fits in one 4kB OCRAM area.
+// - Source and destination must be in cached RAM (P1), not VRAM. Generate the
+//  chain first, then upload it.
+// - All taps are fixed point (Q14), so there are no float ops in the inner loops.
+//
+
+//------------------------------------------------------------------------------
+// Mipmap formats
+//------------------------------------------------------------------------------
+
+#define MIPMAP_FORMAT_RGB565 0
+#define MIPMAP_FORMAT_ARGB4444 1
+#define MIPMAP_FORMAT_RGB0888 2
+
+//------------------------------------------------------------------------------
+// Filter configuration
+//------------------------------------------------------------------------------
+
+// Max taps per axis. 12 taps covers a Kaiser window width of up to 3 output
+// pixels, which is what NVIDIA's texture tools use by default.
+#define MIPMAP_MAX_TAPS 12
+
+// Buffer of horizontally-filtered rows (must be >= MIPMAP_MAX_TAPS; the more
+// extra rows, the less often they need to slide down)
+#define MIPMAP_RING_ROWS 16
+
+// Output pixels per strip. 16 rows * 64 pixels * 4 bytes = 4kB, which is the
+// size of one OCRAM area.
+#define MIPMAP_STRIP_WIDTH 64
+
+// Fixed point precision of the filter taps
+#define MIPMAP_TAP_SHIFT 14
+
+// Unpacked source pixels needed to filter one strip of one row
+#define MIPMAP_SPAN_PIXELS (2 * MIPMAP_STRIP_WIDTH + MIPMAP_MAX_TAPS)
+
+// Size of the workspace needed if supplying one to MIPMAP_Init()
+#define MIPMAP_WORKSPACE_SIZE ((MIPMAP_RING_ROWS * MIPMAP_STRIP_WIDTH + MIPMAP_SPAN_PIXELS) * 4)
+
+// Suggested Kaiser window parameters
+#define MIPMAP_DEFAULT_ALPHA 4.0f
+#define MIPMAP_DEFAULT_STRETCH 1.0f
+#define MIPMAP_DEFAULT_WIDTH 3.0f
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Precompute the filter taps for a Kaiser window with the given parameters.
+// 'width' is the half-width of the window in output pixels (max 3.0f).
+// 'workspace' is an optional 32-byte aligned buffer of MIPMAP_WORKSPACE_SIZE
+// bytes for the row buffer. Pass NULL to use OCRAM if it's enabled, or an
+// internal buffer if it isn't.
+// Must be called before any of the other functions in this module.
+// Returns the number of taps per axis.
+uint32_t MIPMAP_Init(float alpha, float stretch, float width, void * workspace);
+
+// Make one mipmap level. 'width' and 'height' are the size of 'src'; 'dst' will
+// get an image that is half the size in each dimension (minimum 1).
+// Returns the number of bytes written to 'dst'.
+uint32_t MIPMAP_Downsample(const void * src, void * dst, uint32_t width, uint32_t height, uint32_t format);
+
+// Make all of the mipmap levels below 'src', down to 1x1. They are written to
+// 'dst' back to back, largest first (i.e. dst starts with the (width/2)x(height/2)
+// level). 'dst' needs to be 1/3 the size of 'src' for square textures (plus a
+// few bytes for the smallest levels), and up to the size of 'src' for very
+// narrow ones.
+// Returns the number of levels written.
+uint32_t MIPMAP_Generate_Chain(const void * src, void * dst, uint32_t width, uint32_t height, uint32_t format);
+
+#endif /* __MIPMAP_H_ */
@@ -0,0 +1,564 @@
+// ---- overlay.c - Performance Overlay Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module draws a small performance dashboard straight into the
+// framebuffer: frame and CPU time against the frame budget, performance zones,
+// and memory high-water marks, as text and bars. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+// See overlay.h for usage notes.
+#include <stddef.h>
+#include "overlay.h"
+#include "rasterizer.h"
+#include "perfctr.h"
+#include "digits.h"
+#include "startup_support.h"
+
+#define OVERLAY_SR_IMASK 0x000000f0
+
+// Written below the stack pointer at OVERLAY_Init()
+#define OVERLAY_STACK_PAINT 0x57ac57ac
+// Room left for OVERLAY_Init()'s own stack frame
+#define OVERLAY_STACK_MARGIN 256
+// How much of the painted area is checked per OVERLAY_Draw(), so that one draw
+// only touches a few cache lines of it
+#define OVERLAY_STACK_SCAN_BYTES 2048
+
+// Bars change color at these fractions of their budget
+#define OVERLAY_WARN_RATIO 0.75f
+#define OVERLAY_OVER_RATIO 1.0f
+
+// Text columns before the bar starts
+#define OVERLAY_TEXT_COLUMNS 24
+// Characters of a zone or memory name that get shown
+#define OVERLAY_NAME_COLUMNS 8
+// Line buffer size; long times push the text into the bar rather than getting
+// cut off
+#define OVERLAY_LINE_BYTES 48
+
+// Cycles per 1/100th of a millisecond
+#define OVERLAY_CYCLES_PER_10US (PMCR_SH4_CPU_FREQUENCY / 100000)
+
+// End of .bss, from the linker script
+extern char end[];
+
+typedef struct {
+  const char * name;
+  uint32_t cycles;
+} OVERLAY_TIME_STRUCT;
+
+typedef struct {
+  const char * name;
+  uint32_t capacity;
+  uint32_t high_water;
+} OVERLAY_MEMORY_STRUCT;
+
+static uint32_t overlay_x = 0;
+static uint32_t overlay_y = 0;
+
+// Frame times in CPU cycles
+static uint32_t overlay_frame_start = 0;
+static uint32_t overlay_work_done = 0;
+static uint32_t overlay_frame_cycles = 0;
+static uint32_t overlay_cpu_cycles = 0;
+static uint32_t overlay_draw_cycles = 0;
+
+// Painted stack area is [overlay_stack_bottom, overlay_stack_paint_top)
+static uint32_t * overlay_stack_bottom = NULL;
+static uint32_t * overlay_stack_paint_top = NULL;
+// Lowest word found written to, and where the next scan starts
+static uint32_t * overlay_stack_lowest = NULL;
+static uint32_t * overlay_stack_scan = NULL;
+
+static OVERLAY_TIME_STRUCT overlay_times[OVERLAY_MAX_TIMES];
+static uint32_t overlay_time_count = 0;
+
+static OVERLAY_MEMORY_STRUCT overlay_memory[OVERLAY_MAX_MEMORY];
+static uint32_t overlay_memory_count = 0;
+
+//------------------------------------------------------------------------------
+// Font
+//------------------------------------------------------------------------------
+//
+// 5x7 glyphs for ASCII 32 (space) to 95 (underscore), one byte per row, with
+// the leftmost pixel in bit 4.
+//
+
+#define OVERLAY_FIRST_CHAR 32
+#define OVERLAY_LAST_CHAR 95
+#define OVERLAY_GLYPH_ROWS 7
+
+static const uint8_t overlay_font[OVERLAY_LAST_CHAR - OVERLAY_FIRST_CHAR + 1][OVERLAY_GLYPH_ROWS] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+  {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // '!'
+  {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+  {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, // '#'
+  {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}, // '$'
+  {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // '%'
+  {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}, // '&'
+  {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}, // '''
+  {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // '('
+  {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // ')'
+  {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, // '*'
+  {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, // '+'
+  {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ','
+  {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // '-'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // '.'
+  {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // '/'
+  {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // '0'
+  {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // '1'
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // '2'
+  {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // '3'
+  {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // '4'
+  {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // '5'
+  {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // '6'
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // '7'
+  {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // '8'
+  {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // '9'
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, // ';'
+  {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // '<'
+  {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // '='
+  {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // '>'
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // '?'
+  {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}, // '@'
+  {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'A'
+  {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // 'B'
+  {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // 'C'
+  {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // 'D'
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // 'E'
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // 'F'
+  {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // 'G'
+  {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'H'
+  {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'I'
+  {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // 'J'
+  {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // 'K'
+  {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // 'L'
+  {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // 'M'
+  {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // 'N'
+  {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'O'
+  {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // 'P'
+  {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // 'Q'
+  {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // 'R'
+  {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // 'S'
+  {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // 'T'
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'U'
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'V'
+  {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // 'W'
+  {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // 'X'
+  {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // 'Y'
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // 'Z'
+  {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}, // '['
+  {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // '\'
+  {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}, // ']'
+  {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}, // '^'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}  // '_'
+};
+
+//------------------------------------------------------------------------------
+// Setup and timing
+//------------------------------------------------------------------------------
+
+void OVERLAY_Init(uint32_t x, uint32_t y)
+{
+  overlay_x = x;
+  overlay_y = y;
+  overlay_time_count = 0;
+  overlay_memory_count = 0;
+
+  // Does nothing if it's already running
+  PMCR_Init(1, PMCR_ELAPSED_TIME_MODE, PMCR_COUNT_CPU_CYCLES);
+
+  uint32_t sp;
+  asm volatile ("mov r15, %[out]\n" : [out] "=r" (sp) : : );
+
+  uint32_t top = (sp - OVERLAY_STACK_MARGIN) & ~3;
+  uint32_t bottom = top - OVERLAY_STACK_WATCH_BYTES;
+
+  // Don't paint over the program
+  if(bottom < (((uint32_t)end + 3) & ~3))
+  {
+    bottom = ((uint32_t)end + 3) & ~3;
+  }
+
+  overlay_stack_bottom = (uint32_t*)bottom;
+  overlay_stack_paint_top = (uint32_t*)top;
+  overlay_stack_lowest = (uint32_t*)top;
+  overlay_stack_scan = (uint32_t*)bottom;
+
+  // Interrupt handlers run on this stack, so nothing can be taken while it's
+  // being painted
+  uint32_t sr;
+  asm volatile ("stc sr, %[out]\n" : [out] "=r" (sr) : : );
+  asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr | OVERLAY_SR_IMASK) : "memory");
+
+  for(uint32_t * word = overlay_stack_bottom; word < overlay_stack_paint_top; word++)
+  {
+    *word = OVERLAY_STACK_PAINT;
+  }
+
+  asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr) : "memory");
+
+  overlay_frame_start = *(volatile uint32_t*)PMCTR1L_REG;
+  overlay_work_done = overlay_frame_start;
+}
+
+void OVERLAY_Frame_Start(void)
+{
+  uint32_t now = *(volatile uint32_t*)PMCTR1L_REG;
+
+  overlay_frame_cycles = now - overlay_frame_start;
+  overlay_cpu_cycles = overlay_work_done - overlay_frame_start;
+  overlay_frame_start = now;
+  // In case OVERLAY_Work_Done() doesn't get called this frame
+  overlay_work_done = now;
+}
+
+void OVERLAY_Work_Done(void)
+{
+  overlay_work_done = *(volatile uint32_t*)PMCTR1L_REG;
+}
+
+uint32_t OVERLAY_Add_Time(const char * name)
+{
+  if(overlay_time_count == OVERLAY_MAX_TIMES)
+  {
+    return 0;
+  }
+
+  OVERLAY_TIME_STRUCT * time = &overlay_times[overlay_time_count];
+  time->name = name;
+  time->cycles = 0;
+
+  overlay_time_count++;
+
+  return overlay_time_count;
+}
+
+void OVERLAY_Set_Time(uint32_t id, uint32_t cycles)
+{
+  if((id - 1) >= overlay_time_count) // Also catches 0
+  {
+    return;
+  }
+
+  overlay_times[id - 1].cycles = cycles;
+}
+
+//------------------------------------------------------------------------------
+// Memory
+//------------------------------------------------------------------------------
+
+uint32_t OVERLAY_Add_Memory(const char * name, uint32_t capacity)
+{
+  if(overlay_memory_count == OVERLAY_MAX_MEMORY)
+  {
+    return 0;
+  }
+
+  OVERLAY_MEMORY_STRUCT * memory = &overlay_memory[overlay_memory_count];
+  memory->name = name;
+  memory->capacity = capacity;
+  memory->high_water = 0;
+
+  overlay_memory_count++;
+
+  return overlay_memory_count;
+}
+
+void OVERLAY_Set_Memory(uint32_t id, uint32_t used)
+{
+  if((id - 1) >= overlay_memory_count) // Also catches 0
+  {
+    return;
+  }
+
+  if(used > overlay_memory[id - 1].high_water)
+  {
+    overlay_memory[id - 1].high_water = used;
+  }
+}
+
+// Check the next chunk of the painted stack for words that have been written
+static void overlay_scan_stack(void)
+{
+  if(!overlay_stack_bottom)
+  {
+    return;
+  }
+
+  uint32_t * scan = overlay_stack_scan;
+  uint32_t * scan_end = scan + (OVERLAY_STACK_SCAN_BYTES / sizeof(uint32_t));
+
+  if(scan_end > overlay_stack_lowest)
+  {
+    scan_end = overlay_stack_lowest;
+  }
+
+  for(; scan < scan_end; scan++)
+  {
+    if(*scan != OVERLAY_STACK_PAINT)
+    {
+      overlay_stack_lowest = scan;
+      break;
+    }
+  }
+
+  // Start over from the bottom after reaching what's known to be used
+  overlay_stack_scan = (scan >= overlay_stack_lowest) ? overlay_stack_bottom : scan;
+}
+
+uint32_t OVERLAY_Get_Stack_High_Water(void)
+{
+  if(!overlay_stack_lowest)
+  {
+    return 0;
+  }
+
+  return OVERLAY_STACK_TOP - (uint32_t)overlay_stack_lowest;
+}
+
+//------------------------------------------------------------------------------
+// Text
+//------------------------------------------------------------------------------
+
+static char * overlay_append(char * out, const char * string, uint32_t max_length)
+{
+  while(*string && max_length)
+  {
+    *out++ = *string++;
+    max_length--;
+  }
+
+  return out;
+}
+
+// Right-aligned in 'width' characters
+static char * overlay_append_uint(char * out, uint32_t value, uint32_t width)
+{
+  uint32_t count = DIGITS_U32_Count(value);
+
+  while(width > count)
+  {
+    *out++ = ' ';
+    width--;
+  }
+
+  out += count;
+  DIGITS_U32_To_Dec_Backward(value, out);
+
+  return out;
+}
+
+// 'value' in hundredths, as at least 'width' characters of "123.45"
+static char * overlay_append_fixed2(char * out, uint32_t value, uint32_t width)
+{
+  out = overlay_append_uint(out, value / 100, (width > 3) ? (width - 3) : 1);
+  *out++ = '.';
+  DIGITS_U32_To_Dec_Fixed(value % 100, 2, out);
+
+  return out + 2;
+}
+
+static char * overlay_pad(char * out, char * line, uint32_t columns)
+{
+  while((uint32_t)(out - line) < columns)
+  {
+    *out++ = ' ';
+  }
+
+  return out;
+}
+
+static void overlay_draw_text(const RAST_TARGET_STRUCT * target, uint32_t x, uint32_t y, const char * text, uint32_t color)
+{
+  if(y + OVERLAY_GLYPH_ROWS > target->height)
+  {
+    return;
+  }
+
+  uint32_t bytes_per_pixel = target->bytes_per_pixel;
+
+  for(; *text && (x + OVERLAY_CHAR_WIDTH <= target->width); text++, x += OVERLAY_CHAR_WIDTH)
+  {
+    uint32_t c = (uint8_t)*text;
+
+    if((c >= 'a') && (c <= 'z'))
+    {
+      c -= 'a' - 'A';
+    }
+    if((c <= OVERLAY_FIRST_CHAR) || (c > OVERLAY_LAST_CHAR))
+    {
+      continue;
+    }
+
+    const uint8_t * glyph = overlay_font[c - OVERLAY_FIRST_CHAR];
+    uint8_t * row = target->base + y * target->pitch + x * bytes_per_pixel;
+
+    for(uint32_t i = 0; i < OVERLAY_GLYPH_ROWS; i++, row += target->pitch)
+    {
+      uint32_t bits = glyph[i];
+      uint8_t * pixel = row;
+
+      for(; bits; bits = (bits << 1) & 0x1F, pixel += bytes_per_pixel)
+      {
+        if(!(bits & 0x10))
+        {
+          continue;
+        }
+
+        if(bytes_per_pixel == 2)
+        {
+          *(uint16_t*)pixel = (uint16_t)color;
+        }
+        else if(bytes_per_pixel == 4)
+        {
+          *(uint32_t*)pixel = color;
+        }
+        else
+        {
+          // VRAM doesn't take 8-bit writes reliably
+          STARTUP_VRAM_Write_Bytes(pixel, color, 3);
+        }
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Drawing
+//------------------------------------------------------------------------------
+
+// Halves so the conversion fits in a signed int, since there's no libgcc for
+// unsigned conversions
+static float overlay_u32_to_float(uint32_t value)
+{
+  return (float)(int32_t)(value >> 1) * 2.0f + (float)(int32_t)(value & 1);
+}
+
+static uint32_t overlay_float_to_u32(float value)
+{
+  return (value <= 0.0f) ? 0 : (uint32_t)(int32_t)(value + 0.5f);
+}
+
+typedef struct {
+  const RAST_TARGET_STRUCT * target;
+  uint32_t y;
+  uint32_t white;
+  uint32_t gray;
+  uint32_t green;
+  uint32_t yellow;
+  uint32_t red;
+} OVERLAY_DRAW_STRUCT;
+
+// One line of text plus a bar showing 'ratio' (1.0f = full)
+static void overlay_draw_line(OVERLAY_DRAW_STRUCT * draw, const char * text, float ratio)
+{
+  const RAST_TARGET_STRUCT * target = draw->target;
+  int32_t bar_x = (int32_t)(overlay_x + OVERLAY_TEXT_COLUMNS * OVERLAY_CHAR_WIDTH);
+  int32_t bar_y = (int32_t)(draw->y + 1);
+
+  overlay_draw_text(target, overlay_x, draw->y, text, draw->white);
+
+  uint32_t color = draw->green;
+  if(ratio > OVERLAY_OVER_RATIO)
+  {
+    color = draw->red;
+    ratio = 1.0f;
+  }
+  else if(ratio > OVERLAY_WARN_RATIO)
+  {
+    color = draw->yellow;
+  }
+
+  int32_t fill = (int32_t)overlay_float_to_u32(ratio * (float)OVERLAY_BAR_WIDTH);
+
+  RAST_Fill_Rect(target, bar_x, bar_y, fill, OVERLAY_BAR_HEIGHT, color);
+  RAST_Fill_Rect(target, bar_x + fill, bar_y, OVERLAY_BAR_WIDTH - fill, OVERLAY_BAR_HEIGHT, draw->gray);
+
+  draw->y += OVERLAY_LINE_HEIGHT;
+}
+
+// "NAME     12.34MS  74.00%"
+static void overlay_draw_time(OVERLAY_DRAW_STRUCT * draw, const char * name, uint32_t cycles, float budget)
+{
+  char line[OVERLAY_LINE_BYTES];
+  char * out = line;
+  float ratio = overlay_u32_to_float(cycles) / budget;
+
+  out = overlay_append(out, name, OVERLAY_NAME_COLUMNS);
+  out = overlay_pad(out, line, OVERLAY_NAME_COLUMNS);
+  out = overlay_append_fixed2(out, overlay_float_to_u32(overlay_u32_to_float(cycles) * (1.0f / (float)OVERLAY_CYCLES_PER_10US)), 6);
+  out = overlay_append(out, "MS ", 3);
+  out = overlay_append_fixed2(out, overlay_float_to_u32(ratio * 10000.0f), 6);
+  *out++ = '%';
+  *out = '\0';
+
+  overlay_draw_line(draw, line, ratio);
+}
+
+// "NAME      12K/64K"
+static void overlay_draw_memory(OVERLAY_DRAW_STRUCT * draw, const char * name, uint32_t used, uint32_t capacity)
+{
+  char line[OVERLAY_LINE_BYTES];
+  char * out = line;
+  float ratio = capacity ? (overlay_u32_to_float(used) / overlay_u32_to_float(capacity)) : 0.0f;
+
+  out = overlay_append(out, name, OVERLAY_NAME_COLUMNS);
+  out = overlay_pad(out, line, OVERLAY_NAME_COLUMNS);
+  out = overlay_append_uint(out, (used + 1023) >> 10, 4);
+  out = overlay_append(out, "K/", 2);
+  out = overlay_append_uint(out, capacity >> 10, 1);
+  *out++ = 'K';
+  *out = '\0';
+
+  overlay_draw_line(draw, line, ratio);
+}
+
+void OVERLAY_Draw(void * framebuffer)
+{
+  uint32_t start = *(volatile uint32_t*)PMCTR1L_REG;
+
+  RAST_TARGET_STRUCT target;
+  RAST_Init_Target_Video(&target, framebuffer);
+
+  OVERLAY_DRAW_STRUCT draw;
+  draw.target = &target;
+  draw.y = overlay_y;
+  draw.white = RAST_Color(&target, 255, 255, 255);
+  draw.gray = RAST_Color(&target, 64, 64, 64);
+  draw.green = RAST_Color(&target, 0, 224, 0);
+  draw.yellow = RAST_Color(&target, 255, 224, 0);
+  draw.red = RAST_Color(&target, 255, 32, 32);
+
+  uint32_t refresh_rate = STARTUP_video_params.video_refresh_rate ? STARTUP_video_params.video_refresh_rate : 60;
+  float budget = (float)PMCR_SH4_CPU_FREQUENCY / (float)(int32_t)refresh_rate;
+
+  overlay_draw_time(&draw, "FRAME", overlay_frame_cycles, budget);
+  overlay_draw_time(&draw, "CPU", overlay_cpu_cycles, budget);
+  overlay_draw_time(&draw, "OVL", overlay_draw_cycles, budget);
+
+  for(uint32_t i = 0; i < overlay_time_count; i++)
+  {
+    overlay_draw_time(&draw, overlay_times[i].name, overlay_times[i].cycles, budget);
+  }
+
+  overlay_scan_stack();
+  if(overlay_stack_bottom)
+  {
+    overlay_draw_memory(&draw, "STACK", OVERLAY_Get_Stack_High_Water(), OVERLAY_STACK_TOP - (uint32_t)overlay_stack_bottom);
+  }
+
+  for(uint32_t i = 0; i < overlay_memory_count; i++)
+  {
+    overlay_draw_memory(&draw, overlay_memory[i].name, overlay_memory[i].high_water, overlay_memory[i].capacity);
+  }
+
+  overlay_draw_cycles = *(volatile uint32_t*)PMCTR1L_REG - start;
+}
@@ -0,0 +1,110 @@
+// ---- overlay.h - Performance Overlay Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module draws a small performance dashboard straight into the
+// framebuffer: frame and CPU time against the frame budget, performance zones,
+// and memory high-water marks, as text and bars. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+#ifndef __OVERLAY_H_
+#define __OVERLAY_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires rasterizer.h (for bars and colors), perfctr.h, digits.h, and
+//  startup_support.h. Nothing here needs dcload or perfzone.h.
+// - Times come from performance counter 1, which OVERLAY_Init() starts in
+//  elapsed time mode (PMCR_COUNT_CPU_CYCLES) unless it's already running, same
+//  as perfzone.h.
+// - Extra time lines, e.g. for performance zones, are added with
+//  OVERLAY_Add_Time() and given a cycle count each frame with
+//  OVERLAY_Set_Time(). To show the zones from perfzone.h, add a line for each
+//  zone and then, once per frame after PERF_Frame_End():
+//
+//    for(uint32_t zone = 1; zone <= PERF_Get_Zone_Count(); zone++)
+//    {
+//      OVERLAY_Set_Time(zone_lines[zone - 1], PERF_Get_Zone_Stats(zone)->frame_cycles);
+//    }
+//
+// - Call OVERLAY_Frame_Start() at the start of each frame (right after the
+//  vblank wait or flip) and OVERLAY_Work_Done() once the frame's CPU work is
+//  done, just before waiting for vblank. CPU time is the time between the two,
+//  and the budget is one frame at STARTUP_video_params.video_refresh_rate.
+// - OVERLAY_Draw() draws last frame's numbers into a framebuffer in whatever
+//  format STARTUP_video_params says, with a built-in 5x7 font (uppercase,
+//  digits, and punctuation; lowercase is drawn as uppercase). It times itself,
+//  and that shows up as the OVL line, so the overlay's own cost is always on
+//  screen. Text is drawn straight into the framebuffer with no background, and
+//  only the bars are filled.
+// - Bars are green up to 75% of their budget, yellow up to 100%, and red over.
+// - Memory lines show a high-water mark against a capacity. The first line is
+//  the stack, measured by painting OVERLAY_STACK_WATCH_BYTES below the stack
+//  pointer at OVERLAY_Init() and checking how much of the paint is left. Add
+//  more with OVERLAY_Add_Memory() and keep them up to date with
+//  OVERLAY_Set_Memory().
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Top of the stack, as set by startup.S
+#define OVERLAY_STACK_TOP 0x8d000000
+
+// How far below the stack pointer at OVERLAY_Init() to watch for stack use
+#define OVERLAY_STACK_WATCH_BYTES 65536
+
+// Max extra time lines and extra memory lines
+#define OVERLAY_MAX_TIMES 8
+#define OVERLAY_MAX_MEMORY 4
+
+// Glyph cell size in pixels, and bar size
+#define OVERLAY_CHAR_WIDTH 6
+#define OVERLAY_LINE_HEIGHT 9
+#define OVERLAY_BAR_WIDTH 96
+#define OVERLAY_BAR_HEIGHT 5
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set where the overlay's top-left corner goes, paint the stack, and start
+// counter 1 if needed. Call it from as close to the top of the program as
+// possible, so that the stack pointer is near the top of the stack.
+void OVERLAY_Init(uint32_t x, uint32_t y);
+
+// Frame timing (see notes)
+void OVERLAY_Frame_Start(void);
+void OVERLAY_Work_Done(void);
+
+// Add a time line with a name (a string that stays around). Returns its ID, or 0
+// if there are already OVERLAY_MAX_TIMES.
+uint32_t OVERLAY_Add_Time(const char * name);
+
+// Set the cycle count a time line shows, normally once per frame
+void OVERLAY_Set_Time(uint32_t id, uint32_t cycles);
+
+// Add a memory line with a name (a string that stays around) and a capacity in
+// bytes. Returns its ID, or 0 if there are already OVERLAY_MAX_MEMORY.
+uint32_t OVERLAY_Add_Memory(const char * name, uint32_t capacity);
+
+// Report how many bytes a memory line is using now. The overlay keeps the
+// highest value.
+void OVERLAY_Set_Memory(uint32_t id, uint32_t used);
+
+// Highest stack use seen so far, in bytes. It's updated by OVERLAY_Draw().
+uint32_t OVERLAY_Get_Stack_High_Water(void);
+
+// Draw the overlay into 'framebuffer', which is a framebuffer of the current
+// video mode (e.g. from STARTUP_Get_Back_Buffer()). Pass NULL for the default
+// framebuffer at 0xa5000000.
+void OVERLAY_Draw(void * framebuffer);
+
+#endif /* __OVERLAY_H_ */
@@ -0,0 +1,198 @@
+// ---- perfcal.c - Performance Counter Calibration Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module measures how fast performance counter 1 really counts on this
+// particular unit and converts counts to nanoseconds, microseconds, and
+// milliseconds with integer multiplies and shifts. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+// See perfcal.h for usage notes.
+#include "perfcal.h"
+#include "perfctr.h"
+
+// Conversions are counts * multiplier / 2^shift. The shifts are picked so that
+// the multipliers are as big as they can be while still fitting in 32 bits at
+// PCAL_MIN_RATE, e.g. 2^29 * 10^9 / 150MHz is just under 2^32.
+#define PCAL_NS_SHIFT 29
+#define PCAL_US_SHIFT 39
+#define PCAL_MS_SHIFT 49
+
+#define PCAL_NS_NUMERATOR (1000000000ULL << PCAL_NS_SHIFT)
+#define PCAL_US_NUMERATOR (1000000ULL << PCAL_US_SHIFT)
+#define PCAL_MS_NUMERATOR (1000ULL << PCAL_MS_SHIFT)
+
+// Counts per bus cycle in each counter 1 clock type
+#define PCAL_CPU_CYCLES_PER_BUS_CYCLE 2
+#define PCAL_RATIO_COUNTS_PER_BUS_CYCLE 24
+
+static uint32_t pcal_rate = PMCR_SH4_CPU_FREQUENCY;
+static uint32_t pcal_counts_per_bus_cycle = PCAL_CPU_CYCLES_PER_BUS_CYCLE;
+
+static uint32_t pcal_ns_multiplier = (uint32_t)(PCAL_NS_NUMERATOR / PMCR_SH4_CPU_FREQUENCY);
+static uint32_t pcal_us_multiplier = (uint32_t)(PCAL_US_NUMERATOR / PMCR_SH4_CPU_FREQUENCY);
+static uint32_t pcal_ms_multiplier = (uint32_t)(PCAL_MS_NUMERATOR / PMCR_SH4_CPU_FREQUENCY);
+
+//------------------------------------------------------------------------------
+// Calibration
+//------------------------------------------------------------------------------
+
+// 64-bit by 32-bit division one bit at a time, since there's no libgcc for
+// __udivdi3. It only runs when the rate changes.
+static uint64_t pcal_divide(uint64_t numerator, uint32_t divisor)
+{
+  uint64_t quotient = 0;
+  uint64_t remainder = 0;
+
+  for(uint32_t bit = 64; bit; bit--)
+  {
+    remainder = (remainder << 1) | (numerator >> 63);
+    numerator <<= 1;
+    quotient <<= 1;
+
+    if(remainder >= divisor)
+    {
+      remainder -= divisor;
+      quotient |= 1;
+    }
+  }
+
+  return quotient;
+}
+
+uint32_t PCAL_Set_Rate(uint32_t counts_per_second)
+{
+  if((counts_per_second < PCAL_MIN_RATE) || (counts_per_second > PCAL_MAX_RATE))
+  {
+    return 0;
+  }
+
+  pcal_rate = counts_per_second;
+  pcal_ns_multiplier = (uint32_t)pcal_divide(PCAL_NS_NUMERATOR, counts_per_second);
+  pcal_us_multiplier = (uint32_t)pcal_divide(PCAL_US_NUMERATOR, counts_per_second);
+  pcal_ms_multiplier = (uint32_t)pcal_divide(PCAL_MS_NUMERATOR, counts_per_second);
+
+  return 1;
+}
+
+// Wait for the RTC's seconds to change and get counter 1 right after. Returns 0
+// if it doesn't change within 'timeout' counts.
+static uint32_t pcal_wait_for_tick(uint64_t timeout, uint64_t * counts)
+{
+  uint32_t seconds = *(volatile uint32_t*)PCAL_AICA_RTC_LOW & 0xffff;
+  uint64_t start = PMCR_Read(1);
+  uint64_t now;
+
+  do
+  {
+    now = PMCR_Read(1);
+
+    if((*(volatile uint32_t*)PCAL_AICA_RTC_LOW & 0xffff) != seconds)
+    {
+      *counts = now;
+      return 1;
+    }
+  } while(PMCR_Delta(start, now) < timeout);
+
+  return 0;
+}
+
+uint32_t PCAL_Calibrate(uint32_t seconds)
+{
+  if(!seconds)
+  {
+    seconds = PCAL_DEFAULT_SECONDS;
+  }
+
+  // Does nothing if it's already running
+  PMCR_Init(1, PMCR_ELAPSED_TIME_MODE, PMCR_COUNT_CPU_CYCLES);
+
+  uint32_t counts_per_bus_cycle = (PMCR_Get_Config(1) & PMCR_CLOCK_TYPE) ? PCAL_RATIO_COUNTS_PER_BUS_CYCLE : PCAL_CPU_CYCLES_PER_BUS_CYCLE;
+
+  // Two seconds at the nominal rate is plenty to see the RTC tick once
+  uint64_t timeout = (uint64_t)PMCR_SH4_BUS_FREQUENCY * counts_per_bus_cycle * 2;
+
+  uint64_t start;
+  uint64_t end;
+
+  // The first tick lines things up with the start of an RTC second
+  if(!pcal_wait_for_tick(timeout, &start))
+  {
+    return 0;
+  }
+
+  end = start;
+  for(uint32_t i = 0; i < seconds; i++)
+  {
+    if(!pcal_wait_for_tick(timeout, &end))
+    {
+      return 0;
+    }
+  }
+
+  uint32_t rate = (uint32_t)pcal_divide(PMCR_Delta(start, end) + (seconds >> 1), seconds);
+
+  if(!PCAL_Set_Rate(rate))
+  {
+    return 0;
+  }
+
+  pcal_counts_per_bus_cycle = counts_per_bus_cycle;
+
+  return rate;
+}
+
+uint32_t PCAL_Get_Rate(void)
+{
+  return pcal_rate;
+}
+
+uint32_t PCAL_Get_Bus_Frequency(void)
+{
+  if(pcal_counts_per_bus_cycle == PCAL_RATIO_COUNTS_PER_BUS_CYCLE)
+  {
+    return (pcal_rate + PCAL_RATIO_COUNTS_PER_BUS_CYCLE / 2) / PCAL_RATIO_COUNTS_PER_BUS_CYCLE;
+  }
+
+  return (pcal_rate + PCAL_CPU_CYCLES_PER_BUS_CYCLE / 2) / PCAL_CPU_CYCLES_PER_BUS_CYCLE;
+}
+
+//------------------------------------------------------------------------------
+// Conversions
+//------------------------------------------------------------------------------
+
+// Scale counts by 'multiplier' / 2^'shift' with two 32x32->64-bit multiplies,
+// keeping all 96 bits of the product. Always inlined so that the shifts are
+// constant.
+static inline __attribute__((always_inline)) uint64_t pcal_scale(uint64_t counts, uint32_t multiplier, uint32_t shift)
+{
+  uint64_t product_high = (uint64_t)(uint32_t)(counts >> 32) * multiplier;
+  uint64_t product_low = (uint64_t)(uint32_t)counts * multiplier;
+
+  if(shift < 32)
+  {
+    return (product_high << (32 - shift)) + (product_low >> shift);
+  }
+
+  return (product_high + (product_low >> 32)) >> (shift - 32);
+}
+
+uint64_t PCAL_Counts_To_Nanoseconds(uint64_t counts)
+{
+  return pcal_scale(counts, pcal_ns_multiplier, PCAL_NS_SHIFT);
+}
+
+uint64_t PCAL_Counts_To_Microseconds(uint64_t counts)
+{
+  return pcal_scale(counts, pcal_us_multiplier, PCAL_US_SHIFT);
+}
+
+uint64_t PCAL_Counts_To_Milliseconds(uint64_t counts)
+{
+  return pcal_scale(counts, pcal_ms_multiplier, PCAL_MS_SHIFT);
+}
@@ -0,0 +1,90 @@
+// ---- perfcal.h - Performance Counter Calibration Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module measures how fast performance counter 1 really counts on this
+// particular unit and converts counts to nanoseconds, microseconds, and
+// milliseconds with integer multiplies and shifts. It is hereby released into
+// the public domain in the hope that it may prove useful.
+//
+
+#ifndef __PERFCAL_H_
+#define __PERFCAL_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires perfctr.h.
+// - The bus clock varies a little from unit to unit (see PMCR_CLOCK_TYPE in
+//  perfctr.h), so converting counts with PMCR_SH4_CPU_FREQUENCY is off by up to
+//  a few tens of parts per million. That's nothing for one frame, but it adds
+//  up to tens of milliseconds over an hour. PCAL_Calibrate() times a few
+//  seconds of the AICA's RTC, which runs from its own 32.768kHz crystal, and
+//  uses the result for all conversions after that. (The TMU can't be used for
+//  this: it's clocked from the same source as the CPU, so it's off by exactly
+//  as much.)
+// - Calibration measures counter 1 in whatever mode it's in, so the
+//  conversions work for PMCR_COUNT_CPU_CYCLES (about 199.5 million counts per
+//  second) and for PMCR_COUNT_RATIO_CYCLES (24 per bus cycle, about 2394
+//  million per second) alike. It starts counter 1 in elapsed time mode counting
+//  CPU cycles if it isn't already running.
+// - Until PCAL_Calibrate() succeeds, or if it's never called, the conversions
+//  use PMCR_SH4_CPU_FREQUENCY, which matches PMCR_COUNT_CPU_CYCLES.
+// - Each RTC edge is found by polling, so the result is good to around one
+//  part per million per second of calibration. Interrupt handlers that run
+//  right at an edge make it worse, so calibrate before enabling interrupts if
+//  possible.
+// - The conversions take 64-bit counts (e.g. from PMCR_Delta()) and only use
+//  32x32->64-bit multiplies and constant shifts, so they don't need libgcc.
+//  They're accurate to a few parts per billion of the calibrated rate and
+//  round down.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// AICA RTC: seconds as two 16-bit halves in the low bits of two 32-bit words
+#define PCAL_AICA_RTC_HIGH 0xA0710000
+#define PCAL_AICA_RTC_LOW 0xA0710004
+
+// Rates that PCAL_Calibrate() accepts, in counts per second. The lower bound
+// keeps the conversion multipliers within 32 bits.
+#define PCAL_MIN_RATE 150000000
+#define PCAL_MAX_RATE 2500000000U
+
+// Calibration length used by PCAL_Calibrate(0)
+#define PCAL_DEFAULT_SECONDS 2
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Count counter 1 over 'seconds' whole seconds of the AICA RTC (0 for
+// PCAL_DEFAULT_SECONDS), which takes up to one second more than that.
+// Returns the measured counts per second, or 0 if the RTC didn't tick or the
+// rate is out of range, in which case the previous rate stays.
+uint32_t PCAL_Calibrate(uint32_t seconds);
+
+// Use a known rate in counts per second instead of calibrating (e.g. one saved
+// from an earlier PCAL_Calibrate()). Returns 1, or 0 if it's out of range, in
+// which case nothing changes.
+uint32_t PCAL_Set_Rate(uint32_t counts_per_second);
+
+// Counter 1 counts per second currently used for conversions
+uint32_t PCAL_Get_Rate(void);
+
+// The bus clock in Hz that the current rate works out to, for comparing with
+// PMCR_SH4_BUS_FREQUENCY. Only meaningful after PCAL_Calibrate().
+uint32_t PCAL_Get_Bus_Frequency(void);
+
+// Conversions from counter 1 counts
+uint64_t PCAL_Counts_To_Nanoseconds(uint64_t counts);
+uint64_t PCAL_Counts_To_Microseconds(uint64_t counts);
+uint64_t PCAL_Counts_To_Milliseconds(uint64_t counts);
+
+#endif /* __PERFCAL_H_ */
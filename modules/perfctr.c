@@ -1,6 +1,6 @@
 // ---- perfctr.c - SH7750/SH7091 Performance Counter Module Code ----
 //
-// Version 1.0.4
+// Version 1.0.5
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -116,7 +116,7 @@ void PMCR_Restart(unsigned char which, unsigned char mode, unsigned char count_t
 // #define PMCTR2H_REG 0xFF10000C
 // #define PMCTR2L_REG 0xFF100010
 
-// Sorry, can only read one counter at a time!
+// Sorry, can only read one counter at a time! (Use PMCR_Read_Both() for both.)
 // Return value of 0xffffffffffff means invalid 'which'
 unsigned long long int PMCR_Read(unsigned char which)
 {
@@ -177,6 +177,54 @@ unsigned long long int PMCR_Read(unsigned char which)
 	return output_value.output64;
 }
 
+// When both counters need to cover the same window (e.g. cycles and cache
+// misses), reading them one after the other with PMCR_Read() puts a function
+// call and a branch between them. This reads both in one go.
+void PMCR_Read_Both(unsigned long long int * counter1, unsigned long long int * counter2)
+{
+	unsigned int high1, high2, low1, low2, high1_again, high2_again;
+	unsigned int base = PMCTR1H_REG;
+
+	// All four data registers are 4 bytes apart starting at PMCTR1H_REG, so one
+	// base register covers them. The low halves are read back-to-back since
+	// that's where the skew matters, and the high halves are read again after
+	// to catch a carry out of a low half.
+	asm volatile (
+		"mov.l @%[base],%[high1]\n\t" // PMCTR1H
+		"mov.l @(8,%[base]),%[high2]\n\t" // PMCTR2H
+		"mov.l @(4,%[base]),%[low1]\n\t" // PMCTR1L
+		"mov.l @(12,%[base]),%[low2]\n\t" // PMCTR2L
+		"mov.l @%[base],%[high1_again]\n\t" // PMCTR1H
+		"mov.l @(8,%[base]),%[high2_again]\n" // PMCTR2H
+		: [high1] "=&r" (high1), [high2] "=&r" (high2), [low1] "=&r" (low1), [low2] "=&r" (low2),
+		  [high1_again] "=&r" (high1_again), [high2_again] "=&r" (high2_again)
+		: [base] "r" (base)
+		: // no clobbers
+	);
+
+	// If a high half changed, the low half carried out either before or after
+	// it was read. A small low half means it had already wrapped, so it goes
+	// with the new high half.
+	if((high1 != high1_again) && !(low1 & 0x80000000))
+	{
+		high1 = high1_again;
+	}
+	if((high2 != high2_again) && !(low2 & 0x80000000))
+	{
+		high2 = high2_again;
+	}
+
+	*counter1 = ((unsigned long long int)(high1 & 0xffff) << 32) | low1;
+	*counter2 = ((unsigned long long int)(high2 & 0xffff) << 32) | low2;
+}
+
+// The counters are 48 bits with no overflow bit, so do the subtraction mod 2^48.
+// This only needs a 64-bit subtract and an AND, no libgcc helpers.
+unsigned long long int PMCR_Delta(unsigned long long int start, unsigned long long int end)
+{
+	return (end - start) & 0xffffffffffffULL;
+}
+
 // Get a counter's current configuration
 // Can only get the config for one counter at a time.
 // Return value of 0xffff means invalid 'which'
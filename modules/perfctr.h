@@ -1,6 +1,6 @@
 // ---- perfctr.h - SH7750/SH7091 Performance Counter Module Header ----
 //
-// Version 1.0.4
+// Version 1.0.5
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -310,6 +310,17 @@ void PMCR_Restart(unsigned char which, unsigned char mode, unsigned char count_t
 // Return value of 0xffffffffffff means invalid 'which'
 unsigned long long int PMCR_Read(unsigned char which);
 
+// Read both counters at (almost) the same time
+// The low halves are read back-to-back, so counter 2 is sampled one register
+// load after counter 1, a few cycles at most. Use this instead of two
+// PMCR_Read() calls when comparing two events over the same window.
+void PMCR_Read_Both(unsigned long long int * counter1, unsigned long long int * counter2);
+
+// Get the difference between two readings of a counter
+// There's no overflow bit, so this just wraps at 48 bits. That's right as long
+// as the counter wrapped at most once between the two readings.
+unsigned long long int PMCR_Delta(unsigned long long int start, unsigned long long int end);
+
 // Get a counter's current configuration
 // Return value of 0xffff means invalid 'which'
 unsigned short PMCR_Get_Config(unsigned char which);
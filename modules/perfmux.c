@@ -0,0 +1,277 @@
+// ---- perfmux.c - Performance Counter Multiplexing Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module rotates the two performance counters through a list of events
+// over repeated runs of the same code, scales the counts up to estimates for
+// every run, and reports derived metrics like IPC and stall percentages. It is
+// hereby released into the public domain in the hope that it may prove useful.
+//
+
+// See perfmux.h for usage notes.
+#include "perfmux.h"
+#include "print.h"
+
+// Highest event mode (PMCR_PIPELINE_FREEZE_BY_FPU_MODE)
+#define PMUX_LAST_MODE 0x29
+
+typedef struct {
+  uint8_t mode;
+  // Intervals this event was counted for, and what it counted over them
+  uint32_t intervals;
+  uint64_t count;
+} PMUX_EVENT_STRUCT;
+
+static PMUX_EVENT_STRUCT pmux_events[PMUX_MAX_EVENTS];
+static uint32_t pmux_event_count = 0;
+
+// Index of the event on counter 1; counter 2 has the one after it
+static uint32_t pmux_position = 0;
+static uint32_t pmux_intervals = 0;
+
+// Counter values at PMUX_Begin()
+static uint32_t pmux_start1 = 0;
+static uint32_t pmux_start2 = 0;
+
+static const char * const pmux_event_names[PMUX_LAST_MODE + 1] = {
+  [PMCR_OPERAND_READ_ACCESS_MODE] = "operand reads",
+  [PMCR_OPERAND_WRITE_ACCESS_MODE] = "operand writes",
+  [PMCR_UTLB_MISS_MODE] = "UTLB misses",
+  [PMCR_OPERAND_CACHE_READ_MISS_MODE] = "dcache read misses",
+  [PMCR_OPERAND_CACHE_WRITE_MISS_MODE] = "dcache write misses",
+  [PMCR_INSTRUCTION_FETCH_MODE] = "instruction fetches",
+  [PMCR_INSTRUCTION_TLB_MISS_MODE] = "ITLB misses",
+  [PMCR_INSTRUCTION_CACHE_MISS_MODE] = "icache misses",
+  [PMCR_ALL_OPERAND_ACCESS_MODE] = "all operand accesses",
+  [PMCR_ALL_INSTRUCTION_FETCH_MODE] = "all instruction fetches",
+  [PMCR_ON_CHIP_RAM_OPERAND_ACCESS_MODE] = "OCRAM accesses",
+  [PMCR_ON_CHIP_IO_ACCESS_MODE] = "on-chip I/O accesses",
+  [PMCR_OPERAND_ACCESS_MODE] = "operand accesses",
+  [PMCR_OPERAND_CACHE_MISS_MODE] = "dcache misses",
+  [PMCR_BRANCH_ISSUED_MODE] = "branches issued",
+  [PMCR_BRANCH_TAKEN_MODE] = "branches taken",
+  [PMCR_SUBROUTINE_ISSUED_MODE] = "calls issued",
+  [PMCR_INSTRUCTION_ISSUED_MODE] = "instructions issued",
+  [PMCR_PARALLEL_INSTRUCTION_ISSUED_MODE] = "dual issues",
+  [PMCR_FPU_INSTRUCTION_ISSUED_MODE] = "FPU instructions",
+  [PMCR_INTERRUPT_COUNTER_MODE] = "interrupts",
+  [PMCR_NMI_COUNTER_MODE] = "NMIs",
+  [PMCR_TRAPA_INSTRUCTION_COUNTER_MODE] = "TRAPAs",
+  [PMCR_UBC_A_MATCH_MODE] = "UBC A matches",
+  [PMCR_UBC_B_MATCH_MODE] = "UBC B matches",
+  [PMCR_INSTRUCTION_CACHE_FILL_MODE] = "icache fill cycles",
+  [PMCR_OPERAND_CACHE_FILL_MODE] = "dcache fill cycles",
+  [PMCR_ELAPSED_TIME_MODE] = "cycles",
+  [PMCR_PIPELINE_FREEZE_BY_ICACHE_MISS_MODE] = "icache miss freeze",
+  [PMCR_PIPELINE_FREEZE_BY_DCACHE_MISS_MODE] = "dcache miss freeze",
+  [PMCR_PIPELINE_FREEZE_BY_BRANCH_MODE] = "branch freeze",
+  [PMCR_PIPELINE_FREEZE_BY_CPU_REGISTER_MODE] = "register freeze",
+  [PMCR_PIPELINE_FREEZE_BY_FPU_MODE] = "FPU freeze"
+};
+
+//------------------------------------------------------------------------------
+// Counting
+//------------------------------------------------------------------------------
+
+static inline uint32_t pmux_second_index(void)
+{
+  uint32_t index = pmux_position + 1;
+  return (index == pmux_event_count) ? 0 : index;
+}
+
+uint32_t PMUX_Init(const uint8_t * events, uint32_t event_count)
+{
+  if(event_count > PMUX_MAX_EVENTS)
+  {
+    event_count = PMUX_MAX_EVENTS;
+  }
+
+  pmux_event_count = event_count;
+  for(uint32_t i = 0; i < event_count; i++)
+  {
+    pmux_events[i].mode = events[i];
+  }
+
+  PMUX_Reset();
+  pmux_position = 0;
+
+  if(event_count)
+  {
+    PMCR_Disable(3);
+    PMCR_Init(1, pmux_events[0].mode, PMCR_COUNT_CPU_CYCLES);
+    PMCR_Init(2, pmux_events[pmux_second_index()].mode, PMCR_COUNT_CPU_CYCLES);
+  }
+
+  return event_count;
+}
+
+void PMUX_Reset(void)
+{
+  for(uint32_t i = 0; i < pmux_event_count; i++)
+  {
+    pmux_events[i].intervals = 0;
+    pmux_events[i].count = 0;
+  }
+
+  pmux_intervals = 0;
+}
+
+void PMUX_Begin(void)
+{
+  pmux_start2 = *(volatile uint32_t*)PMCTR2L_REG;
+  pmux_start1 = *(volatile uint32_t*)PMCTR1L_REG;
+}
+
+void PMUX_End(void)
+{
+  uint32_t count1 = *(volatile uint32_t*)PMCTR1L_REG - pmux_start1;
+  uint32_t count2 = *(volatile uint32_t*)PMCTR2L_REG - pmux_start2;
+
+  if(!pmux_event_count)
+  {
+    return;
+  }
+
+  pmux_intervals++;
+
+  PMUX_EVENT_STRUCT * event = &pmux_events[pmux_position];
+  event->intervals++;
+  event->count += count1;
+
+  // With only one event, both counters count it, so only use one
+  uint32_t second = pmux_second_index();
+  if(second != pmux_position)
+  {
+    event = &pmux_events[second];
+    event->intervals++;
+    event->count += count2;
+  }
+
+  // Move on by two. With an odd number of events this also shifts which
+  // events end up paired together.
+  if(pmux_event_count > 2)
+  {
+    pmux_position += 2;
+    if(pmux_position >= pmux_event_count)
+    {
+      pmux_position -= pmux_event_count;
+    }
+
+    PMCR_Restart(1, pmux_events[pmux_position].mode, PMCR_COUNT_CPU_CYCLES);
+    PMCR_Restart(2, pmux_events[pmux_second_index()].mode, PMCR_COUNT_CPU_CYCLES);
+  }
+}
+
+void PMUX_Next(void)
+{
+  PMUX_End();
+  PMUX_Begin();
+}
+
+uint32_t PMUX_Get_Intervals(void)
+{
+  return pmux_intervals;
+}
+
+//------------------------------------------------------------------------------
+// Estimates
+//------------------------------------------------------------------------------
+
+// There's no libgcc for 64-bit or unsigned conversions, so go through halves
+// that fit in a signed int
+static float pmux_u32_to_float(uint32_t value)
+{
+  return (float)(int32_t)(value >> 1) * 2.0f + (float)(int32_t)(value & 1);
+}
+
+static float pmux_u64_to_float(uint64_t value)
+{
+  return pmux_u32_to_float((uint32_t)(value >> 32)) * 4294967296.0f + pmux_u32_to_float((uint32_t)value);
+}
+
+float PMUX_Get_Estimate(uint32_t event_mode)
+{
+  for(uint32_t i = 0; i < pmux_event_count; i++)
+  {
+    if((pmux_events[i].mode == event_mode) && pmux_events[i].intervals)
+    {
+      // Average per interval counted, which is the same as scaling the total up
+      // to all of the intervals and dividing by them
+      return pmux_u64_to_float(pmux_events[i].count) / pmux_u32_to_float(pmux_events[i].intervals);
+    }
+  }
+
+  return -1.0f;
+}
+
+float PMUX_Get_Ratio(uint32_t numerator_mode, uint32_t denominator_mode)
+{
+  float numerator = PMUX_Get_Estimate(numerator_mode);
+  float denominator = PMUX_Get_Estimate(denominator_mode);
+
+  if((numerator < 0.0f) || (denominator <= 0.0f))
+  {
+    return -1.0f;
+  }
+
+  return numerator / denominator;
+}
+
+//------------------------------------------------------------------------------
+// Report
+//------------------------------------------------------------------------------
+
+// 'decimals' is how many digits to print after the decimal point
+static void pmux_print_metric(const char * name, float value, int decimals, const char * units)
+{
+  if(value < 0.0f)
+  {
+    return;
+  }
+
+  printf("  %-28s %.*f%s\n", name, decimals, (double)value, units);
+}
+
+void PMUX_Print_Report(void)
+{
+  printf("%u intervals, per-interval estimates:\n", pmux_intervals);
+
+  for(uint32_t i = 0; i < pmux_event_count; i++)
+  {
+    uint32_t mode = pmux_events[i].mode;
+    const char * name = (mode <= PMUX_LAST_MODE) ? pmux_event_names[mode] : NULL;
+    float estimate = PMUX_Get_Estimate(mode);
+
+    if(!name)
+    {
+      name = "unknown event";
+    }
+
+    if(estimate < 0.0f)
+    {
+      printf("  %-28s (not counted yet)\n", name);
+    }
+    else
+    {
+      printf("  %-28s %.1f (%u intervals)\n", name, (double)estimate, pmux_events[i].intervals);
+    }
+  }
+
+  printf("Derived:\n");
+
+  pmux_print_metric("IPC", PMUX_Get_Ratio(PMCR_INSTRUCTION_ISSUED_MODE, PMCR_ELAPSED_TIME_MODE), 3, "");
+  pmux_print_metric("dual issue rate", PMUX_Get_Ratio(PMCR_PARALLEL_INSTRUCTION_ISSUED_MODE, PMCR_INSTRUCTION_ISSUED_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("dcache MPKI", PMUX_Get_Ratio(PMCR_OPERAND_CACHE_MISS_MODE, PMCR_INSTRUCTION_ISSUED_MODE) * 1000.0f, 3, "");
+  pmux_print_metric("icache MPKI", PMUX_Get_Ratio(PMCR_INSTRUCTION_CACHE_MISS_MODE, PMCR_INSTRUCTION_ISSUED_MODE) * 1000.0f, 3, "");
+  pmux_print_metric("UTLB MPKI", PMUX_Get_Ratio(PMCR_UTLB_MISS_MODE, PMCR_INSTRUCTION_ISSUED_MODE) * 1000.0f, 3, "");
+  pmux_print_metric("branches taken", PMUX_Get_Ratio(PMCR_BRANCH_TAKEN_MODE, PMCR_BRANCH_ISSUED_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("frozen by icache misses", PMUX_Get_Ratio(PMCR_PIPELINE_FREEZE_BY_ICACHE_MISS_MODE, PMCR_ELAPSED_TIME_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("frozen by dcache misses", PMUX_Get_Ratio(PMCR_PIPELINE_FREEZE_BY_DCACHE_MISS_MODE, PMCR_ELAPSED_TIME_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("frozen by branches", PMUX_Get_Ratio(PMCR_PIPELINE_FREEZE_BY_BRANCH_MODE, PMCR_ELAPSED_TIME_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("frozen by register conflicts", PMUX_Get_Ratio(PMCR_PIPELINE_FREEZE_BY_CPU_REGISTER_MODE, PMCR_ELAPSED_TIME_MODE) * 100.0f, 1, "%");
+  pmux_print_metric("frozen by the FPU", PMUX_Get_Ratio(PMCR_PIPELINE_FREEZE_BY_FPU_MODE, PMCR_ELAPSED_TIME_MODE) * 100.0f, 1, "%");
+}
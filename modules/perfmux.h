@@ -0,0 +1,105 @@
+// ---- perfmux.h - Performance Counter Multiplexing Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module rotates the two performance counters through a list of events
+// over repeated runs of the same code, scales the counts up to estimates for
+// every run, and reports derived metrics like IPC and stall percentages. It is
+// hereby released into the public domain in the hope that it may prove useful.
+//
+
+#ifndef __PERFMUX_H_
+#define __PERFMUX_H_
+
+#include <stdint.h>
+#include "perfctr.h"
+
+// Notes:
+// - Requires perfctr.h, and print.h for PMUX_Print_Report(). Takes over both
+//  performance counters, so it can't be used at the same time as perfzone.h or
+//  anything else that sets them up.
+// - Put PMUX_Begin() and PMUX_End() around code that runs over and over, like
+//  one frame or one iteration of a benchmark loop. Each Begin/End pair is one
+//  interval, and each interval counts two events from the list. PMUX_End()
+//  then switches the counters to the next two, so after enough intervals every
+//  event has been counted for some of them. For whole frames, PMUX_Next() once
+//  per frame does both.
+// - An event's estimate is what it counted, scaled up by the total number of
+//  intervals over the number it was counted for. This is only as good as the
+//  intervals are alike: rotating through N events needs about N intervals to
+//  see each one twice (N / 2 if N is even), so the more events, the longer the
+//  code should behave the same.
+// - Derived metrics need both of their events in the list. Include
+//  PMCR_ELAPSED_TIME_MODE for anything "per cycle" and
+//  PMCR_INSTRUCTION_ISSUED_MODE for anything "per instruction". Both counters
+//  count in PMCR_COUNT_CPU_CYCLES mode.
+// - Counts are read from the low 32 bits of each counter, so an interval can be
+//  up to about 21 seconds long.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Max number of events to rotate through
+#define PMUX_MAX_EVENTS 16
+
+// A good default list: IPC, cache misses, and where the pipeline stalls
+#define PMUX_DEFAULT_EVENTS { \
+  PMCR_ELAPSED_TIME_MODE, \
+  PMCR_INSTRUCTION_ISSUED_MODE, \
+  PMCR_OPERAND_CACHE_MISS_MODE, \
+  PMCR_INSTRUCTION_CACHE_MISS_MODE, \
+  PMCR_PIPELINE_FREEZE_BY_DCACHE_MISS_MODE, \
+  PMCR_PIPELINE_FREEZE_BY_ICACHE_MISS_MODE, \
+  PMCR_PIPELINE_FREEZE_BY_BRANCH_MODE, \
+  PMCR_PIPELINE_FREEZE_BY_CPU_REGISTER_MODE, \
+  PMCR_PIPELINE_FREEZE_BY_FPU_MODE, \
+  PMCR_BRANCH_ISSUED_MODE, \
+  PMCR_BRANCH_TAKEN_MODE, \
+  PMCR_PARALLEL_INSTRUCTION_ISSUED_MODE \
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set up rotation through 'event_count' PMCR_*_MODE events (1 to
+// PMUX_MAX_EVENTS; any more are ignored) and clear all counts. Returns the
+// number of events used.
+uint32_t PMUX_Init(const uint8_t * events, uint32_t event_count);
+
+// Start and end an interval. PMUX_End() moves on to the next pair of events.
+void PMUX_Begin(void);
+void PMUX_End(void);
+
+// End the current interval and start the next one
+void PMUX_Next(void);
+
+// Clear all counts, keeping the event list
+void PMUX_Reset(void);
+
+// Intervals measured since the counts were cleared
+uint32_t PMUX_Get_Intervals(void);
+
+// Estimated count of an event per interval, averaged over all of the
+// intervals. Returns -1.0f if the event isn't in the list or hasn't been
+// counted yet.
+float PMUX_Get_Estimate(uint32_t event_mode);
+
+// Estimate of one event over another, e.g.
+// PMUX_Get_Ratio(PMCR_INSTRUCTION_ISSUED_MODE, PMCR_ELAPSED_TIME_MODE) is IPC.
+// Returns -1.0f if either isn't available or the denominator is 0.
+float PMUX_Get_Ratio(uint32_t numerator_mode, uint32_t denominator_mode);
+
+// Print the per-interval estimate of each event, then whichever of these can
+// be worked out from the events in the list: IPC, parallel issue rate, misses
+// per 1000 instructions, branch taken rate, and percent of cycles frozen by
+// each cause
+void PMUX_Print_Report(void);
+
+#endif /* __PERFMUX_H_ */
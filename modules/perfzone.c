@@ -0,0 +1,257 @@
+// ---- perfzone.c - Performance Counter Zone Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module wraps the performance counters in scoped instrumentation macros
+// that add up cycles and a second event per named zone, with per-frame
+// summaries. It is hereby released into the public domain in the hope that it
+// may prove useful.
+//
+
+// See perfzone.h for usage notes.
+#include <stddef.h>
+#include "perfzone.h"
+#include "print.h"
+
+// Number of empty scopes timed to find the cost of a scope
+#define PERF_CALIBRATION_RUNS 16
+
+typedef struct {
+  PERF_ZONE_STATS_STRUCT stats;
+  // This frame so far
+  uint32_t calls;
+  uint32_t cycles;
+  uint32_t events;
+} PERF_ZONE_STRUCT;
+
+static PERF_ZONE_STRUCT perf_zones[PERF_MAX_ZONES];
+static uint32_t perf_zone_count = 0;
+
+// What an empty scope measures, taken back out of every measurement
+static uint32_t perf_overhead_cycles = 0;
+static uint32_t perf_overhead_events = 0;
+
+static uint32_t perf_frame_start = 0;
+static uint32_t perf_frame_cycles = 0;
+
+//------------------------------------------------------------------------------
+// Zones
+//------------------------------------------------------------------------------
+
+static uint32_t perf_names_match(const char * a, const char * b)
+{
+  if(a == b)
+  {
+    return 1;
+  }
+
+  while(*a && (*a == *b))
+  {
+    a++;
+    b++;
+  }
+
+  return *a == *b;
+}
+
+uint32_t PERF_Zone(const char * name)
+{
+  for(uint32_t i = 0; i < perf_zone_count; i++)
+  {
+    if(perf_names_match(perf_zones[i].stats.name, name))
+    {
+      return i + 1;
+    }
+  }
+
+  if(perf_zone_count == PERF_MAX_ZONES)
+  {
+    return PERF_NO_ZONE;
+  }
+
+  PERF_ZONE_STRUCT * zone = &perf_zones[perf_zone_count];
+  zone->stats.name = name;
+  zone->stats.frame_calls = 0;
+  zone->stats.frame_cycles = 0;
+  zone->stats.frame_events = 0;
+  zone->stats.max_frame_cycles = 0;
+  zone->stats.total_calls = 0;
+  zone->stats.total_cycles = 0;
+  zone->stats.total_events = 0;
+  zone->calls = 0;
+  zone->cycles = 0;
+  zone->events = 0;
+
+  perf_zone_count++;
+
+  return perf_zone_count;
+}
+
+void PERF_Record(uint32_t zone, uint32_t cycles, uint32_t events)
+{
+  if((zone - 1) >= perf_zone_count) // Also catches 0 and PERF_NO_ZONE
+  {
+    return;
+  }
+
+  cycles = (cycles > perf_overhead_cycles) ? (cycles - perf_overhead_cycles) : 0;
+  events = (events > perf_overhead_events) ? (events - perf_overhead_events) : 0;
+
+  PERF_ZONE_STRUCT * entry = &perf_zones[zone - 1];
+  entry->calls++;
+  entry->cycles += cycles;
+  entry->events += events;
+}
+
+//------------------------------------------------------------------------------
+// Setup
+//------------------------------------------------------------------------------
+
+void PERF_Init(uint32_t event_mode)
+{
+  // Disabling first makes sure both start over from 0 with the right modes
+  PMCR_Disable(3);
+  PMCR_Init(1, PMCR_ELAPSED_TIME_MODE, PMCR_COUNT_CPU_CYCLES);
+  PMCR_Init(2, (unsigned char)event_mode, PMCR_COUNT_CPU_CYCLES);
+
+  // Zones stay, as the macro sites have their IDs
+  PERF_Reset_Stats();
+  perf_overhead_cycles = 0;
+  perf_overhead_events = 0;
+
+  // Time some empty scopes the same way the macros do. The smallest is the
+  // cost of the reads alone; anything bigger got interrupted or missed cache.
+  uint32_t min_cycles = 0xFFFFFFFF;
+  uint32_t min_events = 0xFFFFFFFF;
+  uint32_t zone_cache = PERF_NO_ZONE; // Nothing is recorded
+
+  for(uint32_t i = 0; i < PERF_CALIBRATION_RUNS; i++)
+  {
+    PERF_SCOPE_STRUCT scope = PERF_Begin(&zone_cache, NULL);
+    uint32_t cycles = *(volatile uint32_t*)PMCTR1L_REG;
+    uint32_t events = *(volatile uint32_t*)PMCTR2L_REG;
+
+    cycles -= scope.cycles;
+    events -= scope.events;
+
+    if(cycles < min_cycles)
+    {
+      min_cycles = cycles;
+    }
+    if(events < min_events)
+    {
+      min_events = events;
+    }
+  }
+
+  perf_overhead_cycles = min_cycles;
+  perf_overhead_events = min_events;
+
+  perf_frame_start = *(volatile uint32_t*)PMCTR1L_REG;
+  perf_frame_cycles = 0;
+}
+
+//------------------------------------------------------------------------------
+// Frames and stats
+//------------------------------------------------------------------------------
+
+void PERF_Frame_End(void)
+{
+  uint32_t now = *(volatile uint32_t*)PMCTR1L_REG;
+  perf_frame_cycles = now - perf_frame_start;
+  perf_frame_start = now;
+
+  for(uint32_t i = 0; i < perf_zone_count; i++)
+  {
+    PERF_ZONE_STRUCT * zone = &perf_zones[i];
+
+    zone->stats.frame_calls = zone->calls;
+    zone->stats.frame_cycles = zone->cycles;
+    zone->stats.frame_events = zone->events;
+
+    if(zone->cycles > zone->stats.max_frame_cycles)
+    {
+      zone->stats.max_frame_cycles = zone->cycles;
+    }
+
+    zone->stats.total_calls += zone->calls;
+    zone->stats.total_cycles += zone->cycles;
+    zone->stats.total_events += zone->events;
+
+    zone->calls = 0;
+    zone->cycles = 0;
+    zone->events = 0;
+  }
+}
+
+uint32_t PERF_Get_Frame_Cycles(void)
+{
+  return perf_frame_cycles;
+}
+
+const PERF_ZONE_STATS_STRUCT * PERF_Get_Zone_Stats(uint32_t zone)
+{
+  if((zone - 1) >= perf_zone_count)
+  {
+    return NULL;
+  }
+
+  return &perf_zones[zone - 1].stats;
+}
+
+uint32_t PERF_Get_Zone_Count(void)
+{
+  return perf_zone_count;
+}
+
+void PERF_Reset_Stats(void)
+{
+  for(uint32_t i = 0; i < perf_zone_count; i++)
+  {
+    PERF_ZONE_STRUCT * zone = &perf_zones[i];
+
+    zone->calls = 0;
+    zone->cycles = 0;
+    zone->events = 0;
+
+    zone->stats.frame_calls = 0;
+    zone->stats.frame_cycles = 0;
+    zone->stats.frame_events = 0;
+    zone->stats.max_frame_cycles = 0;
+    zone->stats.total_calls = 0;
+    zone->stats.total_cycles = 0;
+    zone->stats.total_events = 0;
+  }
+}
+
+// Tenths of a percent of 'part' in 'whole', without an integer divide
+static uint32_t perf_permille(uint32_t part, uint32_t whole)
+{
+  if(!whole)
+  {
+    return 0;
+  }
+
+  // Halved so that they fit in a signed int for the float conversion
+  float ratio = (float)(int32_t)(part >> 1) / (float)(int32_t)((whole >> 1) | 1);
+  return (uint32_t)(int32_t)(ratio * 1000.0f + 0.5f);
+}
+
+void PERF_Print_Summary(void)
+{
+  printf("%-24s %6s %10s %6s %10s %10s\n", "zone", "calls", "cycles", "frame%", "events", "max cycles");
+
+  for(uint32_t i = 0; i < perf_zone_count; i++)
+  {
+    const PERF_ZONE_STATS_STRUCT * stats = &perf_zones[i].stats;
+    uint32_t permille = perf_permille(stats->frame_cycles, perf_frame_cycles);
+
+    printf("%-24s %6u %10u %4u.%u %10u %10u\n", stats->name, stats->frame_calls, stats->frame_cycles, permille / 10, permille % 10, stats->frame_events, stats->max_frame_cycles);
+  }
+
+  printf("frame: %u cycles\n", perf_frame_cycles);
+}
@@ -0,0 +1,186 @@
+// ---- perfzone.h - Performance Counter Zone Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module wraps the performance counters in scoped instrumentation macros
+// that add up cycles and a second event per named zone, with per-frame
+// summaries. It is hereby released into the public domain in the hope that it
+// may prove useful.
+//
+
+#ifndef __PERFZONE_H_
+#define __PERFZONE_H_
+
+#include <stdint.h>
+#include "perfctr.h"
+
+// Notes:
+// - Requires perfctr.h, and print.h for PERF_Print_Summary().
+// - PERF_Init() takes over both performance counters: counter 1 counts CPU
+//  cycles (elapsed time mode) and counter 2 counts whichever PMCR_*_MODE event
+//  is given, e.g. PMCR_OPERAND_CACHE_MISS_MODE.
+// - Instrument code with the macros below. With PERF_ENABLED set to 0 they all
+//  compile to nothing, so instrumentation can stay in the code for good:
+//
+//   void draw_world(void)
+//   {
+//     PERF_SCOPE("draw_world"); // Measures until draw_world() returns
+//     ...
+//   }
+//
+//   PERF_BEGIN(physics, "physics"); // Same, but ends at PERF_END(physics)
+//   ...
+//   PERF_END(physics);
+//
+//   PERF_FRAME_END(); // Once per frame, e.g. right after waiting for vblank
+//   PERF_PRINT_SUMMARY(); // Whenever, e.g. every 60 frames
+//
+// - Each macro site looks up its zone by name once and then keeps the zone's
+//  ID in a static variable, so after the first time, a scope is just two
+//  counter reads going in and two reads and some adds coming out. The cost of
+//  the reads themselves is measured by PERF_Init() and taken back out. Since
+//  those IDs stay around, zones are never removed: calling PERF_Init() again
+//  clears their stats but keeps them. A site that finds the table full keeps
+//  PERF_NO_ZONE instead, so it doesn't look again every time.
+// - Sites with the same name share a zone. Zones nested in other zones count
+//  toward both, so the outer zone's time includes the inner one's.
+// - Only the low 32 bits of each counter are read, which is plenty for one
+//  scope (about 21 seconds of cycles) and keeps scopes cheap.
+// - Time spent in interrupt handlers during a scope counts toward the scope.
+//  Zones shouldn't be used in interrupt handlers and in normal code at the same
+//  time, as the handler could interrupt the normal code while it adds up a
+//  zone.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Set to 0 to compile out all of the PERF_* macros
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+// Max number of distinct zone names
+#define PERF_MAX_ZONES 32
+
+// Zone ID for sites that didn't get a zone because all PERF_MAX_ZONES were
+// taken. Measurements for it are dropped.
+#define PERF_NO_ZONE (PERF_MAX_ZONES + 1)
+
+typedef struct {
+  const char * name;
+  // Last frame
+  uint32_t frame_calls;
+  uint32_t frame_cycles;
+  uint32_t frame_events;
+  // Most cycles in one frame since the stats were reset
+  uint32_t max_frame_cycles;
+  // Everything since the stats were reset
+  uint32_t total_calls;
+  uint64_t total_cycles;
+  uint64_t total_events;
+} PERF_ZONE_STATS_STRUCT;
+
+// Zones in progress. Only used by the macros.
+typedef struct {
+  uint32_t zone;
+  uint32_t cycles;
+  uint32_t events;
+} PERF_SCOPE_STRUCT;
+
+//------------------------------------------------------------------------------
+// Macros
+//------------------------------------------------------------------------------
+
+#if PERF_ENABLED
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+
+// Measure from here to the end of the enclosing block
+#define PERF_SCOPE(name) \
+  static uint32_t PERF_CONCAT(perf_zone_, __LINE__) = 0; \
+  PERF_SCOPE_STRUCT PERF_CONCAT(perf_scope_, __LINE__) __attribute__((cleanup(PERF_End))) = PERF_Begin(&PERF_CONCAT(perf_zone_, __LINE__), name)
+
+// Measure from PERF_BEGIN() to PERF_END() with the same tag (any identifier)
+#define PERF_BEGIN(tag, name) \
+  static uint32_t perf_zone_##tag = 0; \
+  PERF_SCOPE_STRUCT perf_scope_##tag = PERF_Begin(&perf_zone_##tag, name)
+#define PERF_END(tag) PERF_End(&perf_scope_##tag)
+
+#define PERF_FRAME_END() PERF_Frame_End()
+#define PERF_PRINT_SUMMARY() PERF_Print_Summary()
+
+#else
+
+#define PERF_SCOPE(name)
+#define PERF_BEGIN(tag, name)
+#define PERF_END(tag)
+#define PERF_FRAME_END()
+#define PERF_PRINT_SUMMARY()
+
+#endif
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Start both counters (see notes) and clear the stats of all zones
+void PERF_Init(uint32_t event_mode);
+
+// Find or add the zone called 'name' and return its ID, or PERF_NO_ZONE if
+// there are already PERF_MAX_ZONES zones
+uint32_t PERF_Zone(const char * name);
+
+// Add a measurement to a zone. Used by PERF_End().
+void PERF_Record(uint32_t zone, uint32_t cycles, uint32_t events);
+
+// Close out the frame: each zone's running totals become its last-frame stats
+void PERF_Frame_End(void);
+
+// Cycles between the last two calls to PERF_Frame_End()
+uint32_t PERF_Get_Frame_Cycles(void);
+
+// Stats for a zone ID, or NULL if there's no such zone
+const PERF_ZONE_STATS_STRUCT * PERF_Get_Zone_Stats(uint32_t zone);
+uint32_t PERF_Get_Zone_Count(void);
+
+// Clear the stats of all zones, but keep the zones
+void PERF_Reset_Stats(void);
+
+// Print each zone's last frame over dcload: calls, cycles, percent of the
+// frame, events, and the most cycles in a frame
+void PERF_Print_Summary(void);
+
+static inline __attribute__((always_inline)) PERF_SCOPE_STRUCT PERF_Begin(uint32_t * zone_cache, const char * name)
+{
+  PERF_SCOPE_STRUCT scope;
+
+  if(!*zone_cache)
+  {
+    *zone_cache = PERF_Zone(name);
+  }
+  scope.zone = *zone_cache;
+
+  // Cycles last, so as little as possible of this gets counted
+  scope.events = *(volatile uint32_t*)PMCTR2L_REG;
+  scope.cycles = *(volatile uint32_t*)PMCTR1L_REG;
+
+  return scope;
+}
+
+static inline __attribute__((always_inline)) void PERF_End(PERF_SCOPE_STRUCT * scope)
+{
+  // Cycles first, for the same reason
+  uint32_t cycles = *(volatile uint32_t*)PMCTR1L_REG;
+  uint32_t events = *(volatile uint32_t*)PMCTR2L_REG;
+
+  PERF_Record(scope->zone, cycles - scope->cycles, events - scope->events);
+}
+
+#endif /* __PERFZONE_H_ */
@@ -0,0 +1,417 @@
+// ---- pixconv.c - Pixel Format Conversion Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module converts pixels between the four framebuffer color modes in bulk.
+// It is hereby released into the public domain in the hope that it may prove
+// useful.
+//
+
+// See pixconv.h for usage notes.
+#include "pixconv.h"
+#include "startup_support.h"
+
+// Biggest group: 32 pixels at 4 bytes each
+#define PIXCONV_GROUP_WORDS 32
+
+//------------------------------------------------------------------------------
+// Unpacking to 0x00RRGGBB
+//------------------------------------------------------------------------------
+//
+// 'count' is the number of pixels. Full groups are always a multiple of 4
+// pixels, so the word loops only need the remainder handling for the last
+// partial group.
+//
+
+static inline __attribute__((always_inline)) uint32_t expand_0555(uint32_t pixel)
+{
+  uint32_t r = (pixel >> 10) & 0x1f;
+  uint32_t g = (pixel >> 5) & 0x1f;
+  uint32_t b = pixel & 0x1f;
+
+  // Replicate the top bits into the bottom so that full intensity stays full intensity
+  r = (r << 3) | (r >> 2);
+  g = (g << 3) | (g >> 2);
+  b = (b << 3) | (b >> 2);
+
+  return (r << 16) | (g << 8) | b;
+}
+
+static inline __attribute__((always_inline)) uint32_t expand_565(uint32_t pixel)
+{
+  uint32_t r = pixel >> 11;
+  uint32_t g = (pixel >> 5) & 0x3f;
+  uint32_t b = pixel & 0x1f;
+
+  r = (r << 3) | (r >> 2);
+  g = (g << 2) | (g >> 4);
+  b = (b << 3) | (b >> 2);
+
+  return (r << 16) | (g << 8) | b;
+}
+
+static void unpack_16(const uint32_t * src, uint32_t * rgb, uint32_t count, uint32_t mode)
+{
+  uint32_t pairs = count >> 1;
+
+  if(mode == FB_RGB565)
+  {
+    while(pairs--)
+    {
+      uint32_t two_pixels = *src++;
+      rgb[0] = expand_565(two_pixels & 0xffff);
+      rgb[1] = expand_565(two_pixels >> 16);
+      rgb += 2;
+    }
+
+    if(count & 0x1)
+    {
+      *rgb = expand_565(*(const uint16_t*)src);
+    }
+  }
+  else
+  {
+    while(pairs--)
+    {
+      uint32_t two_pixels = *src++;
+      rgb[0] = expand_0555(two_pixels & 0xffff);
+      rgb[1] = expand_0555(two_pixels >> 16);
+      rgb += 2;
+    }
+
+    if(count & 0x1)
+    {
+      *rgb = expand_0555(*(const uint16_t*)src);
+    }
+  }
+}
+
+static void unpack_888(const uint32_t * src, uint32_t * rgb, uint32_t count)
+{
+  // 4 pixels (BGRB GRBG RBGR) per 3 words
+  uint32_t quads = count >> 2;
+
+  while(quads--)
+  {
+    uint32_t word0 = src[0];
+    uint32_t word1 = src[1];
+    uint32_t word2 = src[2];
+
+    rgb[0] = word0 & 0x00ffffff;
+    rgb[1] = (word0 >> 24) | ((word1 & 0xffff) << 8);
+    rgb[2] = (word1 >> 16) | ((word2 & 0xff) << 16);
+    rgb[3] = word2 >> 8;
+
+    src += 3;
+    rgb += 4;
+  }
+
+  const uint8_t * src_bytes = (const uint8_t*)src;
+  for(uint32_t remainder = count & 0x3; remainder; remainder--)
+  {
+    *rgb++ = src_bytes[0] | (src_bytes[1] << 8) | (src_bytes[2] << 16);
+    src_bytes += 3;
+  }
+}
+
+static void unpack_0888(const uint32_t * src, uint32_t * rgb, uint32_t count)
+{
+  while(count--)
+  {
+    *rgb++ = *src++ & 0x00ffffff;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Packing from 0x00RRGGBB
+//------------------------------------------------------------------------------
+//
+// These write whole words, so the last partial group needs to be packed into a
+// temporary buffer first.
+//
+
+static inline __attribute__((always_inline)) uint32_t narrow_0555(uint32_t rgb)
+{
+  return ((rgb >> 9) & 0x7c00) | ((rgb >> 6) & 0x03e0) | ((rgb >> 3) & 0x001f);
+}
+
+static inline __attribute__((always_inline)) uint32_t narrow_565(uint32_t rgb)
+{
+  return ((rgb >> 8) & 0xf800) | ((rgb >> 5) & 0x07e0) | ((rgb >> 3) & 0x001f);
+}
+
+static void pack_16(const uint32_t * rgb, uint32_t * dst, uint32_t count, uint32_t mode)
+{
+  // Odd counts get a zero pixel at the end, which the caller won't copy
+  uint32_t pairs = (count + 1) >> 1;
+
+  if(mode == FB_RGB565)
+  {
+    while(pairs--)
+    {
+      *dst++ = narrow_565(rgb[0]) | (narrow_565(rgb[1]) << 16);
+      rgb += 2;
+    }
+  }
+  else
+  {
+    while(pairs--)
+    {
+      *dst++ = narrow_0555(rgb[0]) | (narrow_0555(rgb[1]) << 16);
+      rgb += 2;
+    }
+  }
+}
+
+static void pack_888(const uint32_t * rgb, uint32_t * dst, uint32_t count)
+{
+  // Any pixels past 'count' in the last quad are padding
+  uint32_t quads = (count + 3) >> 2;
+
+  while(quads--)
+  {
+    uint32_t pixel0 = rgb[0] & 0x00ffffff;
+    uint32_t pixel1 = rgb[1] & 0x00ffffff;
+    uint32_t pixel2 = rgb[2] & 0x00ffffff;
+    uint32_t pixel3 = rgb[3] & 0x00ffffff;
+
+    dst[0] = pixel0 | (pixel1 << 24);
+    dst[1] = (pixel1 >> 8) | (pixel2 << 16);
+    dst[2] = (pixel2 >> 16) | (pixel3 << 8);
+
+    rgb += 4;
+    dst += 3;
+  }
+}
+
+static void pack_0888(const uint32_t * rgb, uint32_t * dst, uint32_t count)
+{
+  while(count--)
+  {
+    *dst++ = *rgb++;
+  }
+}
+
+//------------------------------------------------------------------------------
+// 16-bit to 16-bit
+//------------------------------------------------------------------------------
+//
+// Two pixels at a time, straight from one word to another.
+//
+
+static void convert_565_to_0555(const uint32_t * src, uint32_t * dst, uint32_t words)
+{
+  while(words--)
+  {
+    uint32_t two_pixels = *src++;
+    // Red and the top 5 bits of green move down 1, blue stays
+    *dst++ = ((two_pixels >> 1) & 0x7fe07fe0) | (two_pixels & 0x001f001f);
+  }
+}
+
+static void convert_0555_to_565(const uint32_t * src, uint32_t * dst, uint32_t words)
+{
+  while(words--)
+  {
+    uint32_t two_pixels = *src++;
+    // Red and green move up 1, blue stays, and the top bit of green gets
+    // replicated into the new low bit of green
+    *dst++ = ((two_pixels << 1) & 0xffc0ffc0) | (two_pixels & 0x001f001f) | ((two_pixels >> 4) & 0x00200020);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Groups
+//------------------------------------------------------------------------------
+
+// The last 1 to 3 bytes of a partial group's source, without reading past them
+static inline __attribute__((always_inline)) uint32_t read_partial_word(const uint32_t * src, uint32_t bytes)
+{
+  const uint8_t * src_bytes = (const uint8_t*)src;
+  uint32_t word = 0;
+
+  if(bytes & 0x2)
+  {
+    word = *(const uint16_t*)src_bytes;
+  }
+  if(bytes & 0x1)
+  {
+    word |= (uint32_t)src_bytes[bytes - 1] << ((bytes - 1) << 3);
+  }
+
+  return word;
+}
+
+// Convert up to one group of pixels from 'src' into 'out' (which must have
+// room for PIXCONV_GROUP_WORDS words). Returns the number of bytes of output.
+// Nothing past the last source pixel gets read.
+static uint32_t convert_group(const uint32_t * src, uint32_t * out, uint32_t count, uint32_t src_mode, uint32_t dst_mode)
+{
+  uint32_t src_bytes = count * PIXCONV_BYTES_PER_PIXEL(src_mode);
+  uint32_t dst_bytes = count * PIXCONV_BYTES_PER_PIXEL(dst_mode);
+  uint32_t words = src_bytes >> 2;
+  uint32_t partial_bytes = src_bytes & 0x3;
+
+  if(src_mode == dst_mode)
+  {
+    for(uint32_t i = 0; i < words; i++)
+    {
+      out[i] = src[i];
+    }
+
+    if(partial_bytes)
+    {
+      out[words] = read_partial_word(src + words, partial_bytes);
+    }
+  }
+  else if((src_mode == FB_RGB565) && (dst_mode == FB_RGB0555))
+  {
+    convert_565_to_0555(src, out, words);
+
+    if(partial_bytes)
+    {
+      uint32_t last = read_partial_word(src + words, partial_bytes);
+      convert_565_to_0555(&last, out + words, 1);
+    }
+  }
+  else if((src_mode == FB_RGB0555) && (dst_mode == FB_RGB565))
+  {
+    convert_0555_to_565(src, out, words);
+
+    if(partial_bytes)
+    {
+      uint32_t last = read_partial_word(src + words, partial_bytes);
+      convert_0555_to_565(&last, out + words, 1);
+    }
+  }
+  else
+  {
+    // Padded so that partial pairs and quads can be packed
+    uint32_t rgb[PIXCONV_GROUP_PIXELS + 3];
+
+    if(src_mode == FB_RGB888)
+    {
+      unpack_888(src, rgb, count);
+    }
+    else if(src_mode == FB_RGB0888)
+    {
+      unpack_0888(src, rgb, count);
+    }
+    else
+    {
+      unpack_16(src, rgb, count, src_mode);
+    }
+
+    // Zero the padding so that there's nothing random in the partial words
+    rgb[count] = 0;
+    rgb[count + 1] = 0;
+    rgb[count + 2] = 0;
+
+    if(dst_mode == FB_RGB888)
+    {
+      pack_888(rgb, out, count);
+    }
+    else if(dst_mode == FB_RGB0888)
+    {
+      pack_0888(rgb, out, count);
+    }
+    else
+    {
+      pack_16(rgb, out, count, dst_mode);
+    }
+  }
+
+  return dst_bytes;
+}
+
+//------------------------------------------------------------------------------
+// Conversion functions
+//------------------------------------------------------------------------------
+
+uint32_t PIXCONV_Convert(const void * src, void * dst, uint32_t pixels, uint32_t src_mode, uint32_t dst_mode)
+{
+  const uint8_t * src_bytes = (const uint8_t*)src;
+  uint8_t * dst_bytes = (uint8_t*)dst;
+
+  uint32_t src_group_bytes = PIXCONV_GROUP_PIXELS * PIXCONV_BYTES_PER_PIXEL(src_mode);
+  uint32_t dst_group_bytes = PIXCONV_GROUP_PIXELS * PIXCONV_BYTES_PER_PIXEL(dst_mode);
+  uint32_t groups = pixels / PIXCONV_GROUP_PIXELS;
+  uint32_t remainder = pixels % PIXCONV_GROUP_PIXELS;
+
+  uint32_t group_words[PIXCONV_GROUP_WORDS] __attribute__((aligned(32)));
+
+#ifdef __sh__
+  // VRAM is physical 0x04000000-0x05FFFFFF, from any of P0-P3. Every group is
+  // a whole number of 32-byte blocks, so an aligned start stays aligned.
+  uint32_t physical_area = ((uint32_t)dst >> 24) & 0x1f;
+  if( ((physical_area == 0x04) || (physical_area == 0x05)) && (!((uint32_t)dst & 0x1f)) && groups )
+  {
+    for(; groups; groups--)
+    {
+      convert_group((const uint32_t*)src_bytes, group_words, PIXCONV_GROUP_PIXELS, src_mode, dst_mode);
+      STARTUP_SQ_Copy(dst_bytes, group_words, dst_group_bytes >> 5);
+
+      src_bytes += src_group_bytes;
+      dst_bytes += dst_group_bytes;
+    }
+  }
+#endif
+
+  // Anywhere else, full groups can be converted straight into the destination
+  for(; groups; groups--)
+  {
+    convert_group((const uint32_t*)src_bytes, (uint32_t*)dst_bytes, PIXCONV_GROUP_PIXELS, src_mode, dst_mode);
+
+    src_bytes += src_group_bytes;
+    dst_bytes += dst_group_bytes;
+  }
+
+  // The last partial group may not end on a word boundary, so it goes through
+  // the temporary buffer. Then it's whole words, and the last 1 to 3 bytes
+  // (only with 16 or 24-bit output) go out as 16-bit writes, since VRAM
+  // doesn't take byte writes reliably.
+  if(remainder)
+  {
+    uint32_t bytes = convert_group((const uint32_t*)src_bytes, group_words, remainder, src_mode, dst_mode);
+    uint32_t * dst_words = (uint32_t*)dst_bytes;
+    uint32_t words = bytes >> 2;
+
+    for(uint32_t i = 0; i < words; i++)
+    {
+      dst_words[i] = group_words[i];
+    }
+
+    if(bytes & 0x3)
+    {
+      STARTUP_VRAM_Write_Bytes(dst_words + words, group_words[words], bytes & 0x3);
+    }
+    dst_bytes += bytes;
+  }
+
+  return (uint32_t)(dst_bytes - (uint8_t*)dst);
+}
+
+void PIXCONV_Convert_Rect(const void * src, uint32_t src_pitch, void * dst, uint32_t dst_pitch, uint32_t width, uint32_t height, uint32_t src_mode, uint32_t dst_mode)
+{
+  const uint8_t * src_row = (const uint8_t*)src;
+  uint8_t * dst_row = (uint8_t*)dst;
+
+  // Rows that are packed back to back can all go at once
+  if( (src_pitch == width * PIXCONV_BYTES_PER_PIXEL(src_mode)) && (dst_pitch == width * PIXCONV_BYTES_PER_PIXEL(dst_mode)) )
+  {
+    PIXCONV_Convert(src, dst, width * height, src_mode, dst_mode);
+    return;
+  }
+
+  while(height--)
+  {
+    PIXCONV_Convert(src_row, dst_row, width, src_mode, dst_mode);
+
+    src_row += src_pitch;
+    dst_row += dst_pitch;
+  }
+}
@@ -0,0 +1,58 @@
+// ---- pixconv.h - Pixel Format Conversion Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module converts pixels between the four framebuffer color modes in bulk.
+// It is hereby released into the public domain in the hope that it may prove
+// useful.
+//
+
+#ifndef __PIXCONV_H_
+#define __PIXCONV_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires startup_support.h for the FB_* color mode definitions and
+//  STARTUP_SQ_Copy().
+// - Formats are the same as the framebuffer color modes: FB_RGB0555, FB_RGB565,
+//  FB_RGB888 (packed 24-bit), and FB_RGB0888.
+// - Pixels are converted in groups of 32. A group is always a whole number of
+//  32-byte blocks in every format (64, 96, or 128 bytes), so when the output
+//  is in VRAM and 32-byte aligned, each group goes out with STARTUP_SQ_Copy()
+//  (see the QACR0/1 note in startup_support.h). Any other output just gets
+//  normal word stores.
+// - Within a group, pixels are read and written a whole word at a time: 2 pixels
+//  per word for 16-bit formats, and 4 pixels per 3 words for 24-bit.
+//  The last partial group never reads past the end of 'src', and its last 1 to
+//  3 bytes are written with 16-bit stores (see STARTUP_VRAM_Write_Bytes()), so
+//  no 8-bit writes ever reach VRAM.
+// - RGB0555 <-> RGB565 and same-format copies never unpack to 8 bits per
+//  channel. Everything else goes through 8-bit RGB.
+// - Widening a channel replicates its top bits into the new low bits (so white
+//  stays white), and narrowing a channel truncates, which is what the
+//  RGB565_TO_16_SCALED() and RGB0555_TO_16_SCALED() macros do.
+// - When this module is compiled for something other than SH4, the SQ path is
+//  compiled out, so it can also be used to prepare assets on a host.
+//
+
+// Bytes per pixel for a given FB_* color mode
+#define PIXCONV_BYTES_PER_PIXEL(mode) FB_BYTES_PER_PIXEL(mode)
+
+// Pixels per conversion group
+#define PIXCONV_GROUP_PIXELS 32
+
+// Convert 'pixels' pixels from 'src' in 'src_mode' to 'dst' in 'dst_mode'.
+// Both 'src' and 'dst' must be 4-byte aligned, and they must not overlap.
+// Returns the number of bytes written to 'dst'.
+uint32_t PIXCONV_Convert(const void * src, void * dst, uint32_t pixels, uint32_t src_mode, uint32_t dst_mode);
+
+// Convert a rectangular image, where each row may have padding. Pitches are in
+// bytes and must be multiples of 4.
+void PIXCONV_Convert_Rect(const void * src, uint32_t src_pitch, void * dst, uint32_t dst_pitch, uint32_t width, uint32_t height, uint32_t src_mode, uint32_t dst_mode);
+
+#endif /* __PIXCONV_H_ */
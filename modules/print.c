@@ -10,7 +10,8 @@
 // according to the 3-Clause BSD license below.
 //
 // This module requires the dcload module, but only for printf and vprintf since
-// they write via a dcload syscall.
+// they write via a dcload syscall. Buffered output also needs startup_support.h
+// for its exit hook.
 //
 // --Moopthehedgehog, March 2020
 //
@@ -62,7 +63,10 @@
  */
 
 #include "print.h"
+#include <limits.h>
 #include "fs_dcload.h"
+#include "startup_support.h"
+#include "digits.h"
 
 typedef int ssize_t; // size_t on SH4 is unsigned int. ssize_t is therefore signed int.
 
@@ -74,7 +78,17 @@ static size_t strlen(const char *s);
 static inline int imax(int a, int b);
 //static void printf_putchar(int ch, void *arg);
 static char *ksprintn(char *nbuf, unsigned int num, int base, int *len, int upper);
+static char *ksprintqn(char *nbuf, unsigned long long num, int base, int *lenp, int upper);
+static int ksprintf_float(char *buf, float value, int conv, int prec, int sharpflag, int upper, int *negp);
 static void snprintf_func(int ch, void *arg);
+static int console_vprintf(const char *fmt, va_list ap);
+
+// Buffered console output state, see PRINT_Set_Buffering()
+static char print_console_buffer[PRINT_CONSOLE_BUFFER_SIZE];
+static unsigned int print_console_used = 0;
+static unsigned int print_console_lines = 0;
+static unsigned int print_flush_lines = 0; // 0 = not buffering
+static unsigned int print_exit_hook_added = 0;
 
 #define NBBY    8               /* number of bits in a byte */
 
@@ -82,9 +96,52 @@ const char hex2ascii_data[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
 #define hex2ascii(hex)  (hex2ascii_data[hex])
 #define toupper(c)      ((c) - 0x20 * (((c) >= 'a') && ((c) <= 'z')))
+#define isdigit(c)      (((c) >= '0') && ((c) <= '9'))
+#define isspace(c)      (((c) == ' ') || (((c) >= '\t') && ((c) <= '\r')))
+
+/* Max number conversion buffer length: an unsigned long long int in base 2, plus NUL byte. */
+#define MAXNBUF	(sizeof(long long) * NBBY + 1)
+
+/* Float conversion buffer length: the longest %f is 39 integer digits, a point, and the precision. */
+#define MAXFBUF	(40 + PRINT_FLOAT_MAX_PRECISION + 8)
+
+/* A float's exact value has up to 117 significant digits (FLOAT_LIMBS base-10^9 limbs). */
+#define FLOAT_LIMBS	14
+#define FLOAT_DIGITS	(FLOAT_LIMBS * 9)
+
+/*
+ * strtof() keeps this many significant digits, which is enough since a float
+ * and the points halfway between floats never have more than 113. Its bignum
+ * needs room for those plus scaling by up to 2^180 or 5^110 * 10^8.
+ */
+#define STRTOF_DIGITS	FLOAT_DIGITS
+#define STRTOF_LIMBS	(FLOAT_LIMBS + 14)
+
+/* Powers of 10 of the first digit past which strtof() gives zero or infinity. */
+#define STRTOF_MIN_POINT	-46
+#define STRTOF_MAX_POINT	38
 
-/* Max number conversion buffer length: an unsigned long int in base 2, plus NUL byte. */
-#define MAXNBUF	(sizeof(int) * NBBY + 1)
+/* sscanf() copies fields with a width to a buffer this big to parse them. */
+#define MAXSBUF	64
+
+/* PRINT_FIELD flags: kvprintf()'s ladjust, sharpflag, sign, and dot, plus one for fields with none of them. */
+#define PRINT_FIELD_LADJUST	1
+#define PRINT_FIELD_SHARP	2
+#define PRINT_FIELD_SIGN	4
+#define PRINT_FIELD_DOT	8
+#define PRINT_FIELD_PLAIN	16
+
+/* PRINT_FIELD lengths, from the h, hh, l, ll, and q modifiers. */
+#define PRINT_LENGTH_INT	0
+#define PRINT_LENGTH_CHAR	1
+#define PRINT_LENGTH_SHORT	2
+#define PRINT_LENGTH_LONG	3
+#define PRINT_LENGTH_LONG_LONG	4
+
+/* PRINT_CACHE states. Static caches start out zeroed, so empty has to be 0. */
+#define PRINT_CACHE_EMPTY	0
+#define PRINT_CACHE_READY	1
+#define PRINT_CACHE_UNCACHEABLE	2
 
 struct snprintf_arg {
 	char	*str;
@@ -111,56 +168,347 @@ static inline int imax(int a, int b)
 //------------------------------------------------------------------------------
 
 /*
- * Put a NUL-terminated ASCII number (base = 2, 8, 10, or 16) in a buffer in reverse
- * order; return an optional length and a pointer to the last character
- * written in the buffer (i.e., the first character of the string).
+ * Put a NUL-terminated ASCII number (base = 2, 8, 10, or 16) at the end of a
+ * buffer; return an optional length and a pointer to the first character.
+ * Decimal goes two digits at a time (see digits.h).
  * The buffer pointed to by `nbuf' must have length >= MAXNBUF.
  */
 static char * ksprintn(char *nbuf, unsigned int num, int base, int *lenp, int upper)
 {
 	char *p, c;
 
-	p = nbuf;
+	p = nbuf + MAXNBUF - 1;
 	*p = '\0';
 	if(base == 10)
+	{
+		p = DIGITS_U32_To_Dec_Backward(num, p);
+	}
+	else if(base == 16)
+	{
+		do {
+			c = hex2ascii(num & 15);
+			*--p = upper ? toupper(c) : c;
+		} while (num >>= 4);
+	}
+	else if(base == 8)
+	{
+		do {
+			c = hex2ascii(num & 7);
+			*--p = upper ? toupper(c) : c;
+		} while (num >>= 3);
+	}
+	else if(base == 2)
 	{
 		do {
-			c = hex2ascii(num % 10);
-			*++p = upper ? toupper(c) : c;
-		} while (num /= 10); // GCC has a special trick for this.
+			c = hex2ascii(num & 1);
+			*--p = upper ? toupper(c) : c;
+		} while (num >>= 1);
+	}
+	else
+	{
+		c = '?';
+		*--p = c;
+	}
+
+	if (lenp)
+		*lenp = (nbuf + MAXNBUF - 1) - p;
+	return (p);
+}
+
+/*
+ * The SH4 can't divide a 64-bit number without libgcc's __udivdi3, so this
+ * divides by 10^9 with a multiply by the reciprocal instead. Since
+ * 10^9 = 2^9 * 1953125, n / 10^9 = ((n >> 9) * 0x89705f4136b4a598) >> (64 + 20),
+ * which is exact for every 64-bit n. The high half of the 64x64-bit product
+ * is put together from 32x32->64-bit multiplies.
+ */
+static unsigned long long udiv1e9(unsigned long long n, unsigned int *rem)
+{
+	unsigned long long m = n >> 9;
+	unsigned int mhi = (unsigned int)(m >> 32), mlo = (unsigned int)m;
+	unsigned long long lolo = (unsigned long long)mlo * 0x36b4a598U;
+	unsigned long long hilo = (unsigned long long)mhi * 0x36b4a598U;
+	unsigned long long lohi = (unsigned long long)mlo * 0x89705f41U;
+	unsigned long long mid = (lolo >> 32) + (unsigned int)hilo + (unsigned int)lohi;
+	unsigned long long q;
+
+	q = ((unsigned long long)mhi * 0x89705f41U + (hilo >> 32) + (lohi >> 32) + (mid >> 32)) >> 20;
+
+	// The remainder fits in 32 bits, so only the low halves matter
+	*rem = (unsigned int)n - (unsigned int)q * 1000000000U;
+	return (q);
+}
+
+/*
+ * 64-bit version of ksprintn(). Decimal goes 9 digits at a time with
+ * udiv1e9() until what's left fits in 32 bits.
+ */
+static char * ksprintqn(char *nbuf, unsigned long long num, int base, int *lenp, int upper)
+{
+	char *p, c;
+	unsigned int chunk;
+
+	p = nbuf + MAXNBUF - 1;
+	*p = '\0';
+	if(base == 10)
+	{
+		while (num >> 32) {
+			num = udiv1e9(num, &chunk);
+			p -= 9;
+			DIGITS_U32_To_Dec_Fixed(chunk, 9, p);
+		}
+		p = DIGITS_U32_To_Dec_Backward((unsigned int)num, p);
 	}
 	else if(base == 16)
 	{
 		do {
 			c = hex2ascii(num & 15);
-			*++p = upper ? toupper(c) : c;
+			*--p = upper ? toupper(c) : c;
 		} while (num >>= 4);
 	}
 	else if(base == 8)
 	{
 		do {
 			c = hex2ascii(num & 7);
-			*++p = upper ? toupper(c) : c;
+			*--p = upper ? toupper(c) : c;
 		} while (num >>= 3);
 	}
 	else if(base == 2)
 	{
 		do {
 			c = hex2ascii(num & 1);
-			*++p = upper ? toupper(c) : c;
+			*--p = upper ? toupper(c) : c;
 		} while (num >>= 1);
 	}
 	else
 	{
 		c = '?';
-		*++p = c;
+		*--p = c;
 	}
 
 	if (lenp)
-		*lenp = p - nbuf;
+		*lenp = (nbuf + MAXNBUF - 1) - p;
 	return (p);
 }
 
+/*
+ * Multiply a base-10^9 bignum (least significant limb first) by 'factor',
+ * which must be under 2^31.
+ */
+static void float_scale(unsigned int *limbs, int *countp, unsigned int factor)
+{
+	unsigned long long carry = 0;
+	int i;
+
+	for (i = 0; i < *countp; i++)
+		carry = udiv1e9((unsigned long long)limbs[i] * factor + carry, &limbs[i]);
+
+	while (carry) {
+		limbs[(*countp)++] = (unsigned int)carry % 1000000000U;
+		carry = (unsigned int)carry / 1000000000U;
+	}
+}
+
+/*
+ * Exact decimal digits of a float. It's the same idea as mantissa_to_string()
+ * in simple_print.c, where each mantissa bit is worth a power of 5, except
+ * with enough limbs that nothing gets cut off: a float is m * 2^e, which is
+ * m << e when e >= 0 and m * 5^-e / 10^-e when it isn't. Returns the number
+ * of digits, with no leading zeros, and sets *pointp to how many of them go
+ * before the decimal point (which can be negative or more than all of them).
+ */
+static int float_digits(unsigned int bits, char *digits, int *pointp)
+{
+	unsigned int limbs[FLOAT_LIMBS];
+	unsigned int mantissa = bits & 0x7fffff;
+	int exponent = (bits >> 23) & 0xff;
+	int count = 1, dexp = 0, steps, i;
+	unsigned int factor;
+	char *d = digits;
+
+	if (exponent)
+		mantissa |= 0x800000;
+	else
+		exponent = 1; // Denormal
+	exponent -= 150;
+
+	if (!mantissa) {
+		digits[0] = '0';
+		*pointp = 1;
+		return (1);
+	}
+
+	limbs[0] = mantissa;
+	if (exponent < 0) {
+		dexp = exponent;
+		for (exponent = -exponent; exponent; exponent -= steps) {
+			steps = exponent > 13 ? 13 : exponent; // 5^13 < 2^31
+			for (factor = 1, i = 0; i < steps; i++)
+				factor *= 5;
+			float_scale(limbs, &count, factor);
+		}
+	} else {
+		for (; exponent; exponent -= steps) {
+			steps = exponent > 30 ? 30 : exponent;
+			float_scale(limbs, &count, 1U << steps);
+		}
+	}
+
+	// Most significant limb without leading zeros, then 9 digits per limb
+	d += DIGITS_U32_To_Dec(limbs[count - 1], d);
+	for (i = count - 2; i >= 0; i--) {
+		DIGITS_U32_To_Dec_Fixed(limbs[i], 9, d);
+		d += 9;
+	}
+
+	*pointp = (d - digits) + dexp;
+	return (d - digits);
+}
+
+/*
+ * Round exact digits to the first 'keep' of them, half to even, and return
+ * how many are left. A carry out of the first digit leaves "1" and moves the
+ * point. If nothing is kept, the result is 0 or 1 in the place just before
+ * the digits.
+ */
+static int float_round(char *digits, int count, int keep, int *pointp)
+{
+	int i, up;
+
+	if (keep >= count)
+		return (count);
+
+	if (keep < 0) {
+		digits[0] = '0';
+		*pointp = 1;
+		return (1);
+	}
+
+	up = digits[keep] > '5';
+	if (digits[keep] == '5') {
+		// Exactly half if the rest are zeros, so go to the even side
+		up = keep && ((digits[keep - 1] - '0') & 1);
+		for (i = keep + 1; i < count; i++)
+			if (digits[i] != '0')
+				up = 1;
+	}
+
+	if (!keep) {
+		digits[0] = up ? '1' : '0';
+		if (up)
+			(*pointp)++;
+		else
+			*pointp = 1;
+		return (1);
+	}
+
+	if (up) {
+		for (i = keep - 1; i >= 0 && digits[i] == '9'; i--)
+			digits[i] = '0';
+		if (i < 0) {
+			digits[0] = '1';
+			(*pointp)++;
+		} else
+			digits[i]++;
+	}
+
+	return (keep);
+}
+
+/*
+ * Format a float for %e, %f, or %g ('conv' is the lowercase one) without its
+ * sign, which goes in *negp. Returns the length.
+ */
+static int ksprintf_float(char *buf, float value, int conv, int prec, int sharpflag, int upper, int *negp)
+{
+	union {
+		float f;
+		unsigned int u;
+	} bits;
+	char digits[FLOAT_DIGITS];
+	char *b = buf;
+	const char *special;
+	int count, point, exponent, i;
+	int strip = 0;
+
+	bits.f = value;
+	*negp = bits.u >> 31;
+
+	if (((bits.u >> 23) & 0xff) == 0xff) {
+		special = (bits.u & 0x7fffff) ? "nan" : "inf";
+		for (i = 0; i < 3; i++)
+			*b++ = upper ? toupper(special[i]) : special[i];
+		return (b - buf);
+	}
+
+	if (prec > PRINT_FLOAT_MAX_PRECISION)
+		prec = PRINT_FLOAT_MAX_PRECISION;
+
+	count = float_digits(bits.u, digits, &point);
+
+#define DIGIT(i) (((i) >= 0 && (i) < count) ? digits[i] : '0')
+
+	if (conv == 'g') {
+		// Precision is significant digits here, and %e is used for
+		// exponents under -4 or at least the precision
+		if (!prec)
+			prec = 1;
+		count = float_round(digits, count, prec, &point);
+		exponent = point - 1;
+		if (exponent >= -4 && exponent < prec) {
+			conv = 'f';
+			prec -= exponent + 1;
+		} else {
+			conv = 'e';
+			prec--;
+		}
+		strip = !sharpflag;
+	}
+
+	if (conv == 'f') {
+		count = float_round(digits, count, point + prec, &point);
+		if (point > 0)
+			for (i = 0; i < point; i++)
+				*b++ = DIGIT(i);
+		else
+			*b++ = '0';
+		if (prec || sharpflag)
+			*b++ = '.';
+		for (i = 0; i < prec; i++)
+			*b++ = DIGIT(point + i);
+	} else {
+		count = float_round(digits, count, prec + 1, &point);
+		exponent = point - 1;
+		*b++ = DIGIT(0);
+		if (prec || sharpflag)
+			*b++ = '.';
+		for (i = 1; i <= prec; i++)
+			*b++ = DIGIT(i);
+	}
+
+	if (strip && prec) {
+		while (b[-1] == '0')
+			b--;
+		if (b[-1] == '.')
+			b--;
+	}
+
+	if (conv == 'e') {
+		*b++ = upper ? 'E' : 'e';
+		*b++ = exponent < 0 ? '-' : '+';
+		if (exponent < 0)
+			exponent = -exponent;
+		if (exponent >= 100)
+			*b++ = hex2ascii(exponent / 100);
+		*b++ = hex2ascii(exponent / 10 % 10);
+		*b++ = hex2ascii(exponent % 10);
+	}
+
+#undef DIGIT
+
+	return (b - buf);
+}
+
 /*
  * Scaled down version of printf(3).
  *
@@ -191,12 +539,14 @@ int kvprintf(char const *fmt, void (*func)(int, void*), void *arg, int radix, va
 {
 #define PCHAR(c) {int cc=(c); if (func) (*func)(cc,arg); else *d++ = cc; retval++; }
 	char nbuf[MAXNBUF];
+	char fbuf[MAXFBUF];
 	char *d;
 	const char *p, *percent, *q;
 	unsigned char *up;
 	int ch, n;
 	unsigned int num;
-	int base, lflag, tmp, width, ladjust, sharpflag, neg, sign, dot;
+	unsigned long long qnum;
+	int base, lflag, qflag, tmp, width, ladjust, sharpflag, neg, sign, dot;
 	int cflag, hflag, jflag, tflag, zflag;
 	int bconv, dwidth, upper;
 	char padc;
@@ -224,7 +574,7 @@ int kvprintf(char const *fmt, void (*func)(int, void*), void *arg, int radix, va
 			PCHAR(ch);
 		}
 		percent = fmt - 1;
-		lflag = 0; ladjust = 0; sharpflag = 0; neg = 0;
+		lflag = 0; qflag = 0; ladjust = 0; sharpflag = 0; neg = 0;
 		sign = 0; dot = 0; bconv = 0; dwidth = 0; upper = 0;
 		cflag = 0; hflag = 0; jflag = 0; tflag = 0; zflag = 0;
 reswitch:	switch (ch = (unsigned char)*fmt++) {
@@ -288,6 +638,35 @@ reswitch:	switch (ch = (unsigned char)*fmt++) {
 				while (width--)
 					PCHAR(padc);
 			break;
+		case 'E':
+		case 'F':
+		case 'G':
+			upper = 1;
+			__attribute__ ((fallthrough));
+		case 'e':
+		case 'f':
+		case 'g':
+			// double is float with -m4-single-only, so this is free on SH4
+			n = ksprintf_float(fbuf, (float)va_arg(ap, double), ch | 0x20, dot ? dwidth : 6, sharpflag, upper, &neg);
+			if (fbuf[0] > '9') // inf and nan don't get zero padding
+				padc = ' ';
+			width -= n + (neg || sign);
+			if (!ladjust && padc != '0')
+				while (width-- > 0)
+					PCHAR(' ');
+			if (neg)
+				PCHAR('-');
+			if (sign && !neg)
+				PCHAR('+');
+			if (!ladjust && padc == '0')
+				while (width-- > 0)
+					PCHAR('0');
+			for (p = fbuf; n--; p++)
+				PCHAR(*p);
+			if (ladjust)
+				while (width-- > 0)
+					PCHAR(' ');
+			break;
 		case 'D':
 			up = va_arg(ap, unsigned char *);
 			p = va_arg(ap, char *);
@@ -318,10 +697,16 @@ reswitch:	switch (ch = (unsigned char)*fmt++) {
 			jflag = 1;
 			goto reswitch;
 		case 'l':
-			lflag = 1;
+			if (lflag) {
+				lflag = 0;
+				qflag = 1;
+			} else
+				lflag = 1;
 			goto reswitch;
 		case 'n':
-			if (jflag)
+			if (qflag)
+				*(va_arg(ap, long long *)) = retval;
+			else if (jflag)
 				*(va_arg(ap, int *)) = retval;
 			else if (lflag)
 				*(va_arg(ap, long *)) = retval;
@@ -338,11 +723,15 @@ reswitch:	switch (ch = (unsigned char)*fmt++) {
 			base = 8;
 			goto handle_nosign;
 		case 'p':
+			qflag = 0;
 			base = 16;
 			sharpflag = (width == 0);
 			sign = 0;
 			num = (uintptr_t)va_arg(ap, void *);
 			goto number;
+		case 'q':
+			qflag = 1;
+			goto reswitch;
 		case 'r':
 			base = radix;
 			if (sign)
@@ -390,7 +779,9 @@ reswitch:	switch (ch = (unsigned char)*fmt++) {
 			goto reswitch;
 handle_nosign:
 			sign = 0;
-			if (jflag)
+			if (qflag)
+				qnum = va_arg(ap, unsigned long long);
+			else if (jflag)
 				num = va_arg(ap, unsigned int);
 			else if (tflag)
 				num = va_arg(ap, ptrdiff_t);
@@ -410,7 +801,9 @@ handle_nosign:
 			}
 			goto number;
 handle_sign:
-			if (jflag)
+			if (qflag)
+				qnum = va_arg(ap, long long);
+			else if (jflag)
 				num = va_arg(ap, int);
 			else if (tflag)
 				num = va_arg(ap, ptrdiff_t);
@@ -425,11 +818,20 @@ handle_sign:
 			else
 				num = va_arg(ap, int);
 number:
-			if (sign && (int)num < 0) {
-				neg = 1;
-				num = -(int)num;
+			if (qflag) {
+				if (sign && (long long)qnum < 0) {
+					neg = 1;
+					qnum = 0 - qnum;
+				}
+				p = ksprintqn(nbuf, qnum, base, &n, upper);
+				num = (qnum != 0); // Only checked for zero from here on
+			} else {
+				if (sign && (int)num < 0) {
+					neg = 1;
+					num = 0 - num;
+				}
+				p = ksprintn(nbuf, num, base, &n, upper);
 			}
-			p = ksprintn(nbuf, num, base, &n, upper);
 			tmp = 0;
 
 			// There's weird behavior here with #. Don't use # to get 0x with zero-padding
@@ -468,7 +870,7 @@ number:
 				PCHAR('0');
 
 			while (*p)
-				PCHAR(*p--);
+				PCHAR(*p++);
 
 			if (bconv && num != 0) {
 				/* %b conversion flag format. */
@@ -597,11 +999,9 @@ int printf(const char *fmt, ...)
 	va_list ap;
 
 	va_start(ap, fmt);
-	retval = vsprintf(print_buffer, fmt, ap);
+	retval = vprintf(fmt, ap);
 	va_end(ap);
 
-	dcloadsyscall(DCLOAD_WRITE, 1, print_buffer, retval + 1); // fd = 1 is stdout
-
 	return (retval);
 }
 
@@ -610,6 +1010,9 @@ int vprintf(const char *fmt, va_list ap)
 {
 	int retval;
 
+	if (print_flush_lines)
+		return (console_vprintf(fmt, ap));
+
 	retval = vsprintf(print_buffer, fmt, ap);
 
 	dcloadsyscall(DCLOAD_WRITE, 1, print_buffer, retval + 1); // fd = 1 is stdout
@@ -617,6 +1020,67 @@ int vprintf(const char *fmt, va_list ap)
 	return (retval);
 }
 
+//------------------------------------------------------------------------------
+// Buffered console output
+//------------------------------------------------------------------------------
+//
+// Output goes straight into print_console_buffer as it's formatted, so there's
+// no 1kB limit per call here. Flushing sends the buffer in PRINT_PACKET_SIZE
+// pieces, so a full buffer is exactly 4 writes.
+
+static void console_putchar(int ch, void *arg)
+{
+	(void)arg;
+
+	if (print_console_used == PRINT_CONSOLE_BUFFER_SIZE)
+		PRINT_Flush();
+
+	print_console_buffer[print_console_used++] = ch;
+
+	if (ch == '\n')
+		print_console_lines++;
+}
+
+static int console_vprintf(const char *fmt, va_list ap)
+{
+	int retval;
+
+	retval = kvprintf(fmt, console_putchar, NULL, 10, ap);
+
+	if (print_console_lines >= print_flush_lines)
+		PRINT_Flush();
+
+	return (retval);
+}
+
+void PRINT_Flush(void)
+{
+	unsigned int sent = 0;
+
+	while (sent < print_console_used) {
+		unsigned int size = print_console_used - sent;
+
+		if (size > PRINT_PACKET_SIZE)
+			size = PRINT_PACKET_SIZE;
+
+		dcloadsyscall(DCLOAD_WRITE, 1, &print_console_buffer[sent], size); // fd = 1 is stdout
+		sent += size;
+	}
+
+	print_console_used = 0;
+	print_console_lines = 0;
+}
+
+void PRINT_Set_Buffering(unsigned int flush_lines)
+{
+	if (!flush_lines)
+		PRINT_Flush();
+	else if (!print_exit_hook_added)
+		print_exit_hook_added = STARTUP_Add_Exit_Hook(PRINT_Flush);
+
+	print_flush_lines = flush_lines;
+}
+
 // Likewise a real sprintf()!
 /*
  * Scaled down version of sprintf(3).
@@ -644,3 +1108,901 @@ int vsprintf(char *buf, const char *cfmt, va_list ap)
 	buf[retval] = '\0';
 	return (retval);
 }
+
+//------------------------------------------------------------------------------
+// String parsing
+//------------------------------------------------------------------------------
+
+/*
+ * True if all 4 bytes of 'word' are '0' to '9'. Subtracting '0' sets a byte's
+ * top bit if it was below '0', and adding 0x80 - 10 - '0' sets it if it was
+ * above '9'. The lowest byte that isn't a digit always ends up flagged, no
+ * matter what borrows or carries do to the bytes above it.
+ */
+static inline int swar_digits(unsigned int word)
+{
+	return (!(((word - 0x30303030U) | (word + 0x46464646U)) & 0x80808080U));
+}
+
+/*
+ * Value of 4 digits that swar_digits() accepted. The first one is in the
+ * lowest byte since the SH4 is little-endian: pairs are combined into bytes 0
+ * and 2 first, then those into the final number, for 2 multiplies instead of 4.
+ */
+static inline unsigned int swar_value(unsigned int word)
+{
+	word -= 0x30303030U;
+	word = word * 10 + (word >> 8);
+	return ((word & 0xff) * 100 + ((word >> 16) & 0xff));
+}
+
+// Parsing reads a word at a time, which needs to be allowed to alias chars
+typedef unsigned int __attribute__((may_alias)) swar_word;
+
+/*
+ * Digit value of an alphanumeric character, or 36 for anything else.
+ */
+static inline unsigned int digit_value(int c)
+{
+	if (isdigit(c))
+		return (c - '0');
+	c |= 0x20; // Lowercase
+	if (c >= 'a' && c <= 'z')
+		return (c - 'a' + 10);
+	return (36);
+}
+
+/*
+ * The common part of strtoul() and strtol(): returns the magnitude, saturated
+ * to UINT_MAX, with the sign and whether it saturated in *negp and *overp.
+ * long is 32 bits on SH4, so everything here is done in 32-bit ints, which
+ * also makes a host build (with 64-bit longs) behave the same.
+ */
+static unsigned int strtoul_magnitude(const char *nptr, char **endptr, int base, int *negp, int *overp)
+{
+	const char *s = nptr;
+	unsigned int acc = 0;
+	unsigned long long t;
+	unsigned int d;
+	int any = 0;
+
+	*negp = 0;
+	*overp = 0;
+
+	while (isspace(*s))
+		s++;
+	if (*s == '-' || *s == '+')
+		*negp = (*s++ == '-');
+
+	if ((base == 0 || base == 16) && s[0] == '0' && (s[1] | 0x20) == 'x' && digit_value(s[2]) < 16) {
+		s += 2;
+		base = 16;
+	} else if (base == 0) {
+		base = (*s == '0') ? 8 : 10;
+	}
+
+	if (base < 2 || base > 36) {
+		if (endptr)
+			*endptr = (char *)nptr;
+		return (0);
+	}
+
+	for (;;) {
+		// 4 decimal digits at a time when they're word-aligned
+		if (base == 10 && !((size_t)s & 3) && swar_digits(*(const swar_word *)s)) {
+			t = (unsigned long long)acc * 10000 + swar_value(*(const swar_word *)s);
+			if (t >> 32)
+				*overp = 1;
+			else
+				acc = (unsigned int)t;
+			s += 4;
+			any = 1;
+			continue;
+		}
+
+		d = digit_value(*s);
+		if (d >= (unsigned int)base)
+			break;
+		t = (unsigned long long)acc * base + d;
+		if (t >> 32)
+			*overp = 1;
+		else
+			acc = (unsigned int)t;
+		s++;
+		any = 1;
+	}
+
+	if (endptr)
+		*endptr = (char *)(any ? s : nptr);
+	if (!any)
+		*negp = 0;
+	return (*overp ? UINT_MAX : acc);
+}
+
+/*
+ * Scaled down version of strtoul(3). There's no errno: out of range
+ * values just give ULONG_MAX.
+ */
+unsigned long strtoul(const char *nptr, char **endptr, int base)
+{
+	unsigned int acc;
+	int neg, over;
+
+	acc = strtoul_magnitude(nptr, endptr, base, &neg, &over);
+	if (over)
+		return (UINT_MAX);
+	return (neg ? 0 - acc : acc);
+}
+
+/*
+ * Scaled down version of strtol(3). Out of range values give LONG_MAX or
+ * LONG_MIN.
+ */
+long strtol(const char *nptr, char **endptr, int base)
+{
+	unsigned int acc;
+	int neg, over;
+
+	acc = strtoul_magnitude(nptr, endptr, base, &neg, &over);
+	if (neg) {
+		if (over || acc > (unsigned int)INT_MAX + 1)
+			return (INT_MIN);
+		return ((int)(0 - acc));
+	}
+	if (over || acc > INT_MAX)
+		return (INT_MAX);
+	return ((int)acc);
+}
+
+/*
+ * Case-insensitive match of a lowercase word at the start of a string.
+ * Returns its length, or 0 if it isn't there.
+ */
+static int match_word(const char *s, const char *word)
+{
+	int i;
+
+	for (i = 0; word[i]; i++)
+		if ((s[i] | 0x20) != word[i])
+			return (0);
+	return (i);
+}
+
+/*
+ * Scaled down version of strtof(3), correctly rounded (half to even). No hex
+ * floats, and no errno: out of range values give infinity or zero.
+ *
+ * It's exact in the same way as float_digits() in reverse: the digits go into
+ * a base-10^9 bignum N with F limbs after the point, which gets scaled by
+ * 2^s until its integer part J has exactly 25 bits. That's the mantissa plus
+ * one bit to round with, and anything left after the point only matters as
+ * "more than half" for rounding. Scaling down by 2^s is done as scaling up by
+ * 5^s and moving the point, so it's all multiplies.
+ */
+float strtof(const char *nptr, char **endptr)
+{
+	unsigned int limbs[STRTOF_LIMBS];
+	char digits[STRTOF_DIGITS];
+	const char *s = nptr, *t;
+	int ndigits = 0, dexp = 0, eval = 0, esign, neg = 0, any = 0, sticky = 0;
+	int count, point, frac, zeros, total, scale, steps, i, j;
+	unsigned int factor, n, shift, bits;
+	union {
+		float f;
+		unsigned int u;
+	} result;
+
+	while (isspace(*s))
+		s++;
+	if (*s == '-' || *s == '+')
+		neg = (*s++ == '-');
+
+	if ((i = match_word(s, "inf"))) {
+		s += i;
+		if ((i = match_word(s, "inity")))
+			s += i;
+		bits = 0x7f800000;
+		goto done;
+	}
+	if ((i = match_word(s, "nan"))) {
+		s += i;
+		if (*s == '(') {
+			for (t = s + 1; digit_value(*t) < 36 || *t == '_'; t++)
+				;
+			if (*t == ')')
+				s = t + 1;
+		}
+		bits = 0x7fc00000;
+		goto done;
+	}
+
+	// Significant digits, keeping track of where the point is
+	for (; isdigit(*s); s++) {
+		any = 1;
+		if (ndigits < STRTOF_DIGITS) {
+			if (ndigits || *s != '0')
+				digits[ndigits++] = *s;
+		} else {
+			sticky |= (*s != '0');
+			dexp++;
+		}
+	}
+	if (*s == '.') {
+		for (s++; isdigit(*s); s++) {
+			any = 1;
+			if (ndigits < STRTOF_DIGITS) {
+				if (ndigits || *s != '0')
+					digits[ndigits++] = *s;
+				dexp--;
+			} else {
+				sticky |= (*s != '0');
+			}
+		}
+	}
+	if (!any) {
+		s = nptr;
+		bits = 0;
+		neg = 0;
+		goto done;
+	}
+
+	// The exponent only counts if there are digits after the e
+	if ((*s | 0x20) == 'e') {
+		t = s + 1;
+		esign = 1;
+		if (*t == '-' || *t == '+')
+			esign = (*t++ == '-') ? -1 : 1;
+		if (isdigit(*t)) {
+			for (; isdigit(*t); t++)
+				if (eval < 100000)
+					eval = eval * 10 + (*t - '0');
+			dexp += esign * eval;
+			s = t;
+		}
+	}
+
+	// The value is digits * 10^dexp, and point is the power of 10 of the first digit
+	point = dexp + ndigits - 1;
+	if (!ndigits || point < STRTOF_MIN_POINT) {
+		bits = 0;
+		goto done;
+	}
+	if (point > STRTOF_MAX_POINT) {
+		bits = 0x7f800000;
+		goto done;
+	}
+
+	// Pad with zeros on the right so that the point lands between two limbs,
+	// with frac limbs after it
+	zeros = (dexp >= 0) ? dexp : (9 - (-dexp % 9)) % 9;
+	frac = (dexp >= 0) ? 0 : (-dexp + zeros) / 9;
+	total = ndigits + zeros;
+	count = (total + 8) / 9;
+	for (i = 0; i < count; i++) {
+		n = 0;
+		for (j = total - 9 * (i + 1); j < total - 9 * i; j++)
+			n = n * 10 + ((j >= 0 && j < ndigits) ? digits[j] - '0' : 0);
+		limbs[i] = n;
+	}
+
+	// Start with a scale that puts J a little under 2^24 (1701 / 512 is just over log2(10))
+	scale = 23 - (((dexp + ndigits) * 1701) >> 9);
+	if (scale >= 0) {
+		for (i = scale; i; i -= steps) {
+			steps = i > 30 ? 30 : i;
+			float_scale(limbs, &count, 1U << steps);
+		}
+	} else {
+		for (i = -scale; i; i -= steps) {
+			steps = i > 13 ? 13 : i; // 5^13 < 2^31
+			for (factor = 1, j = 0; j < steps; j++)
+				factor *= 5;
+			float_scale(limbs, &count, factor);
+		}
+		// Then multiply by 10^zeros so that the point moves by whole limbs
+		zeros = (9 - (-scale % 9)) % 9;
+		for (factor = 1, j = 0; j < zeros; j++)
+			factor *= 10;
+		float_scale(limbs, &count, factor);
+		frac += (-scale + zeros) / 9;
+	}
+
+	// ...and double until it's 25 bits
+	for (;;) {
+		n = (count > frac) ? limbs[frac] : 0;
+		if (n >= (1U << 24))
+			break;
+		float_scale(limbs, &count, 2);
+		scale++;
+	}
+	for (i = 0; i < frac && i < count; i++)
+		sticky |= (limbs[i] != 0);
+
+	/*
+	 * The value is n * 2^-scale. Normal floats drop one bit to round with;
+	 * denormals (scale > 150) drop more, and those go into sticky, too.
+	 * Adding the mantissa to the exponent field like this means that rounding
+	 * up into the next power of 2 just carries into the exponent.
+	 */
+	if (scale > 150) {
+		shift = scale - 149;
+		bits = 0;
+	} else {
+		shift = 1;
+		bits = (150 - scale) << 23;
+	}
+	sticky |= ((n & ((1U << (shift - 1)) - 1)) != 0);
+	bits += n >> shift;
+	if (((n >> (shift - 1)) & 1) && (sticky || (bits & 1)))
+		bits++;
+	if (bits > 0x7f800000)
+		bits = 0x7f800000;
+
+done:
+	if (endptr)
+		*endptr = (char *)s;
+	result.u = bits | ((unsigned int)neg << 31);
+	return (result.f);
+}
+
+/*
+ * Scaled down version of sscanf(3).
+ */
+int sscanf(const char *str, const char *format, ...)
+{
+	int retval;
+	va_list ap;
+
+	va_start(ap, format);
+	retval = vsscanf(str, format, ap);
+	va_end(ap);
+	return (retval);
+}
+
+/*
+ * Scaled down version of vsscanf(3). See print.h for what's supported.
+ */
+int vsscanf(const char *str, const char *format, va_list ap)
+{
+	char field[MAXSBUF];
+	const char *s = str, *fmt = format, *in, *start;
+	char *end, *out = field;
+	unsigned long num;
+	float fnum;
+	int ch, width, suppress, lflag, hflag, base, count = 0;
+
+	for (;;) {
+		ch = (unsigned char)*fmt++;
+		if (ch == '\0')
+			return (count);
+
+		// Whitespace matches any amount of it, including none
+		if (isspace(ch)) {
+			while (isspace(*s))
+				s++;
+			continue;
+		}
+
+		if (ch != '%' || *fmt == '%') {
+			if (ch == '%') {
+				fmt++;
+				while (isspace(*s))
+					s++;
+			}
+			if (*s != ch)
+				return (count);
+			s++;
+			continue;
+		}
+
+		suppress = 0; width = 0; lflag = 0; hflag = 0;
+		if (*fmt == '*') {
+			suppress = 1;
+			fmt++;
+		}
+		while (isdigit(*fmt))
+			width = width * 10 + (*fmt++ - '0');
+		for (;; fmt++) {
+			if (*fmt == 'l')
+				lflag++;
+			else if (*fmt == 'h')
+				hflag++;
+			else if (*fmt != 'z' && *fmt != 'j' && *fmt != 't')
+				break;
+		}
+		ch = (unsigned char)*fmt++;
+
+		if (ch == 'n') {
+			if (!suppress)
+				*va_arg(ap, int *) = s - str;
+			continue;
+		}
+
+		if (ch != 'c')
+			while (isspace(*s))
+				s++;
+		if (*s == '\0')
+			return (count ? count : -1);
+
+		// Numbers are parsed from a copy when there's a width, so that they stop there
+		in = start = s;
+		if (width && ch != 's' && ch != 'c') {
+			if (width > MAXSBUF - 1)
+				width = MAXSBUF - 1;
+			for (out = field; out < field + width && *s; )
+				*out++ = *s++;
+			*out = '\0';
+			start = field;
+		}
+
+		switch (ch) {
+		case 'd':
+		case 'u':
+			base = 10;
+			goto number;
+		case 'i':
+			base = 0;
+			goto number;
+		case 'o':
+			base = 8;
+			goto number;
+		case 'x':
+		case 'X':
+			base = 16;
+number:
+			num = strtoul(start, &end, base);
+			if (end == start)
+				return (count);
+			s = in + (end - start);
+			if (!suppress) {
+				if (hflag > 1)
+					*va_arg(ap, char *) = (char)num;
+				else if (hflag)
+					*va_arg(ap, short *) = (short)num;
+				else if (lflag)
+					*va_arg(ap, long *) = (long)num;
+				else
+					*va_arg(ap, int *) = (int)num;
+			}
+			break;
+		case 'a':
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+			fnum = strtof(start, &end);
+			if (end == start)
+				return (count);
+			s = in + (end - start);
+			if (!suppress) {
+				if (lflag)
+					*va_arg(ap, double *) = (double)fnum;
+				else
+					*va_arg(ap, float *) = fnum;
+			}
+			break;
+		case 's':
+			if (!suppress)
+				out = va_arg(ap, char *);
+			while (*s && !isspace(*s) && (!width || s - start < width)) {
+				if (!suppress)
+					*out++ = *s;
+				s++;
+			}
+			if (!suppress)
+				*out = '\0';
+			break;
+		case 'c':
+			if (!width)
+				width = 1;
+			if (!suppress)
+				out = va_arg(ap, char *);
+			for (; width; width--) {
+				if (*s == '\0')
+					return (count ? count : -1);
+				if (!suppress)
+					*out++ = *s;
+				s++;
+			}
+			break;
+		default:
+			// Unsupported conversion
+			return (count);
+		}
+
+		if (!suppress)
+			count++;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Cached formats
+//------------------------------------------------------------------------------
+//
+// The fields hold exactly what kvprintf() would have worked out by the time it
+// gets to a conversion, and print_cache_run() does what kvprintf() does from
+// there, so the output is identical.
+
+/*
+ * Split a format into literal text and fields. Returns 0 if it has anything
+ * that only kvprintf() handles: '*' widths, %b, %D, %n, %r, %y, anything
+ * unknown, or more than PRINT_CACHE_FIELDS fields.
+ */
+static int print_cache_parse(PRINT_CACHE *cache, const char *fmt)
+{
+	PRINT_FIELD *field = cache->fields;
+	const char *literal = fmt;
+	int ch, n, dot;
+
+	cache->count = 0;
+
+	for (;;) {
+		while ((ch = (unsigned char)*fmt) != '%') {
+			if (ch == '\0') {
+				cache->tail = literal;
+				cache->tail_length = fmt - literal;
+				return (1);
+			}
+			fmt++;
+		}
+
+		if (cache->count == PRINT_CACHE_FIELDS || fmt - literal > 0xffff)
+			return (0);
+
+		field->literal = literal;
+		field->literal_length = fmt - literal;
+		field->padc = ' ';
+		field->flags = 0;
+		field->width = 0;
+		field->dwidth = 0;
+		field->length = PRINT_LENGTH_INT;
+		dot = 0;
+		fmt++;
+
+reswitch:	switch (ch = (unsigned char)*fmt++) {
+		case '.':
+			dot = 1;
+			field->flags |= PRINT_FIELD_DOT;
+			goto reswitch;
+		case '#':
+			field->flags |= PRINT_FIELD_SHARP;
+			goto reswitch;
+		case '+':
+			field->flags |= PRINT_FIELD_SIGN;
+			goto reswitch;
+		case '-':
+			field->flags |= PRINT_FIELD_LADJUST;
+			goto reswitch;
+		case '0':
+			if (!dot) {
+				field->padc = '0';
+				goto reswitch;
+			}
+			/* FALLTHROUGH */
+		case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			for (n = 0;; ++fmt) {
+				n = n * 10 + ch - '0';
+				ch = *fmt;
+				if (ch < '0' || ch > '9')
+					break;
+			}
+			if (n > 0x7fff)
+				return (0);
+			if (dot)
+				field->dwidth = n;
+			else
+				field->width = n;
+			goto reswitch;
+		case 'h':
+			field->length = (field->length == PRINT_LENGTH_SHORT) ? PRINT_LENGTH_CHAR : PRINT_LENGTH_SHORT;
+			goto reswitch;
+		case 'l':
+			field->length = (field->length == PRINT_LENGTH_LONG) ? PRINT_LENGTH_LONG_LONG : PRINT_LENGTH_LONG;
+			goto reswitch;
+		case 'q':
+			field->length = PRINT_LENGTH_LONG_LONG;
+			goto reswitch;
+		case 'j':
+		case 't':
+		case 'z':
+			// All 32 bits on SH4, so they're the same as int
+			field->length = PRINT_LENGTH_INT;
+			goto reswitch;
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'o':
+		case 'p':
+		case 's':
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case '%':
+			field->conv = ch;
+			break;
+		default:
+			return (0);
+		}
+
+		if (!field->flags && !field->width && field->length == PRINT_LENGTH_INT && field->padc == ' ')
+			field->flags = PRINT_FIELD_PLAIN;
+
+		literal = fmt;
+		field++;
+		cache->count++;
+	}
+}
+
+/*
+ * Write a format that print_cache_parse() split up, the same way kvprintf()
+ * would.
+ */
+static int print_cache_run(const PRINT_CACHE *cache, void (*func)(int, void*), void *arg, va_list ap)
+{
+#define PCHAR(c) {int cc=(c); if (func) (*func)(cc,arg); else *d++ = cc; retval++; }
+	char nbuf[MAXNBUF];
+	char fbuf[MAXFBUF];
+	const PRINT_FIELD *field = cache->fields;
+	const PRINT_FIELD *last = field + cache->count;
+	const char *p;
+	char *d = func ? NULL : (char *)arg;
+	unsigned int num;
+	unsigned long long qnum;
+	int n, tmp, width, dwidth, ladjust, sharpflag, sign, neg, base, upper;
+	int retval = 0;
+
+	for (; field < last; field++) {
+		if (d) {
+			for (p = field->literal, n = field->literal_length; n--; retval++)
+				*d++ = *p++;
+		} else {
+			for (p = field->literal, n = field->literal_length; n--; p++)
+				PCHAR(*p);
+		}
+
+		// Plain %d, %u, and %s go straight into a buffer, since they're most of them
+		if (d && field->flags == PRINT_FIELD_PLAIN) {
+			if (field->conv == 'd' || field->conv == 'i') {
+				n = DIGITS_S32_To_Dec(va_arg(ap, int), d);
+				d += n;
+				retval += n;
+				continue;
+			}
+			if (field->conv == 'u') {
+				n = DIGITS_U32_To_Dec(va_arg(ap, unsigned int), d);
+				d += n;
+				retval += n;
+				continue;
+			}
+			if (field->conv == 's') {
+				p = va_arg(ap, char *);
+				if (p == NULL)
+					p = "(null)";
+				for (; *p; retval++)
+					*d++ = *p++;
+				continue;
+			}
+		}
+
+		width = field->width;
+		dwidth = field->dwidth;
+		ladjust = field->flags & PRINT_FIELD_LADJUST;
+		sharpflag = field->flags & PRINT_FIELD_SHARP;
+		sign = field->flags & PRINT_FIELD_SIGN;
+		neg = 0;
+		upper = 0;
+
+		switch (field->conv) {
+		case '%':
+			PCHAR('%');
+			continue;
+		case 'c':
+			width -= 1;
+			if (!ladjust && width > 0)
+				while (width--)
+					PCHAR(field->padc);
+			PCHAR(va_arg(ap, int));
+			if (ladjust && width > 0)
+				while (width--)
+					PCHAR(field->padc);
+			continue;
+		case 's':
+			p = va_arg(ap, char *);
+			if (p == NULL)
+				p = "(null)";
+			if (!(field->flags & PRINT_FIELD_DOT))
+				n = strlen(p);
+			else
+				for (n = 0; n < dwidth && p[n]; n++)
+					continue;
+			width -= n;
+			if (!ladjust && width > 0)
+				while (width--)
+					PCHAR(field->padc);
+			while (n--)
+				PCHAR(*p++);
+			if (ladjust && width > 0)
+				while (width--)
+					PCHAR(field->padc);
+			continue;
+		case 'E':
+		case 'F':
+		case 'G':
+			upper = 1;
+			__attribute__ ((fallthrough));
+		case 'e':
+		case 'f':
+		case 'g':
+			n = ksprintf_float(fbuf, (float)va_arg(ap, double), field->conv | 0x20, (field->flags & PRINT_FIELD_DOT) ? dwidth : 6, sharpflag, upper, &neg);
+			tmp = (fbuf[0] > '9') ? ' ' : field->padc; // inf and nan don't get zero padding
+			width -= n + (neg || sign);
+			if (!ladjust && tmp != '0')
+				while (width-- > 0)
+					PCHAR(' ');
+			if (neg)
+				PCHAR('-');
+			if (sign && !neg)
+				PCHAR('+');
+			if (!ladjust && tmp == '0')
+				while (width-- > 0)
+					PCHAR('0');
+			for (p = fbuf; n--; p++)
+				PCHAR(*p);
+			if (ladjust)
+				while (width-- > 0)
+					PCHAR(' ');
+			continue;
+		case 'p':
+			base = 16;
+			sharpflag = (width == 0);
+			sign = 0;
+			num = (uintptr_t)va_arg(ap, void *);
+			p = ksprintn(nbuf, num, base, &n, upper);
+			break;
+		default:
+			// Integers
+			if (field->conv == 'd' || field->conv == 'i') {
+				base = 10;
+				sign = 1;
+			} else {
+				base = (field->conv == 'u') ? 10 : ((field->conv == 'o') ? 8 : 16);
+				upper = (field->conv == 'X');
+				sign = 0;
+			}
+
+			if (field->length == PRINT_LENGTH_LONG_LONG) {
+				qnum = sign ? (unsigned long long)va_arg(ap, long long) : va_arg(ap, unsigned long long);
+				if (sign && (long long)qnum < 0) {
+					neg = 1;
+					qnum = 0 - qnum;
+				}
+				p = ksprintqn(nbuf, qnum, base, &n, upper);
+				num = (qnum != 0); // Only checked for zero from here on
+				break;
+			}
+
+			num = va_arg(ap, unsigned int); // Same as long, size_t, etc. on SH4
+			if (field->length == PRINT_LENGTH_SHORT)
+				num = sign ? (unsigned int)(short)num : (unsigned short)num;
+			else if (field->length == PRINT_LENGTH_CHAR)
+				num = sign ? (unsigned int)(char)num : (unsigned char)num;
+			if (sign && (int)num < 0) {
+				neg = 1;
+				num = 0 - num;
+			}
+			p = ksprintn(nbuf, num, base, &n, upper);
+			break;
+		}
+
+		// Numbers, from kvprintf()'s number: label on
+		tmp = 0;
+		if (sharpflag && num != 0) {
+			if (base == 8)
+				tmp++;
+			else if (base == 16)
+				tmp += 2;
+		}
+		if (neg)
+			tmp++;
+
+		if (!ladjust && field->padc == '0')
+			dwidth = width - tmp;
+		width -= tmp + imax(dwidth, n);
+		dwidth -= n;
+		if (!ladjust)
+			while (width-- > 0)
+				PCHAR(' ');
+		if (neg)
+			PCHAR('-');
+		if (sharpflag && num != 0) {
+			if (base == 8) {
+				PCHAR('0');
+			} else if (base == 16) {
+				PCHAR('0');
+				PCHAR('x');
+			}
+		}
+		while (dwidth-- > 0)
+			PCHAR('0');
+		while (*p)
+			PCHAR(*p++);
+		if (ladjust)
+			while (width-- > 0)
+				PCHAR(' ');
+	}
+
+	if (d) {
+		for (p = cache->tail, n = cache->tail_length; n--; retval++)
+			*d++ = *p++;
+	} else {
+		for (p = cache->tail, n = cache->tail_length; n--; p++)
+			PCHAR(*p);
+	}
+
+	return (retval);
+#undef PCHAR
+}
+
+/*
+ * Parse a format the first time around. Formats that can't be cached are
+ * remembered, too, so they go straight to kvprintf() after that. A different
+ * format gets parsed again, which happens if the macros end up in an inline
+ * function that passes its format through, since every inlined copy shares the
+ * one static cache.
+ */
+static inline int print_cache_ready(PRINT_CACHE *cache, const char *fmt)
+{
+	if (cache->format != fmt) {
+		cache->state = print_cache_parse(cache, fmt) ? PRINT_CACHE_READY : PRINT_CACHE_UNCACHEABLE;
+		cache->format = fmt;
+	}
+
+	return (cache->state == PRINT_CACHE_READY);
+}
+
+int PRINT_Cached_Printf(PRINT_CACHE *cache, const char *fmt, ...)
+{
+	int retval;
+	va_list ap;
+
+	va_start(ap, fmt);
+	if (!print_cache_ready(cache, fmt)) {
+		retval = vprintf(fmt, ap);
+	} else if (print_flush_lines) {
+		retval = print_cache_run(cache, console_putchar, NULL, ap);
+		if (print_console_lines >= print_flush_lines)
+			PRINT_Flush();
+	} else {
+		retval = print_cache_run(cache, NULL, print_buffer, ap);
+		print_buffer[retval] = '\0';
+		dcloadsyscall(DCLOAD_WRITE, 1, print_buffer, retval + 1); // fd = 1 is stdout
+	}
+	va_end(ap);
+
+	return (retval);
+}
+
+int PRINT_Cached_Sprintf(PRINT_CACHE *cache, char *buf, const char *fmt, ...)
+{
+	int retval;
+	va_list ap;
+
+	va_start(ap, fmt);
+	if (print_cache_ready(cache, fmt))
+		retval = print_cache_run(cache, NULL, buf, ap);
+	else
+		retval = kvprintf(fmt, NULL, buf, 10, ap);
+	buf[retval] = '\0';
+	va_end(ap);
+
+	return (retval);
+}
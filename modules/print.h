@@ -10,7 +10,8 @@
 // according to the 3-Clause BSD license below.
 //
 // This module requires the dcload module, but only for printf and vprintf since
-// they write via a dcload syscall.
+// they write via a dcload syscall. Buffered output also needs startup_support.h
+// for its exit hook.
 //
 // --Moopthehedgehog, March 2020
 //
@@ -64,11 +65,18 @@
 //------------------------------------------------------------------------------
 //
 // LIMITATIONS:
-// - No 64-bit data types (e.g. can't print a 64-bit int).
+// - 64-bit ints need the ll (or q) length modifier, e.g. %lld, %llu, or %llx. %j is still 32 bits.
 // - Only bases of 2 (binary), 10 (decimal), 16 (hexadecimal) and 8 (octal) are supported.
 //  You'll get a ? if you try to use anything else. (Full-fat printfs can support bases from 2 to 36)
-// - This printf() and friends can't do floats. Please use float_to_string() to convert floats into
-//  strings.
+// - Floats work with %f, %e, and %g (and %F, %E, %G), and are correctly rounded (half to even).
+//  They're single-precision only, since double is the same as float with -m4-single-only.
+//  Precision is capped at PRINT_FLOAT_MAX_PRECISION digits. The ' ' flag isn't supported.
+// - The '+' flag only does anything for floats. Integers never get a '+'.
+// - None of this needs libgcc: 64-bit decimal conversion divides by 10^9 with a multiply by its
+//  reciprocal, and floats are converted exactly with integer math.
+
+// Most digits after the decimal point that %f, %e, and %g will print
+#define PRINT_FLOAT_MAX_PRECISION 64
 
 // dcload-ip is the limiting factor, with a a max size of 1460 (max packet
 // payload after dcload header). Use 1024 because it's an easy, round 1kB.
@@ -91,4 +99,138 @@ int vsnrprintf(char *str, size_t size, int radix, const char *format, va_list ap
 
 int kvprintf(char const *fmt, void (*func)(int, void*), void *arg, int radix, va_list ap);
 
+//------------------------------------------------------------------------------
+// Buffered console output
+//------------------------------------------------------------------------------
+//
+// Every printf() is normally its own dcload write, which is a full round trip
+// to the host (and a slow one with dcload-serial). PRINT_Set_Buffering() makes
+// printf() and vprintf() collect their output in a larger buffer instead,
+// which is sent in PRINT_PACKET_SIZE writes when:
+// - a set number of newlines have been printed since the last flush,
+// - the buffer is full,
+// - PRINT_Flush() is called, or
+// - the program exits (via an exit hook, see startup_support.h).
+// Buffered output only reaches the host when one of those happens, so flush
+// before doing anything that might crash or hang. sprintf() and friends aren't
+// affected.
+
+// Largest dcload-ip write payload (see PRINT_BUFFER_SIZE above)
+#define PRINT_PACKET_SIZE 1460
+
+// Buffered output is flushed when it reaches this size
+#define PRINT_CONSOLE_BUFFER_SIZE (PRINT_PACKET_SIZE * 4)
+
+// Buffer printf() and vprintf() output, flushing after every 'flush_lines'
+// newlines (e.g. 1 to send whole lines, or 0xffffffff to only flush when the
+// buffer is full). Passing 0 flushes and goes back to one write per call.
+void PRINT_Set_Buffering(unsigned int flush_lines);
+
+// Send everything that's been buffered
+void PRINT_Flush(void);
+
+//------------------------------------------------------------------------------
+// String parsing
+//------------------------------------------------------------------------------
+//
+// LIMITATIONS:
+// - There's no errno. Out-of-range results saturate the way the standard says
+//  they should (ULONG_MAX, LONG_MIN/LONG_MAX, +/-inf or 0 for strtof()), so
+//  check for those if it matters.
+// - strtof() is correctly rounded (round half to even) for any number of
+//  digits, and accepts "inf", "infinity", and "nan" in any case. Hex floats
+//  aren't supported: "0x10" parses as 0 with *endptr pointing at the 'x'.
+// - Base 10 reads 4 digits at a time once the string pointer is word-aligned,
+//  so it may read up to 3 bytes past the last digit, but never past the end of
+//  the aligned word that holds it.
+// - sscanf() supports %d %i %u %o %x %X, %f %e %g %E %G %F %a, %s, %c, %n, and
+//  %%, with field widths, '*' to skip a field, and the hh, h, and l length
+//  modifiers. %lf takes a double *. There's no %[, %p, or %ll. It returns -1 if
+//  the input ends before the first field is converted.
+
+unsigned long strtoul(const char *nptr, char **endptr, int base);
+long strtol(const char *nptr, char **endptr, int base);
+float strtof(const char *nptr, char **endptr);
+
+int sscanf(const char *str, const char *format, ...);
+int vsscanf(const char *str, const char *format, va_list ap);
+
+
+//------------------------------------------------------------------------------
+// Cached formats
+//------------------------------------------------------------------------------
+//
+// kvprintf() works through the whole format string one character at a time on
+// every call. PRINT_PRINTF() and PRINT_SPRINTF() are drop-in replacements for
+// printf() and sprintf() that, when the format is a string literal, give each
+// call site its own PRINT_CACHE. The format is split into literal text and
+// fields the first time that call site runs, and after that each call just
+// copies the text and writes the fields. Formats that aren't constant go
+// straight to printf() or sprintf().
+//
+// Notes:
+// - Output is exactly the same as kvprintf()'s. Plain %d, %i, %u, and %s (no
+//  flags, width, or length modifier) are written straight into the buffer when
+//  there's one, which is most fields in practice.
+// - Arguments are type-checked against the format by GCC's -Wformat, since the
+//  cached functions have a format attribute. printf() itself doesn't, because
+//  uint32_t is unsigned long on sh-elf and existing %u/%x calls would warn.
+// - Formats with a '*' width or precision, %b, %D, %n, %r, %y, an unknown
+//  conversion, or more than PRINT_CACHE_FIELDS fields can't be cached. That's
+//  found out once, too, and those call sites just use kvprintf() from then on.
+// - Parsing isn't locked. If an interrupt handler and the main code hit the
+//  same call site for the first time together, they both parse the same format
+//  into the same fields, which is harmless. A cache that sees a different
+//  format than last time parses it again, so a macro inside an inline function
+//  that's handed its format still works, it just doesn't gain anything if the
+//  formats alternate. Don't do that from an interrupt handler.
+// - Each call site costs a PRINT_CACHE (148 bytes) of .bss.
+// - Measured on an x86-64 host (there's no SH4 number yet), a typical log line
+//  with a few %d, %s, and %x fields takes about half as long as sprintf().
+
+// Most fields a cached format can have
+#define PRINT_CACHE_FIELDS 8
+
+// A field and the literal text before it. Everything kvprintf() would have
+// worked out by the time it got to the conversion character is stored here.
+typedef struct {
+  const char * literal;
+  unsigned short literal_length;
+  short width;
+  short dwidth; // Precision
+  char padc; // ' ' or '0'
+  unsigned char conv; // Conversion character, e.g. 'd'
+  unsigned char flags;
+  unsigned char length;
+} PRINT_FIELD;
+
+// Must start out zeroed, which static storage is
+typedef struct {
+  const char * format; // What the fields were parsed from
+  unsigned int state;
+  unsigned int count; // Number of fields
+  const char * tail; // Literal text after the last field
+  unsigned int tail_length;
+  PRINT_FIELD fields[PRINT_CACHE_FIELDS];
+} PRINT_CACHE;
+
+// The format is always the first macro argument (the second for sprintf).
+#define PRINT_FIRST_ARG(...) PRINT_FIRST_ARG_(__VA_ARGS__, 0)
+#define PRINT_FIRST_ARG_(first, ...) (first)
+
+#define PRINT_PRINTF(...) \
+  (__builtin_constant_p(PRINT_FIRST_ARG(__VA_ARGS__)) ? \
+  __extension__ ({ static PRINT_CACHE print_cache_; PRINT_Cached_Printf(&print_cache_, __VA_ARGS__); }) : \
+  printf(__VA_ARGS__))
+
+#define PRINT_SPRINTF(buf, ...) \
+  (__builtin_constant_p(PRINT_FIRST_ARG(__VA_ARGS__)) ? \
+  __extension__ ({ static PRINT_CACHE print_cache_; PRINT_Cached_Sprintf(&print_cache_, (buf), __VA_ARGS__); }) : \
+  sprintf((buf), __VA_ARGS__))
+
+// What the macros call. 'cache' should be the same for every call with a given
+// 'fmt', and is best not shared between formats (see above).
+int PRINT_Cached_Printf(PRINT_CACHE *cache, const char *fmt, ...) __attribute__((format(__printf__, 2, 3)));
+int PRINT_Cached_Sprintf(PRINT_CACHE *cache, char *buf, const char *fmt, ...) __attribute__((format(__printf__, 3, 4)));
+
 #endif
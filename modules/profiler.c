@@ -0,0 +1,270 @@
+// ---- profiler.c - Sampling Profiler Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module samples the program counter from a timer interrupt to find out
+// where the time goes, and streams the samples to a file on the host over
+// dcload. It is hereby released into the public domain in the hope that it may
+// prove useful.
+//
+
+// See profiler.h for usage notes.
+#include <stddef.h>
+#include "profiler.h"
+#include "irq.h"
+#include "fs_dcload.h"
+#include "startup_support.h"
+
+// TMU channel 2 registers
+#define PROF_TSTR 0xFFD80004  // 8
+#define PROF_TCOR2 0xFFD80020 // 32
+#define PROF_TCNT2 0xFFD80024 // 32
+#define PROF_TCR2 0xFFD80028  // 16
+
+#define PROF_TSTR_STR2 0x04
+
+// TCR: underflow flag, underflow interrupt enable, and peripheral clock / 4
+#define PROF_TCR_UNF 0x0100
+#define PROF_TCR_UNIE 0x0020
+#define PROF_TCR_TPSC_DIV4 0x0000
+
+// Peripheral clock / 4, same as TIMER_TICKS_PER_SECOND
+#define PROF_TICKS_PER_SECOND (99750000 / 2 / 4)
+
+#define PROF_MIN_RATE 100
+#define PROF_MAX_RATE 100000
+
+// Host open() flags as dc-tool expects them (newlib's O_WRONLY | O_CREAT |
+// O_TRUNC), and rw-r--r--
+#define PROF_OPEN_FLAGS (0x0001 | 0x0200 | 0x0400)
+#define PROF_OPEN_MODE 0644
+
+static PROF_SAMPLE_STRUCT prof_default_buffer[PROF_DEFAULT_BUFFER_SAMPLES];
+
+// The ring always keeps one slot empty so that full and empty look different.
+// The handler only writes prof_write_index and the rest of the module only
+// writes prof_read_index, so neither side needs to mask interrupts.
+static PROF_SAMPLE_STRUCT * prof_buffer = prof_default_buffer;
+static uint32_t prof_capacity = PROF_DEFAULT_BUFFER_SAMPLES;
+static volatile uint32_t prof_write_index = 0;
+static volatile uint32_t prof_read_index = 0;
+static volatile uint32_t prof_dropped = 0;
+
+static uint32_t prof_rate = 1000;
+
+// Host file descriptor, or -1 if there's no stream
+static int prof_file = -1;
+// prof_dropped as of the last drop marker written to the stream
+static uint32_t prof_dropped_written = 0;
+
+//------------------------------------------------------------------------------
+// Sampling
+//------------------------------------------------------------------------------
+
+static void prof_tmu2_handler(uint32_t event_code)
+{
+  (void)event_code;
+
+  *(volatile uint16_t*)PROF_TCR2 &= ~PROF_TCR_UNF;
+
+  uint32_t write_index = prof_write_index;
+  uint32_t next_index = write_index + 1;
+  if(next_index == prof_capacity)
+  {
+    next_index = 0;
+  }
+
+  if(next_index == prof_read_index)
+  {
+    prof_dropped++;
+    return;
+  }
+
+  prof_buffer[write_index].pc = IRQ_context.spc;
+  prof_buffer[write_index].pr = IRQ_context.pr;
+  prof_write_index = next_index;
+}
+
+void PROF_Init(void * buffer, uint32_t buffer_bytes, uint32_t samples_per_second, uint32_t priority)
+{
+  PROF_Shutdown();
+
+  if(buffer && (buffer_bytes >= 2 * sizeof(PROF_SAMPLE_STRUCT)))
+  {
+    prof_buffer = (PROF_SAMPLE_STRUCT*)buffer;
+    prof_capacity = buffer_bytes / sizeof(PROF_SAMPLE_STRUCT);
+  }
+  else
+  {
+    prof_buffer = prof_default_buffer;
+    prof_capacity = PROF_DEFAULT_BUFFER_SAMPLES;
+  }
+
+  prof_write_index = 0;
+  prof_read_index = 0;
+  prof_dropped = 0;
+  prof_dropped_written = 0;
+
+  if(samples_per_second < PROF_MIN_RATE)
+  {
+    samples_per_second = PROF_MIN_RATE;
+  }
+  else if(samples_per_second > PROF_MAX_RATE)
+  {
+    samples_per_second = PROF_MAX_RATE;
+  }
+  prof_rate = samples_per_second;
+
+  // Both fit in a float exactly, and there's no integer divide instruction
+  uint32_t period = (uint32_t)(int32_t)((float)PROF_TICKS_PER_SECOND / (float)(int32_t)samples_per_second);
+
+  // The channel underflows after TCOR + 1 counts
+  *(volatile uint32_t*)PROF_TCOR2 = period - 1;
+  *(volatile uint32_t*)PROF_TCNT2 = period - 1;
+  *(volatile uint16_t*)PROF_TCR2 = PROF_TCR_UNIE | PROF_TCR_TPSC_DIV4;
+
+  IRQ_Set_Handler(IRQ_EVENT_TMU2, prof_tmu2_handler);
+  IRQ_Set_Priority(IRQ_SOURCE_TMU2, priority);
+}
+
+void PROF_Start(void)
+{
+  // TSTR is shared with the timer module, which may be using it from its
+  // handlers
+  uint32_t old_level = IRQ_Set_Mask_Level(15);
+  *(volatile uint8_t*)PROF_TSTR |= PROF_TSTR_STR2;
+  IRQ_Set_Mask_Level(old_level);
+}
+
+void PROF_Stop(void)
+{
+  uint32_t old_level = IRQ_Set_Mask_Level(15);
+  *(volatile uint8_t*)PROF_TSTR &= ~PROF_TSTR_STR2;
+  IRQ_Set_Mask_Level(old_level);
+}
+
+void PROF_Shutdown(void)
+{
+  PROF_Stop();
+
+  IRQ_Set_Priority(IRQ_SOURCE_TMU2, 0);
+  IRQ_Set_Handler(IRQ_EVENT_TMU2, NULL);
+
+  *(volatile uint16_t*)PROF_TCR2 = 0;
+}
+
+uint32_t PROF_Get_Dropped(void)
+{
+  return prof_dropped;
+}
+
+//------------------------------------------------------------------------------
+// Reading samples
+//------------------------------------------------------------------------------
+
+uint32_t PROF_Read_Samples(PROF_SAMPLE_STRUCT * samples, uint32_t max_samples)
+{
+  uint32_t read_index = prof_read_index;
+  uint32_t write_index = prof_write_index;
+  uint32_t count = 0;
+
+  while((read_index != write_index) && (count < max_samples))
+  {
+    samples[count] = prof_buffer[read_index];
+    count++;
+
+    read_index++;
+    if(read_index == prof_capacity)
+    {
+      read_index = 0;
+    }
+  }
+
+  // Only give the slots back once they've been copied out
+  prof_read_index = read_index;
+
+  return count;
+}
+
+//------------------------------------------------------------------------------
+// Streaming to the host
+//------------------------------------------------------------------------------
+
+uint32_t PROF_Open_Stream(const char * host_filename)
+{
+  if(STARTUP_dcload_present == DCLOAD_NOT_PRESENT)
+  {
+    return 0;
+  }
+
+  PROF_Close_Stream();
+
+  prof_file = dcloadsyscall(DCLOAD_OPEN, host_filename, PROF_OPEN_FLAGS, PROF_OPEN_MODE);
+  if(prof_file < 0)
+  {
+    prof_file = -1;
+    return 0;
+  }
+
+  uint32_t header[4] = {PROF_FILE_MAGIC, PROF_FILE_VERSION, prof_rate, 0};
+  dcloadsyscall(DCLOAD_WRITE, prof_file, header, sizeof(header));
+
+  // Drops from before the stream was opened aren't part of it
+  prof_dropped_written = prof_dropped;
+
+  return 1;
+}
+
+uint32_t PROF_Flush(void)
+{
+  if(prof_file < 0)
+  {
+    return 0;
+  }
+
+  uint32_t read_index = prof_read_index;
+  uint32_t write_index = prof_write_index;
+  uint32_t count = 0;
+
+  // At most two contiguous runs: to the end of the buffer, then from the start
+  while(read_index != write_index)
+  {
+    uint32_t end_index = (write_index > read_index) ? write_index : prof_capacity;
+    uint32_t run = end_index - read_index;
+
+    dcloadsyscall(DCLOAD_WRITE, prof_file, &prof_buffer[read_index], run * sizeof(PROF_SAMPLE_STRUCT));
+    count += run;
+
+    read_index = (end_index == prof_capacity) ? 0 : end_index;
+    prof_read_index = read_index;
+  }
+
+  // Samples are only dropped while the ring is full, i.e. after everything that
+  // was just written (give or take anything that came in during the writes), so
+  // the marker goes here.
+  uint32_t dropped = prof_dropped;
+  if(dropped != prof_dropped_written)
+  {
+    PROF_SAMPLE_STRUCT marker = {PROF_DROPPED_MARKER, dropped - prof_dropped_written};
+    dcloadsyscall(DCLOAD_WRITE, prof_file, &marker, sizeof(marker));
+    prof_dropped_written = dropped;
+  }
+
+  return count;
+}
+
+void PROF_Close_Stream(void)
+{
+  if(prof_file < 0)
+  {
+    return;
+  }
+
+  PROF_Flush();
+  dcloadsyscall(DCLOAD_CLOSE, prof_file);
+  prof_file = -1;
+}
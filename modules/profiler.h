@@ -0,0 +1,105 @@
+// ---- profiler.h - Sampling Profiler Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module samples the program counter from a timer interrupt to find out
+// where the time goes, and streams the samples to a file on the host over
+// dcload. It is hereby released into the public domain in the hope that it may
+// prove useful.
+//
+
+#ifndef __PROFILER_H_
+#define __PROFILER_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires irq.h (IRQ_Init() must be called first), fs_dcload.h, and
+//  startup_support.h. Uses TMU channel 2, which the timer module leaves alone.
+// - Each TMU2 interrupt records the interrupted PC (SPC) and PR into a ring
+//  buffer. For a function that hasn't called anything yet (e.g. a leaf
+//  function), PR is the return address into its caller, which is what the host
+//  tool uses to build the call graph. Functions that have already made a call
+//  have PR pointing back into themselves, so those samples only count toward
+//  the flat profile.
+// - Interrupt handlers can't be interrupted, so time spent in them never shows
+//  up. Likewise, code that runs with SR.IMASK at or above the profiler's
+//  priority gets its samples pushed to right after it unmasks.
+// - The ring buffer can be anywhere the CPU can write, including OCRAM (e.g.
+//  0x7C001000 for 4kB, or 512 samples, if STARTUP_use_ocram is set). When the
+//  ring is full, new samples are dropped and counted. Call PROF_Flush() often
+//  enough (e.g. once per frame) to keep up.
+// - PROF_Flush() uses dcload's write syscall, so it has to be called from
+//  normal code, not from an interrupt handler.
+// - The host side is tools/profile.py, which reads the sample file along with
+//  program.elf and output.map and prints flat and call-graph profiles.
+//
+// Sample file format (all little endian 32-bit words):
+// - Header: PROF_FILE_MAGIC, PROF_FILE_VERSION, samples per second, 0
+// - Then pairs of (PC, PR). A pair of (PROF_DROPPED_MARKER, count) means
+//  'count' samples were dropped at that point in the stream.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Size of the internal ring buffer (8 bytes per sample), used if PROF_Init()
+// isn't given one
+#define PROF_DEFAULT_BUFFER_SAMPLES 2048
+
+// Interrupt priority for TMU2. It's high so that samples aren't held off by
+// other interrupts any longer than necessary.
+#define PROF_DEFAULT_PRIORITY 14
+
+#define PROF_FILE_MAGIC 0x46504844 // "DHPF"
+#define PROF_FILE_VERSION 1
+#define PROF_DROPPED_MARKER 0xFFFFFFFF
+
+typedef struct {
+  uint32_t pc;
+  uint32_t pr;
+} PROF_SAMPLE_STRUCT;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set up TMU2 to sample 'samples_per_second' times per second (100 to 100000)
+// at the given interrupt priority. 'buffer' is a 4-byte aligned ring buffer of
+// 'buffer_bytes' bytes; pass NULL to use an internal one. Sampling doesn't
+// start until PROF_Start().
+void PROF_Init(void * buffer, uint32_t buffer_bytes, uint32_t samples_per_second, uint32_t priority);
+
+// Start and stop sampling. The ring buffer is kept when stopping.
+void PROF_Start(void);
+void PROF_Stop(void);
+
+// Stop sampling and release TMU2
+void PROF_Shutdown(void);
+
+// Copy up to 'max_samples' of the oldest samples out of the ring buffer.
+// Returns the number copied. Use this instead of the stream functions to
+// process samples on the Dreamcast itself.
+uint32_t PROF_Read_Samples(PROF_SAMPLE_STRUCT * samples, uint32_t max_samples);
+
+// Samples dropped so far because the ring buffer was full
+uint32_t PROF_Get_Dropped(void);
+
+// Create (or overwrite) 'host_filename' on the host through dcload and write
+// the file header. Returns 1 on success, or 0 if dcload isn't present or the
+// file couldn't be opened.
+uint32_t PROF_Open_Stream(const char * host_filename);
+
+// Write everything in the ring buffer to the stream. Returns the number of
+// samples written.
+uint32_t PROF_Flush(void);
+
+// Flush and close the stream
+void PROF_Close_Stream(void);
+
+#endif /* __PROFILER_H_ */
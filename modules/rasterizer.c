@@ -0,0 +1,583 @@
+// ---- rasterizer.c - Software Rasterizer Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module draws flat-colored triangles, rectangles, and lines straight into
+// a framebuffer. It is hereby released into the public domain in the hope that
+// it may prove useful.
+//
+
+// See rasterizer.h for usage notes.
+#include <stddef.h>
+#include "rasterizer.h"
+#include "startup_support.h"
+
+// Default framebuffer address, as set by all of the video mode functions
+#define RAST_DEFAULT_FRAMEBUFFER 0xa5000000
+
+// Subpixel precision of triangle vertices (28.4 fixed point)
+#define RAST_SUBPIXEL_BITS 4
+#define RAST_SUBPIXEL_ONE (1 << RAST_SUBPIXEL_BITS)
+#define RAST_SUBPIXEL_HALF (RAST_SUBPIXEL_ONE >> 1)
+
+// Vertices are clamped to this guard band (in pixels) so the edge function
+// setup can't overflow
+#define RAST_GUARD_BAND 4096.0f
+
+//------------------------------------------------------------------------------
+// Targets and colors
+//------------------------------------------------------------------------------
+
+void RAST_Init_Target_Buffer(RAST_TARGET_STRUCT * target, void * buffer, uint32_t width, uint32_t height, uint32_t color_mode)
+{
+  uint32_t bytes_per_pixel = FB_BYTES_PER_PIXEL(color_mode);
+
+  target->base = (uint8_t*)buffer;
+  target->width = width;
+  target->height = height;
+  target->pitch = width * bytes_per_pixel;
+  target->color_mode = color_mode;
+  target->bytes_per_pixel = bytes_per_pixel;
+
+  // VRAM is physical 0x04000000-0x05FFFFFF, from any of P0-P3
+  uint32_t physical_area = ((uint32_t)(uintptr_t)buffer >> 24) & 0x1f;
+  target->use_sq = (physical_area == 0x04) || (physical_area == 0x05);
+}
+
+void RAST_Init_Target_Video(RAST_TARGET_STRUCT * target, void * framebuffer)
+{
+  if(framebuffer == NULL)
+  {
+    framebuffer = (void*)RAST_DEFAULT_FRAMEBUFFER;
+  }
+
+  RAST_Init_Target_Buffer(target, framebuffer, STARTUP_video_params.fb_width, STARTUP_video_params.fb_height, STARTUP_video_params.video_color_type);
+}
+
+uint32_t RAST_Color(const RAST_TARGET_STRUCT * target, uint32_t r, uint32_t g, uint32_t b)
+{
+  if(target->color_mode == FB_RGB0555)
+  {
+    return RGB0555_TO_16_SCALED(r, g, b);
+  }
+  else if(target->color_mode == FB_RGB565)
+  {
+    return RGB565_TO_16_SCALED(r, g, b);
+  }
+
+  // FB_RGB888 and FB_RGB0888
+  return (r << 16) | (g << 8) | b;
+}
+
+//------------------------------------------------------------------------------
+// Span writer
+//------------------------------------------------------------------------------
+//
+// Every drawing function ends up here. 'dest' must point to the first pixel of
+// the span, and 'count' must be at least 1.
+//
+// VRAM doesn't take 8-bit writes reliably, so 24-bit color is only ever written
+// as whole words, plus STARTUP_VRAM_Write_Bytes() for the partial words at the
+// ends of a span.
+//
+
+// The 4 bytes of a 24-bit fill that start 'phase' (0-2) bytes into a pixel, in
+// memory order (blue first). Each word moves the phase on by 1.
+static inline __attribute__((always_inline)) uint32_t rast_24_word(uint32_t color, uint32_t phase)
+{
+  uint32_t shift = phase << 3;
+  uint32_t rotated = (((color & 0x00ffffff) >> shift) | (color << (24 - shift))) & 0x00ffffff;
+
+  return rotated | (rotated << 24);
+}
+
+static void rast_write_span(const RAST_TARGET_STRUCT * target, uint8_t * dest, uint32_t count, uint32_t color)
+{
+  uint32_t bytes_per_pixel = target->bytes_per_pixel;
+  uint8_t * start = dest;
+  uint8_t * end = dest + count * bytes_per_pixel;
+
+  //
+  // Head: get to a 4-byte boundary
+  //
+
+  if(bytes_per_pixel == 2)
+  {
+    if((uintptr_t)dest & 0x2)
+    {
+      *(uint16_t*)dest = (uint16_t)color;
+      dest += 2;
+    }
+  }
+  else if(bytes_per_pixel == 3)
+  {
+    // The span starts on a pixel boundary, so this is phase 0
+    uint32_t head = (0 - (uint32_t)(uintptr_t)dest) & 0x3;
+    if(head > (uint32_t)(end - dest))
+    {
+      head = (uint32_t)(end - dest);
+    }
+
+    if(head)
+    {
+      STARTUP_VRAM_Write_Bytes(dest, rast_24_word(color, 0), head);
+      dest += head;
+    }
+  }
+
+  //
+  // Body: whole aligned words
+  //
+
+  uint32_t body_words = (uint32_t)(end - dest) >> 2;
+
+  if(body_words)
+  {
+    // The fill pattern repeats every 12 bytes for 24-bit color, so 24 words
+    // covers a whole number of patterns and a whole number of 32-byte blocks.
+    // STARTUP_SQ_Fill() needs 8 more, since 'index' can be anything below 24.
+    uint32_t words[32];
+
+    if(bytes_per_pixel == 3)
+    {
+      uint32_t phase = (uint32_t)(dest - start) % 3;
+
+      for(uint32_t i = 0; i < 32; i++)
+      {
+        words[i] = rast_24_word(color, phase);
+        if(++phase == 3)
+        {
+          phase = 0;
+        }
+      }
+    }
+    else
+    {
+      uint32_t word = (bytes_per_pixel == 2) ? ((color & 0xffff) | (color << 16)) : color;
+      for(uint32_t i = 0; i < 32; i++)
+      {
+        words[i] = word;
+      }
+    }
+
+    uint32_t index = 0;
+
+#ifdef __sh__
+    if(target->use_sq && ((body_words << 2) >= RAST_SQ_MIN_BYTES))
+    {
+      // Words up to the first 32-byte boundary
+      while((uintptr_t)dest & 0x1f)
+      {
+        *(uint32_t*)dest = words[index++];
+        dest += 4;
+        body_words--;
+      }
+
+      uint32_t blocks = body_words >> 3;
+      index = STARTUP_SQ_Fill(dest, blocks, words, index);
+      dest += blocks << 5;
+      body_words &= 0x7;
+    }
+#endif
+
+    while(body_words--)
+    {
+      *(uint32_t*)dest = words[index];
+      dest += 4;
+      if(++index == 24)
+      {
+        index = 0;
+      }
+    }
+  }
+
+  //
+  // Tail: whatever is left
+  //
+
+  if(bytes_per_pixel == 2)
+  {
+    if(dest < end)
+    {
+      *(uint16_t*)dest = (uint16_t)color;
+    }
+  }
+  else if(bytes_per_pixel == 3)
+  {
+    if(dest < end)
+    {
+      STARTUP_VRAM_Write_Bytes(dest, rast_24_word(color, (uint32_t)(dest - start) % 3), (uint32_t)(end - dest));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Spans, rectangles, and lines
+//------------------------------------------------------------------------------
+
+void RAST_Put_Pixel(const RAST_TARGET_STRUCT * target, int32_t x, int32_t y, uint32_t color)
+{
+  if((uint32_t)x >= target->width || (uint32_t)y >= target->height)
+  {
+    return;
+  }
+
+  uint8_t * dest = target->base + (uint32_t)y * target->pitch + (uint32_t)x * target->bytes_per_pixel;
+
+  if(target->bytes_per_pixel == 2)
+  {
+    *(uint16_t*)dest = (uint16_t)color;
+  }
+  else if(target->bytes_per_pixel == 3)
+  {
+    STARTUP_VRAM_Write_Bytes(dest, color, 3);
+  }
+  else
+  {
+    *(uint32_t*)dest = color;
+  }
+}
+
+void RAST_Fill_Span(const RAST_TARGET_STRUCT * target, int32_t x0, int32_t x1, int32_t y, uint32_t color)
+{
+  if((uint32_t)y >= target->height)
+  {
+    return;
+  }
+
+  if(x0 < 0)
+  {
+    x0 = 0;
+  }
+  if(x1 > (int32_t)target->width)
+  {
+    x1 = (int32_t)target->width;
+  }
+  if(x1 <= x0)
+  {
+    return;
+  }
+
+  uint8_t * dest = target->base + (uint32_t)y * target->pitch + (uint32_t)x0 * target->bytes_per_pixel;
+  rast_write_span(target, dest, (uint32_t)(x1 - x0), color);
+}
+
+void RAST_Fill_Rect(const RAST_TARGET_STRUCT * target, int32_t x, int32_t y, int32_t width, int32_t height, uint32_t color)
+{
+  int32_t x1 = x + width;
+  int32_t y1 = y + height;
+
+  if(x < 0)
+  {
+    x = 0;
+  }
+  if(y < 0)
+  {
+    y = 0;
+  }
+  if(x1 > (int32_t)target->width)
+  {
+    x1 = (int32_t)target->width;
+  }
+  if(y1 > (int32_t)target->height)
+  {
+    y1 = (int32_t)target->height;
+  }
+  if((x1 <= x) || (y1 <= y))
+  {
+    return;
+  }
+
+  uint32_t count = (uint32_t)(x1 - x);
+  uint8_t * dest = target->base + (uint32_t)y * target->pitch + (uint32_t)x * target->bytes_per_pixel;
+
+  for(int32_t row = y; row < y1; row++)
+  {
+    rast_write_span(target, dest, count, color);
+    dest += target->pitch;
+  }
+}
+
+void RAST_Clear(const RAST_TARGET_STRUCT * target, uint32_t color)
+{
+  RAST_Fill_Rect(target, 0, 0, (int32_t)target->width, (int32_t)target->height, color);
+}
+
+void RAST_Draw_Line(const RAST_TARGET_STRUCT * target, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+  // Horizontal lines are just spans
+  if(y0 == y1)
+  {
+    if(x1 < x0)
+    {
+      int32_t temp = x0;
+      x0 = x1;
+      x1 = temp;
+    }
+    RAST_Fill_Span(target, x0, x1 + 1, y0, color);
+    return;
+  }
+
+  // Bresenham
+  int32_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+  int32_t dy = (y1 > y0) ? (y0 - y1) : (y1 - y0); // Negative
+  int32_t step_x = (x0 < x1) ? 1 : -1;
+  int32_t step_y = (y0 < y1) ? 1 : -1;
+  int32_t error = dx + dy;
+
+  while(1)
+  {
+    RAST_Put_Pixel(target, x0, y0, color);
+
+    if((x0 == x1) && (y0 == y1))
+    {
+      break;
+    }
+
+    int32_t error2 = error << 1;
+    if(error2 >= dy)
+    {
+      error += dy;
+      x0 += step_x;
+    }
+    if(error2 <= dx)
+    {
+      error += dx;
+      y0 += step_y;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Triangles
+//------------------------------------------------------------------------------
+//
+// Each edge from vertex a to vertex b gets an edge function
+//
+//   E(px, py) = A*px + B*py + C, with A = ya - yb, B = xb - xa, C = xa*yb - xb*ya
+//
+// in 28.4 fixed point, which is positive on the inside of a triangle whose
+// vertices go clockwise on screen (y points down). The products need more than
+// 32 bits, so they're done in 64 bits; the SH4 can do 32x32->64 multiplies in
+// hardware (dmuls.l), and 64-bit adds and compares are cheap.
+//
+// Instead of testing every pixel, each row solves E >= 0 for x with a float
+// estimate that then gets corrected with the exact 64-bit edge function, so each
+// row costs a handful of operations per edge plus the span itself.
+//
+
+typedef struct {
+  int32_t a;
+  int32_t b;
+  int64_t c;
+  // Start vertex and 1/A for the float crossing estimate
+  int32_t xa;
+  int32_t ya;
+  float inv_a;
+} RAST_EDGE_STRUCT;
+
+static inline __attribute__((always_inline)) int32_t rast_snap(float v)
+{
+  if(v > RAST_GUARD_BAND)
+  {
+    v = RAST_GUARD_BAND;
+  }
+  else if(v < -RAST_GUARD_BAND)
+  {
+    v = -RAST_GUARD_BAND;
+  }
+
+  // Round to nearest
+  v *= (float)RAST_SUBPIXEL_ONE;
+  return (v < 0.0f) ? (int32_t)(v - 0.5f) : (int32_t)(v + 0.5f);
+}
+
+static inline __attribute__((always_inline)) void rast_edge_setup(RAST_EDGE_STRUCT * edge, int32_t xa, int32_t ya, int32_t xb, int32_t yb)
+{
+  edge->a = ya - yb;
+  edge->b = xb - xa;
+  edge->c = (int64_t)xa * yb - (int64_t)xb * ya;
+  edge->xa = xa;
+  edge->ya = ya;
+
+  // Top-left rule: pixel centers exactly on a top or left edge are inside, and
+  // ones exactly on a bottom or right edge are outside. Since everything is an
+  // integer, excluding zero is the same as subtracting 1.
+  if(!((edge->a > 0) || ((edge->a == 0) && (edge->b > 0))))
+  {
+    edge->c -= 1;
+  }
+
+  if(edge->a)
+  {
+    edge->inv_a = 1.0f / (float)edge->a;
+  }
+}
+
+// Edge function at the center of pixel x, given the row part 'row' = B*py + C
+static inline __attribute__((always_inline)) int64_t rast_edge_eval(const RAST_EDGE_STRUCT * edge, int64_t row, int32_t x)
+{
+  return (int64_t)edge->a * (x * RAST_SUBPIXEL_ONE + RAST_SUBPIXEL_HALF) + row;
+}
+
+// Narrow [*x_min, *x_max) down to the pixels on the inside of an edge for row py
+static inline __attribute__((always_inline)) void rast_edge_clip_row(const RAST_EDGE_STRUCT * edge, int32_t py, int32_t * x_min, int32_t * x_max)
+{
+  int64_t row = (int64_t)edge->b * py + edge->c;
+
+  if(edge->a == 0)
+  {
+    // Horizontal edge: the whole row is either in or out
+    if(row < 0)
+    {
+      *x_max = *x_min;
+    }
+    return;
+  }
+
+  // Crossing point in pixels, from E = A*(px - xa) + B*(py - ya) = 0. This is
+  // done relative to the start vertex so that it stays in 32-bit range (no
+  // 64-bit to float conversions). It only needs to be close, since it gets
+  // fixed up exactly below.
+  float cross = ((float)edge->xa - (float)edge->b * (float)(py - edge->ya) * edge->inv_a - (float)RAST_SUBPIXEL_HALF) * (1.0f / (float)RAST_SUBPIXEL_ONE);
+  int32_t lo = *x_min;
+  int32_t hi = *x_max;
+  int32_t x;
+
+  if(cross <= (float)lo)
+  {
+    x = lo;
+  }
+  else if(cross >= (float)hi)
+  {
+    x = hi;
+  }
+  else
+  {
+    x = (int32_t)cross;
+  }
+
+  if(edge->a > 0)
+  {
+    // Inside is to the right: find the first x with E >= 0
+    while((x < hi) && (rast_edge_eval(edge, row, x) < 0))
+    {
+      x++;
+    }
+    while((x > lo) && (rast_edge_eval(edge, row, x - 1) >= 0))
+    {
+      x--;
+    }
+    *x_min = x;
+  }
+  else
+  {
+    // Inside is to the left: find the first x with E < 0
+    while((x < hi) && (rast_edge_eval(edge, row, x) >= 0))
+    {
+      x++;
+    }
+    while((x > lo) && (rast_edge_eval(edge, row, x - 1) < 0))
+    {
+      x--;
+    }
+    *x_max = x;
+  }
+}
+
+void RAST_Fill_Triangle(const RAST_TARGET_STRUCT * target, float x0, float y0, float x1, float y1, float x2, float y2, uint32_t color)
+{
+  int32_t fx0 = rast_snap(x0);
+  int32_t fy0 = rast_snap(y0);
+  int32_t fx1 = rast_snap(x1);
+  int32_t fy1 = rast_snap(y1);
+  int32_t fx2 = rast_snap(x2);
+  int32_t fy2 = rast_snap(y2);
+
+  // Twice the signed area, which is also the first edge function at the third
+  // vertex. It's positive when the vertices go clockwise on screen.
+  int64_t area = (int64_t)(fx1 - fx0) * (fy2 - fy0) - (int64_t)(fx2 - fx0) * (fy1 - fy0);
+  if(area == 0)
+  {
+    return;
+  }
+  else if(area < 0)
+  {
+    // Make it clockwise
+    int32_t temp = fx1;
+    fx1 = fx2;
+    fx2 = temp;
+    temp = fy1;
+    fy1 = fy2;
+    fy2 = temp;
+  }
+
+  RAST_EDGE_STRUCT edges[3];
+  rast_edge_setup(&edges[0], fx0, fy0, fx1, fy1);
+  rast_edge_setup(&edges[1], fx1, fy1, fx2, fy2);
+  rast_edge_setup(&edges[2], fx2, fy2, fx0, fy0);
+
+  // Bounding box in whole pixels, clipped to the target. Pixel centers are at
+  // +0.5, so this is conservative.
+  int32_t min_fx = fx0, max_fx = fx0, min_fy = fy0, max_fy = fy0;
+  if(fx1 < min_fx) min_fx = fx1;
+  if(fx2 < min_fx) min_fx = fx2;
+  if(fx1 > max_fx) max_fx = fx1;
+  if(fx2 > max_fx) max_fx = fx2;
+  if(fy1 < min_fy) min_fy = fy1;
+  if(fy2 < min_fy) min_fy = fy2;
+  if(fy1 > max_fy) max_fy = fy1;
+  if(fy2 > max_fy) max_fy = fy2;
+
+  // Arithmetic shifts floor, which is what's wanted for negative coordinates too
+  int32_t box_x0 = min_fx >> RAST_SUBPIXEL_BITS;
+  int32_t box_x1 = (max_fx >> RAST_SUBPIXEL_BITS) + 1;
+  int32_t box_y0 = min_fy >> RAST_SUBPIXEL_BITS;
+  int32_t box_y1 = (max_fy >> RAST_SUBPIXEL_BITS) + 1;
+
+  if(box_x0 < 0)
+  {
+    box_x0 = 0;
+  }
+  if(box_y0 < 0)
+  {
+    box_y0 = 0;
+  }
+  if(box_x1 > (int32_t)target->width)
+  {
+    box_x1 = (int32_t)target->width;
+  }
+  if(box_y1 > (int32_t)target->height)
+  {
+    box_y1 = (int32_t)target->height;
+  }
+  if((box_x1 <= box_x0) || (box_y1 <= box_y0))
+  {
+    return;
+  }
+
+  uint8_t * row_base = target->base + (uint32_t)box_y0 * target->pitch;
+
+  for(int32_t y = box_y0; y < box_y1; y++)
+  {
+    int32_t py = (y << RAST_SUBPIXEL_BITS) + RAST_SUBPIXEL_HALF;
+    int32_t x_min = box_x0;
+    int32_t x_max = box_x1;
+
+    for(uint32_t i = 0; i < 3; i++)
+    {
+      rast_edge_clip_row(&edges[i], py, &x_min, &x_max);
+    }
+
+    if(x_min < x_max)
+    {
+      rast_write_span(target, row_base + (uint32_t)x_min * target->bytes_per_pixel, (uint32_t)(x_max - x_min), color);
+    }
+
+    row_base += target->pitch;
+  }
+}
@@ -0,0 +1,99 @@
+// ---- rasterizer.h - Software Rasterizer Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module draws flat-colored triangles, rectangles, and lines straight into
+// a framebuffer. It is hereby released into the public domain in the hope that
+// it may prove useful.
+//
+
+#ifndef __RASTERIZER_H_
+#define __RASTERIZER_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires startup_support.h for the FB_* color mode definitions,
+//  STARTUP_video_params, and STARTUP_SQ_Fill().
+// - Everything is drawn as horizontal spans. Spans in VRAM are written with
+//  store queue (SQ) bursts: the unaligned head and tail of a span get normal
+//  stores, and everything in between goes out as 32-byte aligned SQ bursts.
+//  Spans shorter than RAST_SQ_MIN_BYTES just use normal stores, since setting
+//  up the SQs isn't worth it for a handful of pixels.
+// - Targets that aren't in VRAM (e.g. a buffer in main RAM) never use the SQs.
+//  When this module is compiled for something other than SH4, the SQ path is
+//  compiled out entirely, so the same drawing code can be run against a host
+//  memory buffer to make golden images for comparison (tests/rasterizer_test.c
+//  checks spans, rectangles, pixels, and triangles this way).
+// - VRAM doesn't take 8-bit writes reliably, so 24-bit color is written as whole
+//  words, with STARTUP_VRAM_Write_Bytes() for the partial words at span ends.
+// - Triangles use the same kind of edge functions as MATH_Is_Point_In_Triangle(),
+//  but evaluated in 28.4 fixed point so that they're exact. Pixel centers are
+//  sampled and the top-left fill rule is used, so triangles that share an edge
+//  never overlap or leave gaps. Either winding order works.
+// - The SQ bursts go through STARTUP_SQ_Fill(), so the notes about QACR0/1 in
+//  startup_support.h apply here too.
+//
+
+//------------------------------------------------------------------------------
+// Render target
+//------------------------------------------------------------------------------
+
+typedef struct {
+  // Address of the top-left pixel
+  uint8_t * base;
+  // Size in pixels
+  uint32_t width;
+  uint32_t height;
+  // Bytes per row
+  uint32_t pitch;
+  // FB_RGB0555, FB_RGB565, FB_RGB888, or FB_RGB0888
+  uint32_t color_mode;
+  uint32_t bytes_per_pixel;
+  // Set if the target is in VRAM (it's set up automatically)
+  uint32_t use_sq;
+} RAST_TARGET_STRUCT;
+
+// Spans need to be at least this long for SQ bursts to be used
+#define RAST_SQ_MIN_BYTES 64
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set up a target for the current video mode, as described by STARTUP_video_params.
+// Pass NULL for 'framebuffer' to use the default framebuffer at 0xa5000000, or
+// pass the address of another framebuffer (e.g. a back buffer) of the same size.
+void RAST_Init_Target_Video(RAST_TARGET_STRUCT * target, void * framebuffer);
+
+// Set up a target for an arbitrary buffer in memory, with rows packed back to back
+void RAST_Init_Target_Buffer(RAST_TARGET_STRUCT * target, void * buffer, uint32_t width, uint32_t height, uint32_t color_mode);
+
+// Convert 8-bit RGB to the target's native pixel format. 16-bit formats are
+// returned in the low 16 bits, and 24-bit is returned as 0x00RRGGBB.
+uint32_t RAST_Color(const RAST_TARGET_STRUCT * target, uint32_t r, uint32_t g, uint32_t b);
+
+// Draw a single pixel (clipped)
+void RAST_Put_Pixel(const RAST_TARGET_STRUCT * target, int32_t x, int32_t y, uint32_t color);
+
+// Fill pixels x0 up to, but not including, x1 on row y (clipped)
+void RAST_Fill_Span(const RAST_TARGET_STRUCT * target, int32_t x0, int32_t x1, int32_t y, uint32_t color);
+
+// Fill a rectangle with its top-left corner at (x, y) (clipped)
+void RAST_Fill_Rect(const RAST_TARGET_STRUCT * target, int32_t x, int32_t y, int32_t width, int32_t height, uint32_t color);
+
+// Fill the whole target
+void RAST_Clear(const RAST_TARGET_STRUCT * target, uint32_t color);
+
+// Draw a 1-pixel line from (x0, y0) to (x1, y1), including both endpoints (clipped)
+void RAST_Draw_Line(const RAST_TARGET_STRUCT * target, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+
+// Fill a triangle (clipped). Vertices are in pixels, and they get snapped to
+// 1/16th of a pixel.
+void RAST_Fill_Triangle(const RAST_TARGET_STRUCT * target, float x0, float y0, float x1, float y1, float x2, float y2, uint32_t color);
+
+#endif /* __RASTERIZER_H_ */
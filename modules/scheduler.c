@@ -0,0 +1,396 @@
+// ---- scheduler.c - Frame Scheduler Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module synchronizes work to the display: it reads the current scanline,
+// waits for vblank, runs callbacks at given scanlines, and keeps track of how
+// much of each frame is left over. It is hereby released into the public domain
+// in the hope that it may prove useful.
+//
+
+// See scheduler.h for usage notes.
+#include <stddef.h>
+#include "scheduler.h"
+#include "startup_support.h"
+
+// Video timing registers (SPG)
+#define SCHED_SPG_HBLANK_INT 0xa05f80c8
+#define SCHED_SPG_VBLANK_INT 0xa05f80cc
+#define SCHED_SPG_LOAD 0xa05f80d8
+#define SCHED_SPG_STATUS 0xa05f810c
+
+// Holly normal interrupt status and level 6 mask (write 1 to a status bit to
+// clear it)
+#define SCHED_SB_ISTNRM 0xa05f6900
+#define SCHED_SB_IML6NRM 0xa05f6910
+
+#define SCHED_INT_VBLANK_IN (1 << 3)
+#define SCHED_INT_HBLANK (1 << 5)
+
+// SPG_HBLANK_INT: bits 0-9 are the line to interrupt on, and bits 12-13 are
+// the mode (0 = only on that line). Bits 16-25 are the horizontal position,
+// which is left alone.
+#define SCHED_HBLANK_INT_POSITION_MASK 0x03ff0000
+
+#define SCHED_LINE_MASK 0x3ff
+
+typedef struct {
+  uint32_t scanline;
+  SCHED_CALLBACK callback;
+  void * data;
+} SCHED_ENTRY_STRUCT;
+
+static uint32_t sched_mode = SCHED_MODE_POLL;
+static uint32_t sched_lines_per_frame = 525;
+static uint32_t sched_vblank_line = 0;
+
+// Callbacks, sorted by scanline
+static SCHED_ENTRY_STRUCT sched_entries[SCHED_MAX_CALLBACKS];
+static uint32_t sched_entry_count = 0;
+// Index of the next callback to run this frame, and the last scanline that
+// callbacks were run for
+static uint32_t sched_next_entry = 0;
+static uint32_t sched_last_line = 0;
+// Line the hblank interrupt is currently set to go off on
+static uint32_t sched_compare_line = 0;
+
+// Vblanks counted by the interrupt handler, and the count as of the end of the
+// last SCHED_Wait_Vblank()
+static volatile uint32_t sched_vblank_count = 0;
+static uint32_t sched_frame_vblank_count = 0;
+// Set by the interrupt handler on every vblank, for IRQ_Sleep_Until()
+static volatile uint32_t sched_vblank_flag = 0;
+
+static SCHED_STATS_STRUCT sched_stats;
+
+//------------------------------------------------------------------------------
+// Display timing
+//------------------------------------------------------------------------------
+
+uint32_t SCHED_Get_Scanline(void)
+{
+  return *(volatile uint32_t*)SCHED_SPG_STATUS & SCHED_LINE_MASK;
+}
+
+uint32_t SCHED_Get_Lines_Per_Frame(void)
+{
+  return sched_lines_per_frame;
+}
+
+uint32_t SCHED_Get_Vblank_Line(void)
+{
+  return sched_vblank_line;
+}
+
+//------------------------------------------------------------------------------
+// Callbacks
+//------------------------------------------------------------------------------
+
+// Run callbacks up to and including 'line'. If 'line' is before the last line
+// that was handled, the display has started a new frame since then, so the
+// rest of the last frame's callbacks get run first (late, but in order).
+static void sched_run_callbacks(uint32_t line)
+{
+  if(line < sched_last_line)
+  {
+    while(sched_next_entry < sched_entry_count)
+    {
+      SCHED_ENTRY_STRUCT * entry = &sched_entries[sched_next_entry++];
+      entry->callback(entry->scanline, entry->data);
+    }
+
+    sched_next_entry = 0;
+  }
+
+  while( (sched_next_entry < sched_entry_count) && (sched_entries[sched_next_entry].scanline <= line) )
+  {
+    SCHED_ENTRY_STRUCT * entry = &sched_entries[sched_next_entry++];
+    entry->callback(entry->scanline, entry->data);
+  }
+
+  sched_last_line = line;
+}
+
+// Point the hblank interrupt at the next callback's scanline (or the first one
+// of the next frame). Returns the line it was set to.
+static uint32_t sched_set_compare_line(void)
+{
+  uint32_t index = (sched_next_entry < sched_entry_count) ? sched_next_entry : 0;
+  uint32_t line = sched_entries[index].scanline;
+
+  uint32_t hblank_int = *(volatile uint32_t*)SCHED_SPG_HBLANK_INT;
+  *(volatile uint32_t*)SCHED_SPG_HBLANK_INT = (hblank_int & SCHED_HBLANK_INT_POSITION_MASK) | line;
+  sched_compare_line = line;
+
+  return line;
+}
+
+// Sync up with the current scanline after the callback list changes: anything
+// at or before it counts as already run for this frame.
+static void sched_resync(void)
+{
+  sched_last_line = SCHED_Get_Scanline();
+  sched_next_entry = 0;
+
+  while( (sched_next_entry < sched_entry_count) && (sched_entries[sched_next_entry].scanline <= sched_last_line) )
+  {
+    sched_next_entry++;
+  }
+
+  if(sched_mode == SCHED_MODE_INTERRUPT)
+  {
+    if(sched_entry_count)
+    {
+      sched_set_compare_line();
+      // Don't let a stale hblank interrupt through
+      *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_HBLANK;
+      *(volatile uint32_t*)SCHED_SB_IML6NRM |= SCHED_INT_HBLANK;
+    }
+    else
+    {
+      *(volatile uint32_t*)SCHED_SB_IML6NRM &= ~SCHED_INT_HBLANK;
+    }
+  }
+}
+
+uint32_t SCHED_Add_Callback(uint32_t scanline, SCHED_CALLBACK callback, void * data)
+{
+  if( (sched_entry_count == SCHED_MAX_CALLBACKS) || (scanline >= sched_lines_per_frame) || (callback == NULL) )
+  {
+    return 0;
+  }
+
+  // Keep the interrupt handler away from the list while it's changing
+  *(volatile uint32_t*)SCHED_SB_IML6NRM &= ~SCHED_INT_HBLANK;
+
+  // Goes after any others on the same scanline
+  uint32_t index = sched_entry_count;
+  while( index && (sched_entries[index - 1].scanline > scanline) )
+  {
+    sched_entries[index] = sched_entries[index - 1];
+    index--;
+  }
+
+  sched_entries[index].scanline = scanline;
+  sched_entries[index].callback = callback;
+  sched_entries[index].data = data;
+  sched_entry_count++;
+
+  sched_resync();
+
+  return 1;
+}
+
+uint32_t SCHED_Remove_Callback(SCHED_CALLBACK callback)
+{
+  *(volatile uint32_t*)SCHED_SB_IML6NRM &= ~SCHED_INT_HBLANK;
+
+  uint32_t kept = 0;
+  for(uint32_t i = 0; i < sched_entry_count; i++)
+  {
+    if(sched_entries[i].callback != callback)
+    {
+      sched_entries[kept++] = sched_entries[i];
+    }
+  }
+
+  uint32_t removed = sched_entry_count - kept;
+  sched_entry_count = kept;
+
+  sched_resync();
+
+  return removed;
+}
+
+void SCHED_Poll(void)
+{
+  if(sched_mode == SCHED_MODE_POLL)
+  {
+    sched_run_callbacks(SCHED_Get_Scanline());
+  }
+}
+
+void SCHED_Handle_Interrupt(void)
+{
+  uint32_t status = *(volatile uint32_t*)SCHED_SB_ISTNRM;
+
+  if(status & SCHED_INT_VBLANK_IN)
+  {
+    *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_VBLANK_IN;
+    sched_vblank_count++;
+    sched_vblank_flag = 1;
+  }
+
+  if(status & SCHED_INT_HBLANK)
+  {
+    *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_HBLANK;
+
+    if(sched_entry_count)
+    {
+      // The interrupt went off on the compare line, whatever SPG_STATUS says
+      // about exactly where in the line the display is by now
+      sched_run_callbacks(sched_compare_line);
+
+      // If the callbacks took long enough that the display is already at or
+      // past the next one's scanline, run it now instead of a frame late
+      for(;;)
+      {
+        uint32_t line = sched_set_compare_line();
+        uint32_t current = SCHED_Get_Scanline();
+
+        if( (sched_next_entry == sched_entry_count) || (current < line) || (current < sched_last_line) )
+        {
+          break;
+        }
+
+        sched_run_callbacks(current);
+      }
+    }
+  }
+}
+
+#if SCHED_USE_IRQ
+static void sched_irq_handler(uint32_t event_code)
+{
+  (void)event_code;
+
+  SCHED_Handle_Interrupt();
+}
+
+IRQ_HANDLER SCHED_Set_IRQ_Handler(void)
+{
+  return IRQ_Set_Handler(IRQ_EVENT_IRL(6), sched_irq_handler);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Frames
+//------------------------------------------------------------------------------
+
+void SCHED_Reset_Stats(void)
+{
+  sched_stats.frames = 0;
+  sched_stats.missed_frames = 0;
+  sched_stats.headroom_lines = 0;
+  sched_stats.min_headroom_lines = sched_lines_per_frame;
+  sched_stats.headroom = 0.0f;
+}
+
+const SCHED_STATS_STRUCT * SCHED_Get_Stats(void)
+{
+  return &sched_stats;
+}
+
+void SCHED_Init(uint32_t mode)
+{
+  SCHED_Shutdown();
+
+  sched_mode = mode;
+
+  // SPG_LOAD holds (lines per frame - 1) in bits 16-25, and SPG_VBLANK_INT
+  // holds the vblank-in line in bits 0-9
+  sched_lines_per_frame = (((*(volatile uint32_t*)SCHED_SPG_LOAD) >> 16) & SCHED_LINE_MASK) + 1;
+  sched_vblank_line = (*(volatile uint32_t*)SCHED_SPG_VBLANK_INT) & SCHED_LINE_MASK;
+
+  SCHED_Reset_Stats();
+
+  // Start off with no vblank pending, so the first frame doesn't look late
+  *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_VBLANK_IN | SCHED_INT_HBLANK;
+  sched_frame_vblank_count = sched_vblank_count;
+
+  if(mode == SCHED_MODE_INTERRUPT)
+  {
+    *(volatile uint32_t*)SCHED_SB_IML6NRM |= SCHED_INT_VBLANK_IN;
+  }
+
+  sched_resync();
+}
+
+void SCHED_Shutdown(void)
+{
+  *(volatile uint32_t*)SCHED_SB_IML6NRM &= ~(SCHED_INT_VBLANK_IN | SCHED_INT_HBLANK);
+  *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_VBLANK_IN | SCHED_INT_HBLANK;
+}
+
+void SCHED_Wait_Vblank(void)
+{
+  uint32_t line = SCHED_Get_Scanline();
+  uint32_t missed;
+
+  if(sched_mode == SCHED_MODE_INTERRUPT)
+  {
+    // Every vblank counted since the last wait is a frame that got missed
+    missed = sched_vblank_count - sched_frame_vblank_count;
+  }
+  else
+  {
+    // The status bit only says that at least one vblank went by
+    missed = ((*(volatile uint32_t*)SCHED_SB_ISTNRM) & SCHED_INT_VBLANK_IN) ? 1 : 0;
+  }
+
+  if(missed)
+  {
+    sched_stats.missed_frames += missed;
+    sched_stats.headroom_lines = 0;
+    sched_stats.min_headroom_lines = 0;
+    sched_stats.headroom = 0.0f;
+  }
+  else
+  {
+    uint32_t headroom_lines = (line < sched_vblank_line) ? (sched_vblank_line - line) : (sched_vblank_line + sched_lines_per_frame - line);
+
+    sched_stats.headroom_lines = headroom_lines;
+    if(headroom_lines < sched_stats.min_headroom_lines)
+    {
+      sched_stats.min_headroom_lines = headroom_lines;
+    }
+    sched_stats.headroom = (float)(int32_t)headroom_lines / (float)(int32_t)sched_lines_per_frame;
+  }
+
+  sched_stats.frames++;
+
+  if(sched_mode == SCHED_MODE_INTERRUPT)
+  {
+    // Missed frames are counted, so wait for the next vblank after now
+    sched_frame_vblank_count = sched_vblank_count;
+
+#if SCHED_USE_IRQ
+    // There's no separate way to read SR.IMASK, so set it and put it right back
+    uint32_t mask_level = IRQ_Set_Mask_Level(15);
+    IRQ_Set_Mask_Level(mask_level);
+
+    if(mask_level < 6)
+    {
+      // Clearing the flag first means a vblank that comes in right here still
+      // shows up in the count
+      sched_vblank_flag = 0;
+      if(sched_vblank_count == sched_frame_vblank_count)
+      {
+        IRQ_Sleep_Until(&sched_vblank_flag);
+      }
+
+      sched_frame_vblank_count = sched_vblank_count;
+      return;
+    }
+#endif
+  }
+  else
+  {
+    // Keep callbacks going until the end of the frame
+    *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_VBLANK_IN;
+    while(sched_entry_count && !((*(volatile uint32_t*)SCHED_SB_ISTNRM) & SCHED_INT_VBLANK_IN))
+    {
+      sched_run_callbacks(SCHED_Get_Scanline());
+    }
+  }
+
+  // Vsync comes after vblank-in, so the vblank-in status bit for this frame is
+  // set by the time this returns. Clear it, so that in interrupt mode it
+  // doesn't get counted later as a missed frame if level 6 gets unmasked.
+  STARTUP_Wait_Vblank();
+  *(volatile uint32_t*)SCHED_SB_ISTNRM = SCHED_INT_VBLANK_IN;
+}
@@ -0,0 +1,147 @@
+// ---- scheduler.h - Frame Scheduler Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module synchronizes work to the display: it reads the current scanline,
+// waits for vblank, runs callbacks at given scanlines, and keeps track of how
+// much of each frame is left over. It is hereby released into the public domain
+// in the hope that it may prove useful.
+//
+
+#ifndef __SCHEDULER_H_
+#define __SCHEDULER_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires startup_support.h, and irq.h (with irq.c linked in) unless
+//  SCHED_USE_IRQ is set to 0 below.
+// - Call SCHED_Init() after setting the video mode. The number of lines per
+//  frame and the vblank line are read straight from the video hardware (SPG),
+//  so this works with any mode set up by startup_support.c, including the extra
+//  modes and generated timings.
+// - Scanlines are counted the way the video hardware counts them: 0 is the top
+//  of the frame (in the vertical blanking area), active video is somewhere in
+//  the middle, and vblank starts on the vblank line returned by
+//  SCHED_Get_Vblank_Line(). A frame runs from one vblank to the next.
+// - Frame timing comes from the vblank-in status bit in Holly's interrupt status
+//  register (SB_ISTNRM). The bit latches even when the interrupt is masked, so
+//  if it's already set when waiting for vblank, the frame ran late.
+// - There are two modes:
+//  - SCHED_MODE_POLL: nothing is done in the background. Scanline callbacks
+//   run whenever SCHED_Poll() is called (so call it often, e.g. between chunks
+//   of work). SCHED_Wait_Vblank() keeps running them until vblank-in and then
+//   waits with STARTUP_Wait_Vblank(), so it returns at the start of vertical
+//   sync (a few lines after vblank-in), same as STARTUP_Vblank_Flip().
+//  - SCHED_MODE_INTERRUPT: the vblank-in and hblank interrupts are enabled
+//   on Holly's level 6 interrupt (IRL 6, INTEVT 0x320), and the hblank
+//   interrupt's line compare is moved from one callback's scanline to the next,
+//   so callbacks run right on their scanlines. SCHED_Handle_Interrupt() must be
+//   called from the level 6 interrupt handler, and SR.IMASK must let level 6
+//   through. SCHED_Set_IRQ_Handler() sets that up with irq.h. The handler
+//   counts vblanks, which is how missed frames are found, and
+//   SCHED_Wait_Vblank() sleeps until it counts the next one. If SR.IMASK masks
+//   level 6 when waiting, or SCHED_USE_IRQ is 0, SCHED_Wait_Vblank() polls
+//   with STARTUP_Wait_Vblank() instead.
+// - Headroom is how many scanlines were left before vblank when
+//  SCHED_Wait_Vblank() was called, i.e. how much of the frame went unused.
+//  Frames that weren't done by vblank count as missed and have no headroom.
+// - Callbacks in interrupt mode run in the interrupt handler, so keep them
+//  short. Multiple callbacks on the same scanline run in the order they were
+//  added.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Modes
+#define SCHED_MODE_POLL 0
+#define SCHED_MODE_INTERRUPT 1
+
+// Max number of scanline callbacks
+#define SCHED_MAX_CALLBACKS 16
+
+// Set to 0 to build without irq.c. SCHED_Set_IRQ_Handler() then doesn't exist,
+// and interrupt mode waits for vblank by polling.
+#ifndef SCHED_USE_IRQ
+#define SCHED_USE_IRQ 1
+#endif
+
+#if SCHED_USE_IRQ
+#include "irq.h"
+#endif
+
+// Scanline callbacks get the scanline they were scheduled for and the 'data'
+// pointer they were added with.
+typedef void (*SCHED_CALLBACK)(uint32_t scanline, void * data);
+
+typedef struct {
+  // Number of vblanks waited for with SCHED_Wait_Vblank()
+  uint32_t frames;
+  // Frames that weren't done by vblank
+  uint32_t missed_frames;
+  // Scanlines to spare in the last frame, and the fewest since the stats were reset
+  uint32_t headroom_lines;
+  uint32_t min_headroom_lines;
+  // Headroom of the last frame as a fraction of the whole frame (0.0f - 1.0f)
+  float headroom;
+} SCHED_STATS_STRUCT;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set up the scheduler for the current video mode in the given mode. Any
+// callbacks that were added are kept.
+void SCHED_Init(uint32_t mode);
+
+// Disable the scheduler's interrupts (if they were enabled)
+void SCHED_Shutdown(void);
+
+// Current scanline
+uint32_t SCHED_Get_Scanline(void);
+
+// Total number of scanlines per frame, including blanking
+uint32_t SCHED_Get_Lines_Per_Frame(void);
+
+// Scanline on which vblank starts
+uint32_t SCHED_Get_Vblank_Line(void);
+
+// Wait for the start of the next vblank and update the frame stats.
+void SCHED_Wait_Vblank(void);
+
+// Run 'callback' every frame when the display reaches 'scanline'.
+// Returns 1 on success, or 0 if the scanline is out of range or there are
+// already SCHED_MAX_CALLBACKS callbacks.
+uint32_t SCHED_Add_Callback(uint32_t scanline, SCHED_CALLBACK callback, void * data);
+
+// Remove every occurrence of 'callback'. Returns how many were removed.
+uint32_t SCHED_Remove_Callback(SCHED_CALLBACK callback);
+
+// Poll mode only: run any callbacks whose scanline has been reached since the
+// last call.
+void SCHED_Poll(void);
+
+// Interrupt mode only: call this from the level 6 (INTEVT 0x320) interrupt
+// handler. It acknowledges the vblank-in and hblank interrupts.
+void SCHED_Handle_Interrupt(void);
+
+#if SCHED_USE_IRQ
+// Interrupt mode only: make SCHED_Handle_Interrupt() the irq.h handler for
+// IRQ_EVENT_IRL(6). IRQ_Init() must have been called. Returns the handler that
+// was there before, which can be put back with IRQ_Set_Handler() after
+// SCHED_Shutdown(). Use SCHED_Handle_Interrupt() from a handler of your own
+// instead if other level 6 interrupts need handling too.
+IRQ_HANDLER SCHED_Set_IRQ_Handler(void);
+#endif
+
+// Frame stats since SCHED_Init() or the last reset
+const SCHED_STATS_STRUCT * SCHED_Get_Stats(void);
+void SCHED_Reset_Stats(void);
+
+#endif /* __SCHEDULER_H_ */
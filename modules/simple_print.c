@@ -1,6 +1,6 @@
 // ---- simple_print.c - Simple Print Module ----
 //
-// Version 1.0.0
+// Version 1.1.0
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -14,12 +14,7 @@
 
 #include "simple_print.h"
 #include "memfuncs.h"
-
-// Enable the rounding mode of float_to_string(). On by default because it helps
-// to hide its inaccuracy a little bit.
-#define FLOAT_ROUNDING
-
-const char * dec_hex_data = "0123456789abcdef";
+#include "digits.h"
 
 // This does the same thing as strlen, but is made specially for this file so
 // that it is standalone.
@@ -42,19 +37,12 @@ static int stringlength(char* string)
 // Returns pointer to out_string.
 char * hex_to_string(unsigned int in_number, char* out_string)
 {
-	int i;
-
-	out_string[0] = '0';
-	out_string[1] = 'x';
+  out_string[0] = '0';
+  out_string[1] = 'x';
 
+  DIGITS_U32_To_Hex(in_number, 0, &(out_string[2]));
   out_string[10] = '\0'; // Null term
 
-	for(i = 9; i >= 2; i--)
-	{
-		out_string[i] = dec_hex_data[in_number & 0x0f];
-		in_number >>= 4;
-	}
-
   return out_string;
 }
 
@@ -65,23 +53,7 @@ char * hex_to_string(unsigned int in_number, char* out_string)
 // Returns pointer to out_string.
 char * uint_to_string(unsigned int in_number, char* out_string)
 {
-	int i;
-
-  out_string[10] = '\0'; // Null term
-
-	for(i = 9; i >= 0; i--)
-	{
-		if((!in_number) && (i < 9))
-		{
-      memmove(out_string, &(out_string[i + 1]), 11-i); // realign string with beginning
-      return out_string;
-		}
-		else
-		{
-			out_string[i] = dec_hex_data[in_number % 10];
-		}
-		in_number /= 10;
-	}
+  DIGITS_U32_To_Dec(in_number, out_string);
 
   return out_string;
 }
@@ -93,247 +65,272 @@ char * uint_to_string(unsigned int in_number, char* out_string)
 // Returns pointer to out_string.
 char * int_to_string(int in_number, char* out_string)
 {
-	int i;
-	int need_neg = 0;
-  int neg = 0;
-
-  out_string[11] = '\0'; // Null term
-
-	if(in_number < 0)
-	{
-		need_neg = 1;
-    neg = 1;
-	}
-
-	// 10 digits for the number, plus one char for the potential (-) sign
-	for(i = 10; i >= 0; i--)
-	{
-		if(need_neg && (!in_number) && (i < 10))
-		{
-			out_string[i] = '-';
-			need_neg = 0;
-		}
-		else if((!in_number) && (i < 10))
-		{
-      memmove(out_string, &(out_string[i + 1]), 12-i); // realign string with beginning
-			return out_string;
-		}
-		else
-		{
-      if(neg)
-      {
-        out_string[i] = dec_hex_data[-(in_number % 10)]; // mod of negative number is still negative
-      }
-      else
-      {
-        out_string[i] = dec_hex_data[in_number % 10];
-      }
-		}
-		in_number /= 10;
-	}
+  DIGITS_S32_To_Dec(in_number, out_string);
 
   return out_string;
 }
 
-// WARNING: This is not super accurate. The printed value may be too small by up to 0.002.
-//
-// This function converts a single-precision mantissa to string, specifically
-// for the case of SH4, which cannot do 64-bit integer division easily (would
-// take over 128 instructions)... and really struggles with 32-bit integer
-// division (would take over 64 instructions). This is despite the fact that it
-// can do both single- and double-precision floating-point division, however.
-// But IMO using the FPU to do this defeats the purpose, as that would dump
-// the floating point registers to memory and reload them every time. That would
-// be worse for performance than this insanity already is.
+// float_to_string() is Ulf Adams' Ryu (https://github.com/ulfjack/ryu, and the
+// paper "Ryu: Fast Float-to-String Conversion", PLDI 2018) cut down to single
+// precision. It finds the shortest decimal number that still rounds to the same
+// float, without any big number math or division, only multiplies by a table of
+// powers of 5.
 //
-// Thankfully, GCC is smart enough to be able to do 32-bit division by a constant
-// without dividing (by making good use of multiplies and shifts), which is great
-// otherwise I'd have to write things like x/100000 as (x*2814749768) >> 48.
+// The float variant only ever needs (32-bit x 64-bit) >> shift, which is two
+// 32x32->64-bit multiplies (dmulu.l), and its divides are all by constants,
+// which GCC turns into multiplies. So no libgcc, and no FPU either, since the
+// float is only ever looked at as bits.
 //
-// Some resources that I think would be helpful in understanding what I did here:
-// - Really great paper on everything there is to know about floats:
-//  http://www.validlab.com/goldberg/paper.pdf
-// - Here's an answer on stack overflow that I think does a good job demonstrating
-//  the idea of manipulating a float using its constituent parts:
-//  https://stackoverflow.com/questions/20302904/converting-int-to-float-or-float-to-int-using-bitwise-operations-software-float
-// - An online calculator that converts IEEE-754 to hex, binary, and decimal (and back):
-//  https://www.h-schmidt.net/FloatConverter/IEEE754.html
-// - It also helps to know how to handle binary and hexadecimal fractions.
-//
-// Even though this isn't perfect, at least I give you base-10 digits and didn't
-// just leave it at 1.hexdigits x2^power, although, wouldn't that have been fun? :P
-// (It technically would be more accurate than decimals to print the raw mantissa as hex...)
-// Returns pointer to out_string.
-static char * mantissa_to_string(unsigned int mantissa, unsigned int decimal_point_digits, unsigned char * exponent_add, char* out_string)
+
+// Bits of precision in each table entry
+#define FLOAT_POW5_INV_BITS 59
+#define FLOAT_POW5_BITS 61
+
+// Entry q is 2^(FLOAT_POW5_INV_BITS - 1 + bits in 5^q) / 5^q, rounded up.
+// Floats need up to q = 30.
+static const uint64_t float_pow5_inv[31] = {
+  0x0800000000000001ULL, 0x0666666666666667ULL, 0x051eb851eb851eb9ULL,
+  0x04189374bc6a7efaULL, 0x068db8bac710cb2aULL, 0x053e2d6238da3c22ULL,
+  0x0431bde82d7b634eULL, 0x06b5fca6af2bd216ULL, 0x055e63b88c230e78ULL,
+  0x044b82fa09b5a52dULL, 0x06df37f675ef6eaeULL, 0x057f5ff85e592558ULL,
+  0x0465e6604b7a8447ULL, 0x0709709a125da071ULL, 0x05a126e1a84ae6c1ULL,
+  0x0480ebe7b9d58567ULL, 0x0734aca5f6226f0bULL, 0x05c3bd5191b525a3ULL,
+  0x049c97747490eae9ULL, 0x0760f253edb4ab0eULL, 0x05e72843249088d8ULL,
+  0x04b8ed0283a6d3e0ULL, 0x078e480405d7b966ULL, 0x060b6cd004ac9452ULL,
+  0x04d5f0a66a23a9dbULL, 0x07bcb43d769f762bULL, 0x063090312bb2c4efULL,
+  0x04f3a68dbc8f03f3ULL, 0x07ec3daf94180651ULL, 0x065697bfa9acd1daULL,
+  0x051212ffbaf0a7e2ULL
+};
+
+// Entry i is 5^i, shifted so that its top bit is bit FLOAT_POW5_BITS - 1.
+// Floats need up to i = 47.
+static const uint64_t float_pow5[48] = {
+  0x1000000000000000ULL, 0x1400000000000000ULL, 0x1900000000000000ULL,
+  0x1f40000000000000ULL, 0x1388000000000000ULL, 0x186a000000000000ULL,
+  0x1e84800000000000ULL, 0x1312d00000000000ULL, 0x17d7840000000000ULL,
+  0x1dcd650000000000ULL, 0x12a05f2000000000ULL, 0x174876e800000000ULL,
+  0x1d1a94a200000000ULL, 0x12309ce540000000ULL, 0x16bcc41e90000000ULL,
+  0x1c6bf52634000000ULL, 0x11c37937e0800000ULL, 0x16345785d8a00000ULL,
+  0x1bc16d674ec80000ULL, 0x1158e460913d0000ULL, 0x15af1d78b58c4000ULL,
+  0x1b1ae4d6e2ef5000ULL, 0x10f0cf064dd59200ULL, 0x152d02c7e14af680ULL,
+  0x1a784379d99db420ULL, 0x108b2a2c28029094ULL, 0x14adf4b7320334b9ULL,
+  0x19d971e4fe8401e7ULL, 0x1027e72f1f128130ULL, 0x1431e0fae6d7217cULL,
+  0x193e5939a08ce9dbULL, 0x1f8def8808b02452ULL, 0x13b8b5b5056e16b3ULL,
+  0x18a6e32246c99c60ULL, 0x1ed09bead87c0378ULL, 0x13426172c74d822bULL,
+  0x1812f9cf7920e2b6ULL, 0x1e17b84357691b64ULL, 0x12ced32a16a1b11eULL,
+  0x178287f49c4a1d66ULL, 0x1d6329f1c35ca4bfULL, 0x125dfa371a19e6f7ULL,
+  0x16f578c4e0a060b5ULL, 0x1cb2d6f618c878e3ULL, 0x11efc659cf7d4b8dULL,
+  0x166bb7f0435c9e71ULL, 0x1c06a5ec5433c60dULL, 0x118427b3b4a05bc8ULL
+};
+
+// Number of bits in 5^e, i.e. floor(e * log2(5)) + 1
+static inline int pow5_bits(int e)
 {
-	int j;
-	int shifter = 22;
-	// A 64-bit int can't hold 10^23. Only up to 1.84x10^19... so 10^18 is our cutoff.
-	// This means the printed value will be off by up to 31/8388608...
-
-  // ...Well, at least it would be if I had been able to figure out a way to do 64-bit
-  // integer division on SH4. It's definitely doable with double-precision divides,
-  // but those divides are like 30 cycles each and thus *very* slow. It would be possible
-  // to do this whole thing with floats, actually, but the issue there is that, in order to
-  // print one float, this function would need to dump many floats to memory and then
-  // reload them all (same with doubles). That could cause some major issues when paired
-  // with sh4_math.h. NOTE: GCC CAN do 64-bit integer divides, but it calls special math
-  // functions to do it, which by themselves take up a solid few kB. I'm trying to avoid
-  // overhead and dependencies like that. And, actually, it seems to do the same for 32-bit
-  // division, probably to avoid using div1 over and over again in a loop.
-
-  // A 32-bit int is all we get then, and 32-bit only holds up to 4.29x10^9... so 10^8 is
-  // our actual cutoff. The printed value may be too small by up to 0.002.
-
-  unsigned int temp_output = 0;
-  unsigned int fivecount = 5;
-  int int_cutoff = 8;
-  int digit_bound = decimal_point_digits - 1;
-
-  out_string[decimal_point_digits] = '\0'; // Null term
-
-  if(!decimal_point_digits)
-  {
-    out_string[0] = '\0';
-    return out_string;
-  }
+  return (int)(((unsigned int)e * 1217359U) >> 19) + 1;
+}
 
-  if(!mantissa)
-  {
-    for(j = digit_bound; j >= 0; j--)
-    {
-      out_string[j] = '0'; // all zeroes
-    }
+// floor(e * log10(2))
+static inline int log10_pow2(int e)
+{
+  return (int)(((unsigned int)e * 78913U) >> 18);
+}
 
-    return out_string;
+// floor(e * log10(5))
+static inline int log10_pow5(int e)
+{
+  return (int)(((unsigned int)e * 732923U) >> 20);
+}
+
+// How many times 5 divides 'value' (which must not be 0)
+static inline unsigned int pow5_factor(unsigned int value)
+{
+  unsigned int count = 0;
+
+  while(!(value % 5U))
+  {
+    value /= 5U;
+    count++;
   }
 
-	while(shifter >= (22 - int_cutoff)) // Need to stop at 10^18 (4, i.e. 19 iterations) for 64-bit, 10^8 (14, i.e. 9 iterations) for 32-bit...
-	{
-		if((mantissa >> shifter) & 0x1)
-		{
-			// first bit is 0.5 (1/2), second is 0.25 (1/4), third is 0.125 (1/8)...
-			// last is 0.11920928955078125 × 10^-6 (1/2^23 = 1/8388608)
-			// So start with 5, multiply it by 10, add 25, mult by 10, add 125... to get the decimal points
-			temp_output += fivecount;
-		}
-
-    if(shifter == (22 - int_cutoff))
-    {
-      // prevent overflow
-      break;
-    }
-    fivecount *= 5;
-    temp_output *= 10;
-		shifter--;
-	}
+  return count;
+}
 
-  // Ensure exponent_add is in a known state
-  exponent_add[0] = 0;
+// (m * factor) >> shift, where the result fits in 32 bits. 'shift' is always
+// 33 to 63 for floats, so the last step only needs 32-bit shifts, too.
+static inline unsigned int mul_shift(unsigned int m, uint64_t factor, int shift)
+{
+  uint64_t low = (uint64_t)m * (uint32_t)factor;
+  uint64_t high = (uint64_t)m * (uint32_t)(factor >> 32);
+  uint64_t sum = (low >> 32) + high;
 
-  // Gotta hardcode all these divides so that GCC can figure out a way to avoid division.
-  // Saves me having to write out multiply-and-shift magic numbers.
+  shift -= 32;
 
-  // I *know* there are gonna be people who will bug me about it if there's no rounding.
-  // ...I'm probably also gonna get people who bug me that 3 digits isn't enough.
-#ifndef FLOAT_ROUNDING
+  return ((uint32_t)sum >> shift) | ((uint32_t)(sum >> 32) << (32 - shift));
+}
 
-  // Leave just the decimals we want
-  if(decimal_point_digits == 1)
+// Shortest decimal digits of a nonzero, finite float's magnitude, which is
+// returned as an integer that gets multiplied by 10^exponent_10. This follows
+// f2s.c in the Ryu repository; the names are the ones the paper uses.
+static unsigned int float_to_decimal(unsigned int ieee_mantissa, unsigned int ieee_exponent, int * exponent_10)
+{
+  int e2;
+  unsigned int m2;
+
+  if(ieee_exponent)
   {
-    temp_output /= 100000000U; // 10^8
+    e2 = (int)ieee_exponent - 127 - 23 - 2;
+    m2 = ieee_mantissa | (1U << 23);
   }
-  else if(decimal_point_digits == 2)
+  else // denormal
   {
-    temp_output /= 10000000U; // 10^7
+    e2 = 1 - 127 - 23 - 2;
+    m2 = ieee_mantissa;
   }
-  else if(decimal_point_digits == 3)
+
+  // Round to even: a number exactly halfway to a neighbor reads back as this
+  // float only if its mantissa is even.
+  int accept_bounds = !(m2 & 1);
+
+  // The number and its halfway points to the floats below and above, times 4.
+  // The lower gap is half as big at a power of 2.
+  unsigned int mv = 4 * m2;
+  unsigned int mp = 4 * m2 + 2;
+  unsigned int mm_shift = (ieee_mantissa != 0) || (ieee_exponent <= 1);
+  unsigned int mm = 4 * m2 - 1 - mm_shift;
+
+  // Same three in decimal, without their lowest digits
+  unsigned int vr, vp, vm;
+  int e10;
+  int vm_is_trailing_zeros = 0;
+  int vr_is_trailing_zeros = 0;
+  unsigned int last_removed_digit = 0;
+
+  if(e2 >= 0)
   {
-    temp_output /= 1000000U; // 10^6
-  }
+    int q = log10_pow2(e2);
+    int k = FLOAT_POW5_INV_BITS + pow5_bits(q) - 1;
+    int i = -e2 + q + k;
 
-#else
+    e10 = q;
+    vr = mul_shift(mv, float_pow5_inv[q], i);
+    vp = mul_shift(mp, float_pow5_inv[q], i);
+    vm = mul_shift(mm, float_pow5_inv[q], i);
 
-  // Need to divide temp_output by the power of ten that will give rightmost desired digit
-  // But if we stop one short we can do rounding.
-  if(decimal_point_digits == 1)
-  {
-    temp_output /= 10000000U; // 10^7
-  }
-  else if(decimal_point_digits == 2)
-  {
-    temp_output /= 1000000U; // 10^6
+    if(q && ((vp - 1) / 10U <= vm / 10U))
+    {
+      // One more digit than that is needed to round, in case the loop below
+      // doesn't run at all
+      int l = FLOAT_POW5_INV_BITS + pow5_bits(q - 1) - 1;
+      last_removed_digit = mul_shift(mv, float_pow5_inv[q - 1], -e2 + q - 1 + l) % 10U;
+    }
+
+    if(q <= 9)
+    {
+      // Only one of mp, mv, and mm can be a multiple of 5, if any
+      if(!(mv % 5U))
+      {
+        vr_is_trailing_zeros = (pow5_factor(mv) >= (unsigned int)q);
+      }
+      else if(accept_bounds)
+      {
+        vm_is_trailing_zeros = (pow5_factor(mm) >= (unsigned int)q);
+      }
+      else
+      {
+        vp -= (pow5_factor(mp) >= (unsigned int)q);
+      }
+    }
   }
-  else if(decimal_point_digits == 3)
+  else
   {
-    temp_output /= 100000U; // 10^5
-  }
+    int q = log10_pow5(-e2);
+    int i = -e2 - q;
+    int k = pow5_bits(i) - FLOAT_POW5_BITS;
+    int j = q - k;
 
-  // Round away from zero, like in normal math (at least, that's what my TI-84 does)
-  unsigned int round_check = temp_output % 10U;
-  if(round_check >= 5U)
-  {
-    temp_output += 10U - round_check;
+    e10 = q + e2;
+    vr = mul_shift(mv, float_pow5[i], j);
+    vp = mul_shift(mp, float_pow5[i], j);
+    vm = mul_shift(mm, float_pow5[i], j);
 
-    // Quick, silly integer power of 10
-    unsigned int tenpow = 10U;
-    for(unsigned int sillypow = 0; sillypow < decimal_point_digits; sillypow++)
+    if(q && ((vp - 1) / 10U <= vm / 10U))
     {
-      tenpow *= 10U;
-    } // It's 100 for 1 digit, 1000 for 2 digits, 10000 for 3 digits
+      j = q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITS);
+      last_removed_digit = mul_shift(mv, float_pow5[i + 1], j) % 10U;
+    }
 
-    if(temp_output == tenpow)
+    if(q <= 1)
     {
-      exponent_add[0] = 1;
+      // mv has at least 2 trailing zero bits, so it's always a multiple of 2^q
+      vr_is_trailing_zeros = 1;
 
-      for(j = digit_bound; j >= 0; j--)
+      if(accept_bounds)
       {
-        out_string[j] = '0'; // all zeroes
+        vm_is_trailing_zeros = (mm_shift == 1);
       }
-
-      return out_string;
+      else
+      {
+        vp--;
+      }
+    }
+    else if(q < 31)
+    {
+      vr_is_trailing_zeros = !(mv & ((1U << (q - 1)) - 1));
     }
   }
 
-  // Alright, time to get rid of that rounding term
-  temp_output /= 10U;
-#endif
+  // Drop digits for as long as vm and vp still differ
+  int removed = 0;
 
-  // Finally, convert mantissa to string, and I never want to have to work with
-  // floats in their raw bit format ever again.
-	for(j = digit_bound; j >= 0; j--)
-	{
-		if((!temp_output) && (j < digit_bound))
-		{
-      out_string[j] = '0'; // leading zeroes
-		}
-		else
-		{
-			out_string[j] = dec_hex_data[temp_output % 10U];
-		}
-		temp_output /= 10U;
-	}
+  if(vm_is_trailing_zeros || vr_is_trailing_zeros)
+  {
+    // Rare: the exact halfway points matter
+    while(vp / 10U > vm / 10U)
+    {
+      vm_is_trailing_zeros &= !(vm % 10U);
+      vr_is_trailing_zeros &= !last_removed_digit;
+      last_removed_digit = vr % 10U;
+      vr /= 10U;
+      vp /= 10U;
+      vm /= 10U;
+      removed++;
+    }
 
-  return out_string;
-}
+    if(vm_is_trailing_zeros)
+    {
+      while(!(vm % 10U))
+      {
+        vr_is_trailing_zeros &= !last_removed_digit;
+        last_removed_digit = vr % 10U;
+        vr /= 10U;
+        vp /= 10U;
+        vm /= 10U;
+        removed++;
+      }
+    }
 
-// Return 1 if NaN, 0 if not -- just like __builtin_isnan is supposed to do.
-// But apparently __builtin_isnan() doesn't use fcmp/eq, which can check for NaNs,
-// and instead uses software FP emulation...
-static int compare_isnan(float input)
-{
-  int output;
-
-  asm volatile (
-    "fcmp/eq %[in_f], %[in_f]\n\t" // If it's != to itself, it's a NaN
-    "mov #-1, %[out]\n\t" // Don't have movrt, so this is the next best thing.
-    "negc %[out], %[out]\n" // This is given as an example in the negc instruction description, too.
-  : [out] "=r" (output) // outputs
-  : [in_f] "f" (input) // inputs
-  : "t" // clobbers
-  );
-
-  return output;
+    if(vr_is_trailing_zeros && (last_removed_digit == 5) && !(vr & 1))
+    {
+      // Exactly halfway, so round to even
+      last_removed_digit = 4;
+    }
+
+    *exponent_10 = e10 + removed;
+    return vr + (((vr == vm) && (!accept_bounds || !vm_is_trailing_zeros)) || (last_removed_digit >= 5));
+  }
+
+  // Common case
+  while(vp / 10U > vm / 10U)
+  {
+    last_removed_digit = vr % 10U;
+    vr /= 10U;
+    vp /= 10U;
+    vm /= 10U;
+    removed++;
+  }
+
+  *exponent_10 = e10 + removed;
+  return vr + ((vr == vm) || (last_removed_digit >= 5));
 }
 
 typedef struct __attribute__((packed)) {
@@ -342,130 +339,133 @@ typedef struct __attribute__((packed)) {
 	unsigned int sign : 1;
 } FLOAT_FORMAT_STRUCT;
 
-static char temp_buffer_exp[12] = {0};
-static char temp_buffer_mant[4 + 7] = {0}; // Needs to hold "1." and "x2^" in addition to sign + null
-
-// Convert float to string (will be in 1.23456x2^789 format instead of the more familiar 1.23456x10^789)
+// Convert float to the shortest string that reads back as the same float
 // 'out_string' buffer is assumed to be large enough.
-// decimal_point_digits is # of digits displayed after the decimal (min 1, max 3)
-// output buffer size is 11 + decimal_point_digits (meaning min buffer is 12, max 14)
+// Requires a 16-byte output buffer for the string (e.g. -0.000123456789).
+// Uses %g's layout: plain decimal for 1e-4 <= |x| < 1e9, otherwise 1.2345e+12.
 // Single-precision only
 // Returns pointer to out_string.
-char * float_to_string(float in_float, unsigned int decimal_point_digits, char* out_string)
+char * float_to_string(float in_float, char* out_string)
 {
-	int denormal = 0;
-	FLOAT_FORMAT_STRUCT float_struct = *(FLOAT_FORMAT_STRUCT*)&in_float;
-  unsigned char exponent_add_1 = 0;
-
-  // For some reason GCC's builtins use software FP emulation. Very strange,
-  // considering the SH4 has hardware support for IEEE-754.
-
-//	if(in_float != in_float) // Check for NaN
-  if(compare_isnan(in_float))
+  // A union instead of a pointer cast keeps GCC's strict aliasing happy
+  union {
+    float value;
+    FLOAT_FORMAT_STRUCT bits;
+  } float_union = {.value = in_float};
+  FLOAT_FORMAT_STRUCT float_struct = float_union.bits;
+  char * out = out_string;
+
+	if(float_struct.exponent == 0xff)
 	{
-		out_string[0] = 'N';
-	 	out_string[1] = 'a';
-		out_string[2] = 'N';
-		out_string[3] = '\0';
-		return out_string;
-	}
-	else if(in_float == 0.0f) // Check for 0
-	{
-		out_string[0] = '0';
-		out_string[1] = '.';
-		out_string[2] = '0';
-		out_string[3] = '\0';
-		return out_string;
-	}
-	else if(float_struct.sign && (float_struct.exponent == 0xff)) // Check for -Inf
-//	else if(__builtin_isinf_sign(in_float) == -1) // Check for -Inf
-	{
-		out_string[0] = '-';
-		out_string[1] = 'I';
-		out_string[2] = 'n';
-		out_string[3] = 'f';
-		out_string[4] = '\0';
-		return out_string;
-	}
-	else if(float_struct.exponent == 0xff) // Check for Inf
-//	else if(__builtin_isinf_sign(in_float) == 1) // Check for Inf
-	{
-		out_string[0] = 'I';
-		out_string[1] = 'n';
-		out_string[2] = 'f';
-		out_string[3] = '\0';
+    if(float_struct.mantissa) // Check for NaN
+    {
+      out[0] = 'N';
+      out[1] = 'a';
+      out[2] = 'N';
+      out[3] = '\0';
+      return out_string;
+    }
+
+    // Inf or -Inf
+    if(float_struct.sign)
+    {
+      *out++ = '-';
+    }
+		out[0] = 'I';
+		out[1] = 'n';
+		out[2] = 'f';
+		out[3] = '\0';
 		return out_string;
 	}
-	else if(float_struct.exponent == 0) // check for denormals
-	{
-		denormal = 1;
+
+  if(float_struct.sign)
+  {
+    *out++ = '-';
   }
 
-	// get mantissa
-	if(float_struct.sign)
+	if((!float_struct.exponent) && (!float_struct.mantissa)) // Check for 0
 	{
-		// in_float *= -1; // We know it's negative, so we can now make it positive to make life easier
-		// Actually, we don't need to do that. That operation just flips the sign bit.
-		// (floats are sign-magnitude)
-		mantissa_to_string(float_struct.mantissa, decimal_point_digits, &exponent_add_1, &(temp_buffer_mant[3]));
-
-    // If rounding causes a denormal to overflow, it becomes 1.x
-    if( denormal && (!(exponent_add_1)) )
-		{
-			temp_buffer_mant[0] = '-';
-			temp_buffer_mant[1] = '0';
-			temp_buffer_mant[2] = '.';
-		}
-		else
-		{
-			temp_buffer_mant[0] = '-';
-			temp_buffer_mant[1] = '1';
-			temp_buffer_mant[2] = '.';
-		}
-	}
-	else
-	{
-		mantissa_to_string(float_struct.mantissa, decimal_point_digits, &exponent_add_1, &(temp_buffer_mant[2]));
-
-    // If rounding causes a denormal to overflow, it becomes 1.x
-		if( denormal && (!(exponent_add_1)) )
-		{
-      temp_buffer_mant[0] = '0';
-			temp_buffer_mant[1] = '.';
-		}
-		else
-		{
-			temp_buffer_mant[0] = '1';
-			temp_buffer_mant[1] = '.';
-		}
+		out[0] = '0';
+		out[1] = '\0';
+		return out_string;
 	}
 
-  // append power-of-2 notation to coefficient
-	unsigned int mantlen = stringlength(temp_buffer_mant);
-	temp_buffer_mant[mantlen++] = 'x';
-	temp_buffer_mant[mantlen++] = '2';
-	temp_buffer_mant[mantlen++] = '^';
-	temp_buffer_mant[mantlen] = '\0';
+  int exponent_10;
+  char digits[DIGITS_U32_DEC_SIZE];
+  int length = (int)DIGITS_U32_To_Dec(float_to_decimal(float_struct.mantissa, float_struct.exponent, &exponent_10), digits);
+
+  // Power of 10 of the first digit
+  int magnitude = exponent_10 + length - 1;
+  int i;
+
+  if((magnitude < -4) || (magnitude >= 9))
+  {
+    // d.ddde+xx
+    *out++ = digits[0];
+    if(length > 1)
+    {
+      *out++ = '.';
+      for(i = 1; i < length; i++)
+      {
+        *out++ = digits[i];
+      }
+    }
+
+    *out++ = 'e';
+    if(magnitude < 0)
+    {
+      *out++ = '-';
+      magnitude = -magnitude;
+    }
+    else
+    {
+      *out++ = '+';
+    }
+
+    // At least 2 exponent digits, like printf
+    if(magnitude < 10)
+    {
+      *out++ = '0';
+    }
+    DIGITS_U32_To_Dec((unsigned int)magnitude, out);
+
+    return out_string;
+  }
 
-  // denormals use the minimum possible exponent + 1
-  // if rounding make the answer bigger we need to account for that, too
-  if(denormal)
+  if(magnitude < 0)
   {
-    temp_buffer_exp[0] = '-';
-    temp_buffer_exp[1] = '1';
-    temp_buffer_exp[2] = '2';
-    temp_buffer_exp[3] = '6';
-    temp_buffer_exp[4] = '\0';
+    // 0.000ddd
+    *out++ = '0';
+    *out++ = '.';
+    for(i = -1; i > magnitude; i--)
+    {
+      *out++ = '0';
+    }
+    for(i = 0; i < length; i++)
+    {
+      *out++ = digits[i];
+    }
   }
   else
   {
-    // get exponent
-    // don't forget to subtract bias (underflow OK)
-    int_to_string(((unsigned char)float_struct.exponent - 127 + exponent_add_1), temp_buffer_exp);
+    // ddd.ddd or ddd000
+    for(i = 0; i < length; i++)
+    {
+      if(i == magnitude + 1)
+      {
+        *out++ = '.';
+      }
+      *out++ = digits[i];
+    }
+    for(i = length; i <= magnitude; i++)
+    {
+      *out++ = '0';
+    }
   }
 
-  // sign is 1, mantissa max is 3 digits, exponent is 4 (sign + 3), "1." + "x2^" + null term is 6
-	return append_string(temp_buffer_mant, temp_buffer_exp, out_string);
+  *out = '\0';
+
+  return out_string;
 }
 
 // Append string 2 to string 1 (both must be null-terminated) and put the combined output into out_string
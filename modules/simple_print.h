@@ -1,6 +1,6 @@
 // ---- simple_print.h - Simple Print Module Header ----
 //
-// Version 1.0.0
+// Version 1.1.0
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -39,15 +39,15 @@ char * uint_to_string(unsigned int in_number, char *out_string);
 // Returns pointer to out_string.
 char * int_to_string(int in_number, char *out_string);
 
-// Convert float to string (will be in 1.23456x2^789 format instead of the more familiar 1.23456x10^789)
+// Convert float to the shortest string that reads back as the same float
 // 'out_string' buffer is assumed to be large enough.
-// decimal_point_digits is # of digits displayed after the decimal (min 1, max 3)
-// output buffer size is 11 + decimal_point_digits (meaning min buffer is 12, max 14)
+// Requires a 16-byte output buffer for the string (e.g. -0.000123456789).
+// Uses %g's layout: plain decimal for 1e-4 <= |x| < 1e9, otherwise 1.2345e+12.
+// Ties between equally short strings go to the one closest to the float's exact
+// value. NaN is "NaN", infinities are "Inf" and "-Inf", and zero is "0" or "-0".
 // Single-precision only
 // Returns pointer to out_string.
-//
-// WARNING: This is not super accurate. The printed value may be too small by up to 0.002.
-char * float_to_string(float in_float, unsigned int decimal_point_digits, char * out_string);
+char * float_to_string(float in_float, char * out_string);
 
 // Append string 2 to string 1 (both must be null-terminated) and put the combined output into out_string
 // 'out_string' buffer is assumed to be large enough.
@@ -0,0 +1,385 @@
+// ---- timer.c - TMU Timer Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module uses the SH4's timer unit (TMU) for a 64-bit monotonic clock,
+// one-shot and periodic timer callbacks, and microsecond delays. It is hereby
+// released into the public domain in the hope that it may prove useful.
+//
+
+// See timer.h for usage notes.
+#include <stddef.h>
+#include "timer.h"
+#include "irq.h"
+
+// TMU registers
+#define TIMER_TOCR 0xFFD80000  // 8
+#define TIMER_TSTR 0xFFD80004  // 8
+#define TIMER_TCOR0 0xFFD80008 // 32
+#define TIMER_TCNT0 0xFFD8000C // 32
+#define TIMER_TCR0 0xFFD80010  // 16
+#define TIMER_TCOR1 0xFFD80014 // 32
+#define TIMER_TCNT1 0xFFD80018 // 32
+#define TIMER_TCR1 0xFFD8001C  // 16
+
+// TSTR start bits
+#define TIMER_TSTR_STR0 0x01
+#define TIMER_TSTR_STR1 0x02
+
+// TCR: underflow flag, underflow interrupt enable, and peripheral clock / 4
+#define TIMER_TCR_UNF 0x0100
+#define TIMER_TCR_UNIE 0x0020
+#define TIMER_TCR_TPSC_DIV4 0x0000
+
+// Tick conversions, as multiply-and-shift so there's no 64-bit division:
+// 2^32 / 12.46875 ticks per microsecond, and 2^40 / 12468.75 ticks per
+// millisecond. Both are accurate to a few parts per billion.
+#define TIMER_US_PER_TICK_X2_32 344458530
+#define TIMER_MS_PER_TICK_X2_40 88181384
+
+// 12.46875 ticks per microsecond is 399 / 32
+#define TIMER_TICKS_PER_US_NUMERATOR 399
+#define TIMER_TICKS_PER_US_SHIFT 5
+
+typedef struct {
+  // Next deadline in ticks, or 0 if the slot is free
+  uint64_t deadline;
+  // Ticks between calls, or 0 for one-shot timers
+  uint64_t period;
+  TIMER_CALLBACK callback;
+  void * data;
+} TIMER_ENTRY_STRUCT;
+
+// Upper 32 bits of the clock
+static volatile uint32_t timer_high = 0;
+
+static TIMER_ENTRY_STRUCT timer_entries[TIMER_MAX_TIMERS];
+static uint32_t timer_priority = TIMER_DEFAULT_PRIORITY;
+
+//------------------------------------------------------------------------------
+// Clock
+//------------------------------------------------------------------------------
+
+static void timer_tmu0_handler(uint32_t event_code)
+{
+  (void)event_code;
+
+  *(volatile uint16_t*)TIMER_TCR0 &= ~TIMER_TCR_UNF;
+  timer_high++;
+}
+
+uint64_t TIMER_Get_Ticks(void)
+{
+  uint32_t high;
+  uint32_t count;
+
+  for(;;)
+  {
+    high = timer_high;
+    count = *(volatile uint32_t*)TIMER_TCNT0;
+
+    if((*(volatile uint16_t*)TIMER_TCR0) & TIMER_TCR_UNF)
+    {
+      // Underflowed, but the handler hasn't counted it yet (interrupts are
+      // masked, or it's about to run). Read the count again so it's known to be
+      // from after the underflow.
+      count = *(volatile uint32_t*)TIMER_TCNT0;
+      high++;
+
+      if(timer_high == high - 1)
+      {
+        break;
+      }
+    }
+    else if(timer_high == high)
+    {
+      break;
+    }
+  }
+
+  // The channel counts down from 0xFFFFFFFF
+  return ((uint64_t)high << 32) | (0xFFFFFFFF - count);
+}
+
+// Scale ticks by 'multiplier' / 2^'shift' (shift >= 32) without a 64x64-bit
+// multiply. Always inlined so that the shifts are constant.
+static inline __attribute__((always_inline)) uint64_t timer_scale(uint64_t ticks, uint32_t multiplier, uint32_t shift)
+{
+  uint32_t high = (uint32_t)(ticks >> 32);
+  uint32_t low = (uint32_t)ticks;
+
+  return (((uint64_t)high * multiplier) >> (shift - 32)) + (((uint64_t)low * multiplier) >> shift);
+}
+
+uint64_t TIMER_Ticks_To_Microseconds(uint64_t ticks)
+{
+  return timer_scale(ticks, TIMER_US_PER_TICK_X2_32, 32);
+}
+
+uint64_t TIMER_Get_Microseconds(void)
+{
+  return timer_scale(TIMER_Get_Ticks(), TIMER_US_PER_TICK_X2_32, 32);
+}
+
+uint64_t TIMER_Get_Milliseconds(void)
+{
+  return timer_scale(TIMER_Get_Ticks(), TIMER_MS_PER_TICK_X2_40, 40);
+}
+
+uint64_t TIMER_Microseconds_To_Ticks(uint32_t microseconds)
+{
+  // Round up so that waits are never short
+  return ((uint64_t)microseconds * TIMER_TICKS_PER_US_NUMERATOR + ((1 << TIMER_TICKS_PER_US_SHIFT) - 1)) >> TIMER_TICKS_PER_US_SHIFT;
+}
+
+//------------------------------------------------------------------------------
+// Timers
+//------------------------------------------------------------------------------
+
+// Set TMU1 to go off at the earliest deadline, after running anything that's
+// already due. Must be called with interrupts masked (or from the handler).
+static void timer_run_and_reschedule(void)
+{
+  for(;;)
+  {
+    uint64_t now = TIMER_Get_Ticks();
+    uint64_t earliest = 0;
+
+    for(uint32_t i = 0; i < TIMER_MAX_TIMERS; i++)
+    {
+      TIMER_ENTRY_STRUCT * entry = &timer_entries[i];
+
+      if(entry->deadline && (entry->deadline <= now))
+      {
+        TIMER_CALLBACK callback = entry->callback;
+        void * data = entry->data;
+
+        if(entry->period)
+        {
+          entry->deadline += entry->period;
+          // Skip any periods that were missed entirely
+          while(entry->deadline <= now)
+          {
+            entry->deadline += entry->period;
+          }
+        }
+        else
+        {
+          entry->deadline = 0;
+        }
+
+        callback(i + 1, data);
+      }
+
+      // The callback may have changed this entry
+      if(entry->deadline && ((!earliest) || (entry->deadline < earliest)))
+      {
+        earliest = entry->deadline;
+      }
+    }
+
+    *(volatile uint8_t*)TIMER_TSTR &= ~TIMER_TSTR_STR1;
+
+    if(!earliest)
+    {
+      // Nothing left to wait for
+      return;
+    }
+
+    now = TIMER_Get_Ticks();
+    if(earliest <= now)
+    {
+      // Something came due while the callbacks ran
+      continue;
+    }
+
+    uint64_t delta = earliest - now;
+    if(delta > 0xFFFFFFFF)
+    {
+      // Too far away for one countdown, so just check back later
+      delta = 0xFFFFFFFF;
+    }
+
+    *(volatile uint32_t*)TIMER_TCNT1 = (uint32_t)delta;
+    *(volatile uint16_t*)TIMER_TCR1 &= ~TIMER_TCR_UNF;
+    *(volatile uint8_t*)TIMER_TSTR |= TIMER_TSTR_STR1;
+    return;
+  }
+}
+
+static void timer_tmu1_handler(uint32_t event_code)
+{
+  (void)event_code;
+
+  *(volatile uint16_t*)TIMER_TCR1 &= ~TIMER_TCR_UNF;
+  timer_run_and_reschedule();
+}
+
+static uint32_t timer_start(uint32_t microseconds, uint64_t period, TIMER_CALLBACK callback, void * data)
+{
+  if(callback == NULL)
+  {
+    return 0;
+  }
+
+  uint32_t old_level = IRQ_Set_Mask_Level(15);
+  uint32_t timer_id = 0;
+
+  for(uint32_t i = 0; i < TIMER_MAX_TIMERS; i++)
+  {
+    if(!timer_entries[i].deadline)
+    {
+      TIMER_ENTRY_STRUCT * entry = &timer_entries[i];
+
+      // A deadline of 0 marks a free slot, so it can't be used here
+      entry->deadline = TIMER_Get_Ticks() + TIMER_Microseconds_To_Ticks(microseconds);
+      if(!entry->deadline)
+      {
+        entry->deadline = 1;
+      }
+      entry->period = period;
+      entry->callback = callback;
+      entry->data = data;
+
+      timer_id = i + 1;
+      timer_run_and_reschedule();
+      break;
+    }
+  }
+
+  IRQ_Set_Mask_Level(old_level);
+
+  return timer_id;
+}
+
+uint32_t TIMER_Start_Oneshot(uint32_t microseconds, TIMER_CALLBACK callback, void * data)
+{
+  return timer_start(microseconds, 0, callback, data);
+}
+
+uint32_t TIMER_Start_Periodic(uint32_t microseconds, TIMER_CALLBACK callback, void * data)
+{
+  if(!microseconds)
+  {
+    microseconds = 1;
+  }
+
+  return timer_start(microseconds, TIMER_Microseconds_To_Ticks(microseconds), callback, data);
+}
+
+uint32_t TIMER_Cancel(uint32_t timer_id)
+{
+  if( (!timer_id) || (timer_id > TIMER_MAX_TIMERS) )
+  {
+    return 0;
+  }
+
+  uint32_t old_level = IRQ_Set_Mask_Level(15);
+
+  TIMER_ENTRY_STRUCT * entry = &timer_entries[timer_id - 1];
+  uint32_t was_running = (entry->deadline != 0);
+  entry->deadline = 0;
+
+  IRQ_Set_Mask_Level(old_level);
+
+  // TMU1 is left as it is; if it was waiting for this timer, it'll just find
+  // nothing to do when it goes off.
+  return was_running;
+}
+
+//------------------------------------------------------------------------------
+// Delays
+//------------------------------------------------------------------------------
+
+void TIMER_Spin_Microseconds(uint32_t microseconds)
+{
+  uint64_t ticks = TIMER_Microseconds_To_Ticks(microseconds);
+  uint32_t wait = (ticks > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)ticks;
+
+  // Only the low 32 bits are needed, and differences work across underflows
+  uint32_t start = *(volatile uint32_t*)TIMER_TCNT0;
+  while((uint32_t)(start - *(volatile uint32_t*)TIMER_TCNT0) < wait);
+}
+
+static void timer_wake(uint32_t timer_id, void * data)
+{
+  (void)timer_id;
+
+  *(volatile uint32_t*)data = 1;
+}
+
+void TIMER_Sleep_Microseconds(uint32_t microseconds)
+{
+  // Sleeping with the TMU interrupts masked would never wake up. There's no
+  // separate way to read SR.IMASK, so set it and put it right back.
+  uint32_t mask_level = IRQ_Set_Mask_Level(15);
+  IRQ_Set_Mask_Level(mask_level);
+
+  volatile uint32_t done = 0;
+
+  if( (mask_level >= timer_priority) || (!TIMER_Start_Oneshot(microseconds, timer_wake, (void*)&done)) )
+  {
+    TIMER_Spin_Microseconds(microseconds);
+    return;
+  }
+
+  // Any interrupt wakes the CPU up, so this goes back to sleep until it's this
+  // one. The timer can go off before the CPU gets to sleep; IRQ_Sleep_Until()
+  // makes sure that doesn't sleep forever.
+  IRQ_Sleep_Until(&done);
+}
+
+//------------------------------------------------------------------------------
+// Setup
+//------------------------------------------------------------------------------
+
+void TIMER_Init(uint32_t priority)
+{
+  TIMER_Shutdown();
+
+  timer_priority = priority;
+  timer_high = 0;
+
+  // Internal clock, no external TCLK
+  *(volatile uint8_t*)TIMER_TOCR = 0;
+
+  // Channel 0: free-running from 0xFFFFFFFF
+  *(volatile uint32_t*)TIMER_TCOR0 = 0xFFFFFFFF;
+  *(volatile uint32_t*)TIMER_TCNT0 = 0xFFFFFFFF;
+  *(volatile uint16_t*)TIMER_TCR0 = TIMER_TCR_UNIE | TIMER_TCR_TPSC_DIV4;
+
+  // Channel 1: loaded for each deadline. It reloads to the max after an
+  // underflow, in case it doesn't get reloaded.
+  *(volatile uint32_t*)TIMER_TCOR1 = 0xFFFFFFFF;
+  *(volatile uint32_t*)TIMER_TCNT1 = 0xFFFFFFFF;
+  *(volatile uint16_t*)TIMER_TCR1 = TIMER_TCR_UNIE | TIMER_TCR_TPSC_DIV4;
+
+  IRQ_Set_Handler(IRQ_EVENT_TMU0, timer_tmu0_handler);
+  IRQ_Set_Handler(IRQ_EVENT_TMU1, timer_tmu1_handler);
+  IRQ_Set_Priority(IRQ_SOURCE_TMU0, priority);
+  IRQ_Set_Priority(IRQ_SOURCE_TMU1, priority);
+
+  *(volatile uint8_t*)TIMER_TSTR |= TIMER_TSTR_STR0;
+}
+
+void TIMER_Shutdown(void)
+{
+  *(volatile uint8_t*)TIMER_TSTR &= ~(TIMER_TSTR_STR0 | TIMER_TSTR_STR1);
+
+  IRQ_Set_Priority(IRQ_SOURCE_TMU0, 0);
+  IRQ_Set_Priority(IRQ_SOURCE_TMU1, 0);
+  IRQ_Set_Handler(IRQ_EVENT_TMU0, NULL);
+  IRQ_Set_Handler(IRQ_EVENT_TMU1, NULL);
+
+  *(volatile uint16_t*)TIMER_TCR0 = 0;
+  *(volatile uint16_t*)TIMER_TCR1 = 0;
+
+  for(uint32_t i = 0; i < TIMER_MAX_TIMERS; i++)
+  {
+    timer_entries[i].deadline = 0;
+  }
+}
@@ -0,0 +1,101 @@
+// ---- timer.h - TMU Timer Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module uses the SH4's timer unit (TMU) for a 64-bit monotonic clock,
+// one-shot and periodic timer callbacks, and microsecond delays. It is hereby
+// released into the public domain in the hope that it may prove useful.
+//
+
+#ifndef __TIMER_H_
+#define __TIMER_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires irq.h, and IRQ_Init() must be called before TIMER_Init().
+// - TMU channel 0 is the clock: it counts down continuously, and its underflow
+//  interrupt counts the upper 32 bits. TMU channel 1 goes off at the next timer
+//  deadline. Channel 2 is left alone for other uses.
+// - Both channels count at the peripheral clock / 4. The peripheral clock is
+//  half of the bus clock (PMCR_SH4_BUS_FREQUENCY in perfctr.h), so one tick is
+//  4 / 49.875MHz = ~80.2ns, and channel 0 underflows about every 344 seconds.
+//  The 64-bit clock won't wrap for about 46,900 years.
+// - TIMER_Get_Ticks() works with interrupts masked too (e.g. inside a handler)
+//  as long as they aren't masked for longer than one channel 0 underflow
+//  period.
+// - Timer callbacks run from the TMU1 interrupt handler, so keep them short.
+//  They can start and cancel timers, including their own. Periodic timers are
+//  rescheduled from their previous deadline, not from when the callback ran, so
+//  they don't drift.
+// - TIMER_Spin_Microseconds() busy-waits on the channel 0 count and doesn't
+//  need interrupts at all. TIMER_Sleep_Microseconds() puts the CPU to sleep
+//  until a one-shot timer wakes it up, and falls back to spinning if the TMU
+//  interrupts are masked by SR.IMASK.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Same as PMCR_SH4_BUS_FREQUENCY
+#define TIMER_BUS_FREQUENCY 99750000
+// Peripheral clock / 4
+#define TIMER_TICKS_PER_SECOND (TIMER_BUS_FREQUENCY / 2 / 4)
+
+// Max number of active timers
+#define TIMER_MAX_TIMERS 16
+
+// Interrupt priority used for both channels unless TIMER_Init() is given
+// something else
+#define TIMER_DEFAULT_PRIORITY 10
+
+// Timer callbacks get the ID of the timer and the 'data' pointer it was
+// started with.
+typedef void (*TIMER_CALLBACK)(uint32_t timer_id, void * data);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Start the clock and install the TMU0/TMU1 interrupt handlers at the given
+// priority (1-15). The clock starts at 0.
+void TIMER_Init(uint32_t priority);
+
+// Stop both channels, remove the handlers, and cancel all timers
+void TIMER_Shutdown(void);
+
+// Ticks (TIMER_TICKS_PER_SECOND per second) since TIMER_Init()
+uint64_t TIMER_Get_Ticks(void);
+
+// Time since TIMER_Init()
+uint64_t TIMER_Get_Microseconds(void);
+uint64_t TIMER_Get_Milliseconds(void);
+
+// Conversions
+uint64_t TIMER_Microseconds_To_Ticks(uint32_t microseconds);
+uint64_t TIMER_Ticks_To_Microseconds(uint64_t ticks);
+
+// Call 'callback' once after 'microseconds'. Returns the timer's ID, or 0 if
+// there are already TIMER_MAX_TIMERS timers running.
+uint32_t TIMER_Start_Oneshot(uint32_t microseconds, TIMER_CALLBACK callback, void * data);
+
+// Call 'callback' every 'microseconds' (minimum 1). Returns the timer's ID, or
+// 0 if there are already TIMER_MAX_TIMERS timers running.
+uint32_t TIMER_Start_Periodic(uint32_t microseconds, TIMER_CALLBACK callback, void * data);
+
+// Stop a timer. Returns 1 if it was running, or 0 if it wasn't (e.g. a one-shot
+// timer that already went off).
+uint32_t TIMER_Cancel(uint32_t timer_id);
+
+// Busy-wait for at least 'microseconds' (up to about 344 seconds)
+void TIMER_Spin_Microseconds(uint32_t microseconds);
+
+// Sleep for at least 'microseconds'
+void TIMER_Sleep_Microseconds(uint32_t microseconds);
+
+#endif /* __TIMER_H_ */
@@ -0,0 +1,282 @@
+// ---- trace.c - Trace Event Recorder Module Code ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module records timestamped trace events into a ring buffer and streams
+// them to a file on the host over dcload in bulk, for viewing as a timeline. It
+// is hereby released into the public domain in the hope that it may prove
+// useful.
+//
+
+// See trace.h for usage notes.
+#include <stddef.h>
+#include "trace.h"
+#include "perfctr.h"
+#include "fs_dcload.h"
+#include "startup_support.h"
+
+// SR fields
+#define TRACE_SR_BL 0x10000000
+#define TRACE_SR_IMASK 0x000000f0
+
+// Host open() flags as dc-tool expects them (newlib's O_WRONLY | O_CREAT |
+// O_TRUNC), and rw-r--r--
+#define TRACE_OPEN_FLAGS (0x0001 | 0x0200 | 0x0400)
+#define TRACE_OPEN_MODE 0644
+
+// Name hash table size, twice TRACE_MAX_NAMES so that probes stay short
+#define TRACE_NAME_SLOTS (TRACE_MAX_NAMES * 2)
+
+static TRACE_RECORD_STRUCT trace_default_buffer[TRACE_DEFAULT_BUFFER_EVENTS];
+
+// Indices count up forever and are masked to get a slot, so the ring is full
+// when they're 'trace_capacity' apart. Only TRACE_Record() moves the write
+// index and only TRACE_Flush() moves the read index.
+static TRACE_RECORD_STRUCT * trace_buffer = trace_default_buffer;
+static uint32_t trace_capacity = TRACE_DEFAULT_BUFFER_EVENTS;
+static volatile uint32_t trace_write_index = 0;
+static volatile uint32_t trace_read_index = 0;
+static volatile uint32_t trace_dropped = 0;
+
+// Host file descriptor, or -1 if there's no stream
+static int trace_file = -1;
+static uint32_t trace_dropped_written = 0;
+
+// Names already sent in this stream
+static const char * trace_sent_names[TRACE_NAME_SLOTS];
+static uint32_t trace_sent_name_count = 0;
+
+//------------------------------------------------------------------------------
+// Recording
+//------------------------------------------------------------------------------
+
+void TRACE_Init(void * buffer, uint32_t buffer_bytes)
+{
+  uint32_t capacity = 0;
+
+  if(buffer)
+  {
+    // Largest power of 2 that fits
+    capacity = 1;
+    while((capacity << 1) <= buffer_bytes / sizeof(TRACE_RECORD_STRUCT))
+    {
+      capacity <<= 1;
+    }
+
+    if(capacity * sizeof(TRACE_RECORD_STRUCT) > buffer_bytes)
+    {
+      capacity = 0;
+    }
+  }
+
+  if(capacity)
+  {
+    trace_buffer = (TRACE_RECORD_STRUCT*)buffer;
+    trace_capacity = capacity;
+  }
+  else
+  {
+    trace_buffer = trace_default_buffer;
+    trace_capacity = TRACE_DEFAULT_BUFFER_EVENTS;
+  }
+
+  trace_write_index = 0;
+  trace_read_index = 0;
+  trace_dropped = 0;
+  trace_dropped_written = 0;
+
+  // Does nothing if it's already running
+  PMCR_Init(1, PMCR_ELAPSED_TIME_MODE, PMCR_COUNT_CPU_CYCLES);
+}
+
+void TRACE_Record(uint32_t type, const char * name, uint32_t value)
+{
+  uint32_t sr;
+  asm volatile ("stc sr, %[out]\n" : [out] "=r" (sr) : : );
+
+  // Claiming a slot and taking the timestamp have to happen together, or an
+  // interrupt could record an event in between and the timestamps would go
+  // backwards
+  asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr | TRACE_SR_IMASK) : "memory");
+
+  uint32_t index = trace_write_index;
+  if(index - trace_read_index >= trace_capacity)
+  {
+    trace_dropped++;
+    asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr) : "memory");
+    return;
+  }
+  trace_write_index = index + 1;
+
+  // If the high half changed, the low half carried between the reads. A small
+  // low half goes with the new high half.
+  uint32_t high = *(volatile uint32_t*)PMCTR1H_REG;
+  uint32_t low = *(volatile uint32_t*)PMCTR1L_REG;
+  uint32_t high_again = *(volatile uint32_t*)PMCTR1H_REG;
+
+  asm volatile ("ldc %[in], sr\n" : : [in] "r" (sr) : "memory");
+
+  if((high != high_again) && !(low & 0x80000000))
+  {
+    high = high_again;
+  }
+
+  TRACE_RECORD_STRUCT * record = &trace_buffer[index & (trace_capacity - 1)];
+  record->timestamp_low = low;
+  record->timestamp_high = (uint16_t)high;
+  record->type = (uint8_t)type;
+  record->track = (sr & TRACE_SR_BL) ? TRACE_TRACK_INTERRUPT : TRACE_TRACK_MAIN;
+  record->name = name;
+  record->value = value;
+}
+
+uint32_t TRACE_Get_Dropped(void)
+{
+  return trace_dropped;
+}
+
+//------------------------------------------------------------------------------
+// Streaming to the host
+//------------------------------------------------------------------------------
+
+uint32_t TRACE_Open_Stream(const char * host_filename)
+{
+  if(STARTUP_dcload_present == DCLOAD_NOT_PRESENT)
+  {
+    return 0;
+  }
+
+  TRACE_Close_Stream();
+
+  trace_file = dcloadsyscall(DCLOAD_OPEN, host_filename, TRACE_OPEN_FLAGS, TRACE_OPEN_MODE);
+  if(trace_file < 0)
+  {
+    trace_file = -1;
+    return 0;
+  }
+
+  uint32_t header[4] = {TRACE_FILE_MAGIC, TRACE_FILE_VERSION, PMCR_SH4_CPU_FREQUENCY, 0};
+  dcloadsyscall(DCLOAD_WRITE, trace_file, header, sizeof(header));
+
+  for(uint32_t i = 0; i < TRACE_NAME_SLOTS; i++)
+  {
+    trace_sent_names[i] = NULL;
+  }
+  trace_sent_name_count = 0;
+
+  // Events and drops from before the stream was opened aren't part of it
+  trace_read_index = trace_write_index;
+  trace_dropped_written = trace_dropped;
+
+  return 1;
+}
+
+// Send a name's text the first time it's used in this stream
+static void trace_send_name(const char * name)
+{
+  if(!name)
+  {
+    return;
+  }
+
+  uint32_t slot = ((uint32_t)name >> 2) & (TRACE_NAME_SLOTS - 1);
+
+  while(trace_sent_names[slot])
+  {
+    if(trace_sent_names[slot] == name)
+    {
+      return;
+    }
+
+    slot = (slot + 1) & (TRACE_NAME_SLOTS - 1);
+  }
+
+  if(trace_sent_name_count == TRACE_MAX_NAMES)
+  {
+    return;
+  }
+
+  trace_sent_names[slot] = name;
+  trace_sent_name_count++;
+
+  uint32_t length = 0;
+  while(name[length])
+  {
+    length++;
+  }
+
+  TRACE_RECORD_STRUCT record = {length, 0, TRACE_TYPE_NAME, 0, name, 0};
+  dcloadsyscall(DCLOAD_WRITE, trace_file, &record, sizeof(record));
+  dcloadsyscall(DCLOAD_WRITE, trace_file, name, length);
+
+  uint32_t padding = 0;
+  if(length & 3)
+  {
+    dcloadsyscall(DCLOAD_WRITE, trace_file, &padding, 4 - (length & 3));
+  }
+}
+
+uint32_t TRACE_Flush(void)
+{
+  uint32_t read_index = trace_read_index;
+  uint32_t write_index = trace_write_index;
+  uint32_t count = write_index - read_index;
+  uint32_t mask = trace_capacity - 1;
+
+  if(trace_file < 0)
+  {
+    trace_read_index = write_index;
+    return 0;
+  }
+
+  // Names have to get there before the events that use them
+  for(uint32_t i = read_index; i != write_index; i++)
+  {
+    trace_send_name(trace_buffer[i & mask].name);
+  }
+
+  // At most two contiguous runs: to the end of the buffer, then from the start
+  while(read_index != write_index)
+  {
+    uint32_t start = read_index & mask;
+    uint32_t run = write_index - read_index;
+
+    if(start + run > trace_capacity)
+    {
+      run = trace_capacity - start;
+    }
+
+    dcloadsyscall(DCLOAD_WRITE, trace_file, &trace_buffer[start], run * sizeof(TRACE_RECORD_STRUCT));
+
+    read_index += run;
+    trace_read_index = read_index;
+  }
+
+  // Events are only dropped while the ring is full, so the marker goes after
+  // what was just written
+  uint32_t dropped = trace_dropped;
+  if(dropped != trace_dropped_written)
+  {
+    TRACE_RECORD_STRUCT marker = {0, 0, TRACE_TYPE_DROPPED, 0, NULL, dropped - trace_dropped_written};
+    dcloadsyscall(DCLOAD_WRITE, trace_file, &marker, sizeof(marker));
+    trace_dropped_written = dropped;
+  }
+
+  return count;
+}
+
+void TRACE_Close_Stream(void)
+{
+  if(trace_file < 0)
+  {
+    return;
+  }
+
+  TRACE_Flush();
+  dcloadsyscall(DCLOAD_CLOSE, trace_file);
+  trace_file = -1;
+}
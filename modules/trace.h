@@ -0,0 +1,140 @@
+// ---- trace.h - Trace Event Recorder Module Header ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This module records timestamped trace events into a ring buffer and streams
+// them to a file on the host over dcload in bulk, for viewing as a timeline. It
+// is hereby released into the public domain in the hope that it may prove
+// useful.
+//
+
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include <stdint.h>
+
+// Notes:
+// - Requires perfctr.h, fs_dcload.h, and startup_support.h.
+// - Timestamps are CPU cycles from performance counter 1, which TRACE_Init()
+//  starts in elapsed time mode (PMCR_COUNT_CPU_CYCLES) unless it's already
+//  running. Don't switch counter 1 to another mode while tracing, e.g. with
+//  perfmux.h.
+// - Each event is a 16-byte record. Recording one masks interrupts for a few
+//  instructions to claim a slot, reads the counter, and fills in the record, so
+//  events can be recorded from interrupt handlers too. Events from handlers
+//  (SR.BL = 1) go on their own track in the timeline.
+// - Event names are only stored as pointers, so they have to stay around, like
+//  string literals do. TRACE_Flush() sends each name's text to the host the
+//  first time it sees it.
+// - When the ring buffer is full, new events are dropped and counted. Call
+//  TRACE_Flush() often enough, e.g. once per frame, to keep up. It uses dcload
+//  syscalls, so don't call it from an interrupt handler.
+// - tools/trace2json.py turns the file into Chrome trace event JSON, which
+//  Perfetto (ui.perfetto.dev) and chrome://tracing can open.
+// - Setting TRACE_ENABLED to 0 compiles out the TRACE_* event macros.
+//
+// File format (all little endian):
+// - Header: TRACE_FILE_MAGIC, TRACE_FILE_VERSION, timestamp units per second,
+//  and 0, as 32-bit words
+// - Then TRACE_RECORD_STRUCTs. TRACE_TYPE_NAME records are followed by the
+//  name's text, zero-padded to a multiple of 4 bytes, whose length is in
+//  'timestamp_low'. TRACE_TYPE_DROPPED records have the number of events
+//  dropped at that point in 'value'.
+//
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+// Set to 0 to compile out the TRACE_* event macros
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+// Size of the internal ring buffer (16 bytes per event), used if TRACE_Init()
+// isn't given one. Must be a power of 2.
+#define TRACE_DEFAULT_BUFFER_EVENTS 2048
+
+// Distinct event names that can be sent per stream. Names past this are still
+// recorded but show up as addresses.
+#define TRACE_MAX_NAMES 256
+
+#define TRACE_FILE_MAGIC 0x52544844 // "DHTR"
+#define TRACE_FILE_VERSION 1
+
+// Event types
+#define TRACE_TYPE_BEGIN 1
+#define TRACE_TYPE_END 2
+#define TRACE_TYPE_INSTANT 3
+#define TRACE_TYPE_COUNTER 4
+#define TRACE_TYPE_NAME 5
+#define TRACE_TYPE_DROPPED 6
+
+// Tracks
+#define TRACE_TRACK_MAIN 0
+#define TRACE_TRACK_INTERRUPT 1
+
+typedef struct {
+  // 48-bit cycle count
+  uint32_t timestamp_low;
+  uint16_t timestamp_high;
+  uint8_t type;
+  uint8_t track;
+  const char * name;
+  uint32_t value;
+} TRACE_RECORD_STRUCT;
+
+//------------------------------------------------------------------------------
+// Macros
+//------------------------------------------------------------------------------
+
+#if TRACE_ENABLED
+
+#define TRACE_BEGIN(name) TRACE_Record(TRACE_TYPE_BEGIN, name, 0)
+#define TRACE_END(name) TRACE_Record(TRACE_TYPE_END, name, 0)
+#define TRACE_INSTANT(name) TRACE_Record(TRACE_TYPE_INSTANT, name, 0)
+#define TRACE_COUNTER(name, value) TRACE_Record(TRACE_TYPE_COUNTER, name, value)
+
+#else
+
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_INSTANT(name)
+#define TRACE_COUNTER(name, value)
+
+#endif
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+
+// Set up the ring buffer. 'buffer' is a 4-byte aligned buffer of
+// 'buffer_bytes' bytes, of which the largest power-of-2 number of records is
+// used; pass NULL to use an internal one.
+void TRACE_Init(void * buffer, uint32_t buffer_bytes);
+
+// Record an event (TRACE_TYPE_BEGIN to TRACE_TYPE_COUNTER). 'value' is only
+// used by counters. BEGIN and END events with the same name on the same track
+// should nest properly.
+void TRACE_Record(uint32_t type, const char * name, uint32_t value);
+
+// Events dropped so far because the ring buffer was full
+uint32_t TRACE_Get_Dropped(void);
+
+// Create (or overwrite) 'host_filename' on the host through dcload and write
+// the file header. Returns 1 on success, or 0 if dcload isn't present or the
+// file couldn't be opened.
+uint32_t TRACE_Open_Stream(const char * host_filename);
+
+// Write everything in the ring buffer to the stream, or throw it away if
+// there's no stream. Returns the number of events written.
+uint32_t TRACE_Flush(void);
+
+// Flush and close the stream
+void TRACE_Close_Stream(void);
+
+#endif /* __TRACE_H_ */
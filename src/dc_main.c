@@ -46,17 +46,17 @@ int dreamcast_main(void)
   printf("%s\n", int_to_string(-2, test_array));
   printf("%s\n", int_to_string(-1, test_array));
 
-  printf("%s\n", float_to_string(0.0f, 1, test_array));
-  printf("%s\n", float_to_string(5.0f, 3, test_array));
-  printf("%s\n", float_to_string(1.252f, 3, test_array));
-  printf("%s\n", float_to_string(1.928401f, 3, test_array));
-  printf("%s\n", float_to_string(1.928401f, 2, test_array));
+  printf("%s\n", float_to_string(0.0f, test_array));
+  printf("%s\n", float_to_string(5.0f, test_array));
+  printf("%s\n", float_to_string(1.252f, test_array));
+  printf("%s\n", float_to_string(1.928401f, test_array));
+  printf("%s\n", float_to_string(0.1f, test_array));
 
-  printf("%s\n", float_to_string(-5.0f, 3, test_array));
+  printf("%s\n", float_to_string(-5.0f, test_array));
 /*
   for(float p = 4.0f/3.0f; p <= 100.0f; p += 1.0f)
   {
-    printf("%s\n", float_to_string(p, 3, test_array));
+    printf("%s\n", float_to_string(p, test_array));
   }
 */
 
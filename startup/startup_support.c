@@ -1,6 +1,6 @@
 // ---- startup_support.c - Dreamcast Startup Support Module ----
 //
-// Version 1.1.2
+// Version 1.1.4
 //
 // This file is part of the DreamHAL project, a hardware abstraction library
 // primarily intended for use on the SH7091 found in hardware such as the SEGA
@@ -35,6 +35,34 @@ uint32_t STARTUP_cable_type = 0;
 // This is a global console region type for user reference (0 = JP, 1 = NA, 2 = PAL)
 uint32_t STARTUP_console_region = 0;
 
+//==============================================================================
+// Exit Support
+//==============================================================================
+
+static STARTUP_EXIT_HOOK exit_hooks[STARTUP_MAX_EXIT_HOOKS];
+static uint32_t exit_hook_count = 0;
+
+uint32_t STARTUP_Add_Exit_Hook(STARTUP_EXIT_HOOK hook)
+{
+  if(exit_hook_count == STARTUP_MAX_EXIT_HOOKS)
+  {
+    return 0;
+  }
+
+  exit_hooks[exit_hook_count++] = hook;
+  return 1;
+}
+
+void STARTUP_Run_Exit_Hooks(void)
+{
+  // Take each hook off the list before running it, so a hook that exits again
+  // doesn't end up running itself forever
+  while(exit_hook_count)
+  {
+    exit_hooks[--exit_hook_count]();
+  }
+}
+
 //==============================================================================
 // FPSCR Support
 //==============================================================================
@@ -144,6 +172,163 @@ VIDEO_PARAMS_STRUCT STARTUP_video_params = {1.0f, 1.0f, 640, 480, 60, 0, 640, 48
 static uint32_t cable_mode = 0;
 static uint32_t video_region = 0;
 
+// All video mode functions clear the framebuffer to this color
+uint32_t STARTUP_video_clear_color = 0x00000000;
+
+// Every video mode function finishes with this (see Framebuffer Management)
+static void framebuffer_reset(void);
+
+//------------------------------------------------------------------------------
+// Store Queue Writes
+//------------------------------------------------------------------------------
+
+// Store queue registers and memory area
+#define SQ_QACR0 0xff000038
+#define SQ_QACR1 0xff00003c
+#define SQ_AREA_BASE 0xe0000000
+
+// Both SQs write to the same area (QACR holds physical address bits 28:26).
+// Returns the SQ area address for 'dest'.
+static inline __attribute__((always_inline)) volatile uint32_t * sq_setup(uint32_t dest)
+{
+  uint32_t qacr = ((dest >> 26) & 0x7) << 2;
+  *(volatile uint32_t*)SQ_QACR0 = qacr;
+  *(volatile uint32_t*)SQ_QACR1 = qacr;
+
+  // Address bit 5 picks SQ0 or SQ1, so consecutive blocks alternate between
+  // them and one can be filled while the other is being written out.
+  return (volatile uint32_t*)(SQ_AREA_BASE | (dest & 0x03ffffe0));
+}
+
+uint32_t STARTUP_SQ_Fill(void * dest, uint32_t blocks, const uint32_t * pattern, uint32_t index)
+{
+  volatile uint32_t * sq = sq_setup((uint32_t)dest);
+
+  while(blocks--)
+  {
+    const uint32_t * words = pattern + index;
+
+    sq[0] = words[0];
+    sq[1] = words[1];
+    sq[2] = words[2];
+    sq[3] = words[3];
+    sq[4] = words[4];
+    sq[5] = words[5];
+    sq[6] = words[6];
+    sq[7] = words[7];
+
+    // Fire off the burst
+    asm volatile ("pref @%[sq_addr]\n"
+      : // no outputs
+      : [sq_addr] "r" ((uint32_t)sq) // inputs
+      : "memory" // clobbers
+    );
+
+    sq += 8;
+    index += 8;
+    if(index >= 24)
+    {
+      index -= 24;
+    }
+  }
+
+  return index;
+}
+
+void STARTUP_SQ_Copy(void * dest, const void * src, uint32_t blocks)
+{
+  volatile uint32_t * sq = sq_setup((uint32_t)dest);
+  const uint32_t * words = (const uint32_t*)src;
+
+  while(blocks--)
+  {
+    sq[0] = words[0];
+    sq[1] = words[1];
+    sq[2] = words[2];
+    sq[3] = words[3];
+    sq[4] = words[4];
+    sq[5] = words[5];
+    sq[6] = words[6];
+    sq[7] = words[7];
+
+    // Fire off the burst
+    asm volatile ("pref @%[sq_addr]\n"
+      : // no outputs
+      : [sq_addr] "r" ((uint32_t)sq) // inputs
+      : "memory" // clobbers
+    );
+
+    sq += 8;
+    words += 8;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Video Mode Setup
+//------------------------------------------------------------------------------
+
+// Fill 'size_bytes' bytes of VRAM starting at 'address' with an RGB0888 color,
+// converted to the given framebuffer color mode. This uses the store queues to
+// write 32 bytes at a time instead of doing it one uncached word at a time.
+// 'address' must be 32-byte aligned and 'size_bytes' must be a multiple of 4,
+// which is always the case for framebuffers.
+static void framebuffer_fill(uint32_t address, uint32_t size_bytes, uint32_t fbuffer_color_mode, uint32_t color)
+{
+  uint32_t red = (color >> 16) & 0xff;
+  uint32_t green = (color >> 8) & 0xff;
+  uint32_t blue = color & 0xff;
+
+  // 3 SQ blocks (96 bytes) is a whole number of 24-bit pixels, so one pattern
+  // of 24 words works for every color mode.
+  uint32_t pattern[24];
+
+  if(fbuffer_color_mode == FB_RGB888)
+  {
+    uint8_t * pattern_bytes = (uint8_t*)pattern;
+    for(uint32_t i = 0; i < 96; i += 3)
+    {
+      pattern_bytes[i] = blue;
+      pattern_bytes[i + 1] = green;
+      pattern_bytes[i + 2] = red;
+    }
+  }
+  else
+  {
+    uint32_t pixel_or_two;
+
+    if(fbuffer_color_mode == FB_RGB0555)
+    {
+      pixel_or_two = RGB0555_TO_16_SCALED(red, green, blue);
+      pixel_or_two |= pixel_or_two << 16;
+    }
+    else if(fbuffer_color_mode == FB_RGB565)
+    {
+      pixel_or_two = RGB565_TO_16_SCALED(red, green, blue);
+      pixel_or_two |= pixel_or_two << 16;
+    }
+    else // FB_RGB0888
+    {
+      pixel_or_two = color & 0x00ffffff;
+    }
+
+    for(uint32_t i = 0; i < 24; i++)
+    {
+      pattern[i] = pixel_or_two;
+    }
+  }
+
+  // 'index' is always a multiple of 8 here, so 24 words of pattern is enough
+  uint32_t blocks = size_bytes >> 5;
+  uint32_t index = STARTUP_SQ_Fill((void*)address, blocks, pattern, 0);
+
+  // Not every framebuffer is a multiple of 32 bytes
+  uint32_t * tail = (uint32_t*)(address + (size_bytes & ~31));
+  for(uint32_t words = (size_bytes & 31) >> 2; words; words--)
+  {
+    *tail++ = pattern[index++];
+  }
+}
+
 // Video mode is automatically determined based on cable type and console region
 // This sets up everything related to Dreamcast video modes.
 void STARTUP_Init_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
@@ -197,7 +382,7 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
   uint32_t horiz_active_area = 640;
   uint32_t vert_active_area = 480;
   // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
+  uint32_t bpp_mode_size = FB_BYTES_PER_PIXEL(fbuffer_color_mode);
 
   // NOTE:
   // Unlike the extra video modes that set framebuffer parameters here, this
@@ -231,11 +416,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -270,11 +452,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -306,11 +485,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = horiz_active_area * bpp_mode_size; // This is for interlaced, resetting the offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -344,11 +520,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = horiz_active_area * bpp_mode_size; // Resetting the framebuffer offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -387,11 +560,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = horiz_active_area * bpp_mode_size; // Resetting the framebuffer offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -429,11 +599,8 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = horiz_active_area * bpp_mode_size; // This is for interlaced, resetting the offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
@@ -444,218 +611,241 @@ void STARTUP_Set_Video(uint8_t fbuffer_color_mode, uint8_t use_320x240)
   STARTUP_video_params.fb_width = horiz_active_area;
   STARTUP_video_params.fb_height = vert_active_area;
   STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-}
 
-//==============================================================================
-// Extra Video Modes
-//==============================================================================
-//
-// These can be used to set up extra video modes after running STARTUP_Init_Video().
-//
-// The framebuffer address will always be set to 0xa5000000 after any of these run.
-//
-// Modes marked "PVR 32x32" have a framebuffer that's an integer multiple of 32x32.
-//
+  framebuffer_reset();
+}
 
 //------------------------------------------------------------------------------
-// 60Hz Modes
+// Framebuffer Management
 //------------------------------------------------------------------------------
 //
-// Scaled 60Hz video modes
+// Framebuffers are laid out back to back from the start of VRAM. The display
+// address registers hold offsets from 0xa5000000: 0xa05f8050 is the first
+// field and 0xa05f8054 is the second field. Progressive modes set both to the
+// same thing, and interlaced modes start the second field one line further in,
+// so flipping just moves both by the same amount and keeps that difference.
 //
 
-// 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync)
-// Framebuffer: 678x480
-// Horizontal scale: 0.799528302x
-// DMT specifies a 3.32usec hsync width, which is 90 Dreamcast pixels when scaled
-// for 848x480. The Dreamcast maxes at an hsync width of 64 pixels, which is
-// 2.37usec. This may not really cause a problem (no issues with any of the 5
-// different LCDs I tried), but it is worth pointing out.
-void STARTUP_848x480_VGA(uint8_t fbuffer_color_mode)
+// VRAM, as seen from the 0xa5000000 area
+#define FRAMEBUFFER_VRAM_BASE 0xa5000000
+#define FRAMEBUFFER_VRAM_SIZE 0x00800000
+
+// Bit 13 of SPG_STATUS is set during vertical sync
+#define SPG_STATUS_VSYNC (1 << 13)
+
+// framebuffer_pending when no flip is queued
+#define FRAMEBUFFER_NONE 0xffffffff
+
+static uint32_t framebuffer_count = 1;
+static uint32_t framebuffer_size = 0;
+static uint32_t framebuffer_field_offset = 0;
+
+// STARTUP_Vblank_Flip() may run in an interrupt handler and changes these
+static volatile uint32_t framebuffer_front = 0;
+static volatile uint32_t framebuffer_pending = FRAMEBUFFER_NONE;
+
+// Keep each framebuffer 32-byte aligned so they can all be written with SQs
+static uint32_t framebuffer_aligned_size(void)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 848.0f / 678.0f;
-  STARTUP_video_params.video_scale_multiplier = 678.0f / 848.0f;
+  uint32_t size = STARTUP_video_params.fb_width * STARTUP_video_params.fb_height * STARTUP_video_params.fb_color_bytes;
+  return (size + 31) & ~31;
+}
 
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 848;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
+// Back to the single framebuffer at 0xa5000000 that every video mode leaves
+// the display pointing at, sized for the new mode. Any queued flip was for the
+// old mode, so it's dropped.
+static void framebuffer_reset(void)
+{
+  framebuffer_pending = FRAMEBUFFER_NONE;
+  framebuffer_count = 1;
+  framebuffer_front = 0;
+  framebuffer_size = framebuffer_aligned_size();
 
-  // 1088 wide scaled to 870 wide (field)
-  // 848 wide scaled to 678 wide (visible frame)
-  uint32_t horiz_active_area = 678;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
+  // Whatever the video mode set up for the second field
+  framebuffer_field_offset = *(volatile uint32_t*)0xa05f8054 - *(volatile uint32_t*)0xa05f8050;
+}
 
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
+uint32_t STARTUP_Set_Framebuffers(uint32_t count)
+{
+  if(count < 1)
+  {
+    count = 1;
+  }
+  else if(count > MAX_FRAMEBUFFERS)
+  {
+    count = MAX_FRAMEBUFFERS;
+  }
 
-  if(!cable_mode) // VGA 60Hz
+  uint32_t size = framebuffer_aligned_size();
+
+  while((count > 1) && (count * size > FRAMEBUFFER_VRAM_SIZE))
   {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
+    count--;
+  }
 
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
+  framebuffer_pending = FRAMEBUFFER_NONE;
+  framebuffer_count = count;
+  framebuffer_front = 0;
+  framebuffer_size = size;
 
-    *(volatile uint32_t*)0xa05f80ec = 0x000000b3; // ok: 179 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001f001f; // ok: 31 & 31 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x03590000; // ok: 857 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001f01ff; // ok: 31, 511 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00b30359; // ok: 179, 857 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02040365; // ok: 869x516 (870x517) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001f01ff; // ok: 31, 511 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03f2583f; // ok: 15 (16,- 1), 805 (870 - 64,- 1), 8 (per DMT), 63 (64,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-    // scaled hsync should be 112/1.25 = 90, but max is 64... May/may not work with everything as a result.
-    // the 16 should be 22 for 89.6/4, but, since it's 64, using 16 instead.
+  *(volatile uint32_t*)0xa05f8050 = 0x00000000;
+  *(volatile uint32_t*)0xa05f8054 = framebuffer_field_offset;
 
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
+  return count;
+}
 
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
+void * STARTUP_Get_Front_Buffer(void)
+{
+  return (void*)(FRAMEBUFFER_VRAM_BASE + framebuffer_front * framebuffer_size);
+}
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+void * STARTUP_Get_Back_Buffer(void)
+{
+  // The one after whatever will be displayed next
+  uint32_t newest = framebuffer_pending;
+  if(newest == FRAMEBUFFER_NONE)
+  {
+    newest = framebuffer_front;
+  }
 
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
+  uint32_t back = newest + 1;
+  if(back == framebuffer_count)
+  {
+    back = 0;
   }
+
+  return (void*)(FRAMEBUFFER_VRAM_BASE + back * framebuffer_size);
 }
 
-// 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync) - PVR 32x32
-// Framebuffer: 672x480
-// Horizontal scale: 0.79245283x
-// Same caveat as 848x480 VGA, but this mode has been shrunken by 6 columns for
-// 32x32 framebuffer compatibility. As a result, there may be 6 total columns of
-// blank pixels on the horizontal sides.
-void STARTUP_848x480_VGA_PVR(uint8_t fbuffer_color_mode)
+void * STARTUP_Get_Framebuffers_End(void)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 848.0f / 672.0f;
-  STARTUP_video_params.video_scale_multiplier = 672.0f / 848.0f;
+  uint32_t size = framebuffer_size;
 
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 848;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
+  // No video mode has been set yet
+  if(!size)
+  {
+    size = framebuffer_aligned_size();
+  }
 
-  // 1088 wide scaled to 870 wide (field)
-  // 848 wide scaled to 678 wide (visible frame)
-  uint32_t horiz_active_area = 672;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
+  return (void*)(FRAMEBUFFER_VRAM_BASE + framebuffer_count * size);
+}
 
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
+void STARTUP_Wait_Vblank(void)
+{
+  // Wait out any vsync that's already in progress, then wait for the next one
+  // to start. This way there's a whole vblank period left after returning.
+  while((*(volatile uint32_t*)0xa05f810c) & SPG_STATUS_VSYNC);
+  while(!((*(volatile uint32_t*)0xa05f810c) & SPG_STATUS_VSYNC));
+}
 
-  if(!cable_mode) // VGA 60Hz
+uint32_t STARTUP_Queue_Flip(void)
+{
+  if(framebuffer_pending != FRAMEBUFFER_NONE)
   {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
+    return 0;
+  }
 
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
+  // Nothing is queued, so the front buffer can't change under us here
+  uint32_t back = framebuffer_front + 1;
+  if(back == framebuffer_count)
+  {
+    back = 0;
+  }
 
-    *(volatile uint32_t*)0xa05f80ec = 0x000000b6; // ok: 182 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001f001f; // ok: 31 & 31 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x03590000; // ok: 857 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001f01ff; // ok: 31, 511 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00b30359; // ok: 179, 857 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02040365; // ok: 869x516 (870x517) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001f01ff; // ok: 31, 511 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03f2583f; // ok: 15 (16,- 1), 805 (870 - 64,- 1), 8 (per DMT), 63 (64,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-    // scaled hsync should be 112/1.25 = 90, but max is 64... May/may not work with everything as a result.
-    // the 16 should be 22 for 89.6/4, but, since it's 64, using 16 instead.
+  framebuffer_pending = back;
+  return 1;
+}
 
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
+uint32_t STARTUP_Flip_Pending(void)
+{
+  return framebuffer_pending != FRAMEBUFFER_NONE;
+}
 
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
+void STARTUP_Vblank_Flip(void)
+{
+  uint32_t pending = framebuffer_pending;
+  if(pending == FRAMEBUFFER_NONE)
+  {
+    return;
+  }
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+  uint32_t offset = pending * framebuffer_size;
 
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
+  *(volatile uint32_t*)0xa05f8050 = offset;
+  *(volatile uint32_t*)0xa05f8054 = offset + framebuffer_field_offset;
+
+  framebuffer_front = pending;
+  framebuffer_pending = FRAMEBUFFER_NONE;
+}
+
+void STARTUP_Flip_Framebuffers(void)
+{
+  // Anything that's already queued gets shown first
+  while(!STARTUP_Queue_Flip())
+  {
+    STARTUP_Wait_Vblank();
+    STARTUP_Vblank_Flip();
   }
+
+  STARTUP_Wait_Vblank();
+  STARTUP_Vblank_Flip();
 }
 
-// 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync)
-// Framebuffer: 540x600
-// Horizontal scale: 0.675x (exact)
-// DMT specifies a 3.20usec hsync width, which is 86 Dreamcast pixels when scaled
-// for 800x600. The Dreamcast maxes at an hsync width of 64 pixels, which is
-// 2.37usec. This may not really cause a problem (no issues with any of the 5
-// different LCDs I tried), but it is worth pointing out.
-void STARTUP_800x600_VGA(uint8_t fbuffer_color_mode)
+void STARTUP_Fill_Framebuffer(void * framebuffer, uint32_t color)
+{
+  uint32_t size_bytes = STARTUP_video_params.fb_width * STARTUP_video_params.fb_height * STARTUP_video_params.fb_color_bytes;
+
+  framebuffer_fill((uint32_t)framebuffer, size_bytes, STARTUP_video_params.video_color_type, color);
+}
+
+//------------------------------------------------------------------------------
+// Table-Driven Video Modes
+//------------------------------------------------------------------------------
+//
+// All of the extra video modes write the same registers in the same order, so
+// they all go through here. The timings themselves are in video_timings.c.
+//
+
+void STARTUP_Set_Video_Mode(const VIDEO_TIMING_STRUCT * timing, uint8_t fbuffer_color_mode)
 {
   // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 540.0f;
-  STARTUP_video_params.video_scale_multiplier = 540.0f / 800.0f;
+  STARTUP_video_params.video_scale = (float)timing->video_width / (float)timing->fb_width;
+  STARTUP_video_params.video_scale_multiplier = (float)timing->fb_width / (float)timing->video_width;
 
   // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
+  STARTUP_video_params.video_width = timing->video_width;
+  STARTUP_video_params.video_height = timing->video_height;
   STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
+  STARTUP_video_params.video_refresh_rate = timing->refresh_rate;
 
-  // 1056 wide scaled to 713 wide (field)
-  // 800 wide scaled to 540 wide (visible frame)
-  uint32_t horiz_active_area = 540;
-  uint32_t vert_active_area = 600;
+  uint32_t horiz_active_area = timing->fb_width;
+  uint32_t vert_active_area = timing->fb_height;
   // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
+  uint32_t bpp_mode_size = FB_BYTES_PER_PIXEL(fbuffer_color_mode);
 
   // Set global framebuffer parameters
   STARTUP_video_params.fb_width = horiz_active_area;
   STARTUP_video_params.fb_height = vert_active_area;
   STARTUP_video_params.fb_color_bytes = bpp_mode_size;
 
-  if(!cable_mode) // VGA 60Hz
+  if(!cable_mode) // VGA
   {
     *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
     *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
 
     *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
+    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
     *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
 
-    *(volatile uint32_t*)0xa05f80ec = 0x00000092; // ok: 146 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001b001b; // ok: 27 & 27 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02ae0000; // ok: 686 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001b0273; // ok: 27, 627 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x009202ae; // ok: 146, 686 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x027302c8; // ok: 712x627 (713x628) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001b0273; // ok: 27, 627 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03e8843f; // ok: 15 (16,- 1), 648 (713 - 64,- 1), 4 (per DMT), 63 (64,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-    // scaled hsync should be 128/1.48 = 86, but max is 64... May/may not work with everything as a result.
-    // the 16 should be 22 for 86.4/4, but, since it's 64, using 16 instead.
+    *(volatile uint32_t*)0xa05f80ec = timing->start_x; // VO_STARTX
+    *(volatile uint32_t*)0xa05f80f0 = (timing->start_y << 16) | timing->start_y; // VO_STARTY (both fields)
+    *(volatile uint32_t*)0xa05f80c8 = timing->hblank_start << 16; // SPG_HBLANK_INT
+    *(volatile uint32_t*)0xa05f80cc = (timing->vblank_out_line << 16) | timing->vblank_in_line; // SPG_VBLANK_INT
+    *(volatile uint32_t*)0xa05f80d0 = 0x00000100; // SPG_CONTROL
+    *(volatile uint32_t*)0xa05f80d4 = (timing->hblank_end << 16) | timing->hblank_start; // SPG_HBLANK
+    *(volatile uint32_t*)0xa05f80d8 = ((timing->v_total - 1) << 16) | (timing->h_total - 1); // SPG_LOAD
+    *(volatile uint32_t*)0xa05f80dc = (timing->vblank_end << 16) | timing->vblank_start; // SPG_VBLANK
+    *(volatile uint32_t*)0xa05f80e0 = ((timing->eq_width - 1) << 22) | ((timing->bp_width - 1) << 12) | (timing->vsync_width << 8) | (timing->hsync_width - 1); // SPG_WIDTH
 
     uint32_t scan_area_size = horiz_active_area * vert_active_area;
     uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
@@ -664,90 +854,83 @@ void STARTUP_800x600_VGA(uint8_t fbuffer_color_mode)
     *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
     *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+    // Clear framebuffer area
+    framebuffer_fill(0xa5000000, scan_area_size_bytes, fbuffer_color_mode, STARTUP_video_clear_color);
 
     // re-enable video
     *(volatile uint32_t*)0xa05f80e8 &= ~8;
     *(volatile uint32_t*)0xa05f8044 |= 1;
   }
+
+  framebuffer_reset();
 }
 
-// 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync) - PVR 32x32
-// Framebuffer: 544x608
-// Horizontal scale: 0.68x (exact)
-// Same caveat as standard 800x600 VGA regarding slightly-too-short hsync width.
-// Here, the framebuffer is slightly expanded to 544x608, which is an exact
-// multiple of 32x32 for Dreamcast Tile Accelerator compatibility. Note that 8
-// lines in the vertical direction may simply be cut off by a monitor as the
-// monitor will think this is 800x600. Likewise, 4 columns of pixels may be cut
-// off. No idea which side; horizontally it may even be 2 left and 2 right
-// depending on the monitor.
-void STARTUP_800x600_VGA_PVR(uint8_t fbuffer_color_mode)
-{
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 544.0f;
-  STARTUP_video_params.video_scale_multiplier = 544.0f / 800.0f;
+//==============================================================================
+// Extra Video Modes
+//==============================================================================
+//
+// These can be used to set up extra video modes after running STARTUP_Init_Video().
+//
+// The framebuffer address will always be set to 0xa5000000 after any of these run.
+//
+// Modes marked "PVR 32x32" have a framebuffer that's an integer multiple of 32x32.
+//
 
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1056 wide scaled to 713 wide (field)
-  // 800 wide scaled to 540 wide (visible frame)
-  uint32_t horiz_active_area = 544;
-  uint32_t vert_active_area = 608;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000090; // ok: 144 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00130013; // ok: 19 & 19 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02b00000; // ok: 688 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00130273; // ok: 19, 627 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x009002b0; // ok: 144, 688 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x027302c8; // ok: 712x627 (713x628) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00130273; // ok: 19, 627 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03e8843f; // ok: 15 (16,- 1), 648 (713 - 64,- 1), 4 (per DMT), 63 (64,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-    // scaled hsync should be 128/1.48 = 86, but max is 64... May/may not work with everything as a result.
-    // the 16 should be 22 for 86.4/4, but, since it's 64, using 16 instead.
+//------------------------------------------------------------------------------
+// 60Hz Modes
+//------------------------------------------------------------------------------
+//
+// Scaled 60Hz video modes
+//
 
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
+// 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync)
+// Framebuffer: 678x480
+// Horizontal scale: 0.799528302x
+// DMT specifies a 3.32usec hsync width, which is 90 Dreamcast pixels when scaled
+// for 848x480. The Dreamcast maxes at an hsync width of 64 pixels, which is
+// 2.37usec. This may not really cause a problem (no issues with any of the 5
+// different LCDs I tried), but it is worth pointing out.
+void STARTUP_848x480_VGA(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_848x480_VGA], fbuffer_color_mode);
+}
 
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
+// 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync) - PVR 32x32
+// Framebuffer: 672x480
+// Horizontal scale: 0.79245283x
+// Same caveat as 848x480 VGA, but this mode has been shrunken by 6 columns for
+// 32x32 framebuffer compatibility. As a result, there may be 6 total columns of
+// blank pixels on the horizontal sides.
+void STARTUP_848x480_VGA_PVR(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_848x480_VGA_PVR], fbuffer_color_mode);
+}
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+// 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync)
+// Framebuffer: 540x600
+// Horizontal scale: 0.675x (exact)
+// DMT specifies a 3.20usec hsync width, which is 86 Dreamcast pixels when scaled
+// for 800x600. The Dreamcast maxes at an hsync width of 64 pixels, which is
+// 2.37usec. This may not really cause a problem (no issues with any of the 5
+// different LCDs I tried), but it is worth pointing out.
+void STARTUP_800x600_VGA(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA], fbuffer_color_mode);
+}
 
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+// 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync) - PVR 32x32
+// Framebuffer: 544x608
+// Horizontal scale: 0.68x (exact)
+// Same caveat as standard 800x600 VGA regarding slightly-too-short hsync width.
+// Here, the framebuffer is slightly expanded to 544x608, which is an exact
+// multiple of 32x32 for Dreamcast Tile Accelerator compatibility. Note that 8
+// lines in the vertical direction may simply be cut off by a monitor as the
+// monitor will think this is 800x600. Likewise, 4 columns of pixels may be cut
+// off. No idea which side; horizontally it may even be 2 left and 2 right
+// depending on the monitor.
+void STARTUP_800x600_VGA_PVR(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_PVR], fbuffer_color_mode);
 }
 
 // 800x600 @ 60Hz (4:3, CVT)
@@ -761,64 +944,7 @@ void STARTUP_800x600_VGA_PVR(uint8_t fbuffer_color_mode)
 // matter which.
 void STARTUP_800x600_VGA_CVT(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 565.0f;
-  STARTUP_video_params.video_scale_multiplier = 565.0f / 800.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1024 wide scaled to 723 wide (field)
-  // 800 wide scaled to 565 wide (visible frame)
-  uint32_t horiz_active_area = 565;
-  uint32_t vert_active_area = 600;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000087; // ok: 135 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00150015; // ok: 21 & 21 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02bc0000; // ok: 700 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x0015026d; // ok: 21, 621 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x008702bc; // ok: 135, 700 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x026f02d2; // ok: 722x623 (723x624) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x0015026d; // ok: 21, 621 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x0369a437; // ok: 13 (14,- 1), 666 (723 - 56,- 1), 4 (4:3), 55 (56,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_CVT], fbuffer_color_mode);
 }
 
 // 800x600 @ 60Hz (4:3, CVT) - PVR 32x32
@@ -831,66 +957,7 @@ void STARTUP_800x600_VGA_CVT(uint8_t fbuffer_color_mode)
 // vertical sides.
 void STARTUP_800x600_VGA_CVT_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 544.0f;
-  STARTUP_video_params.video_scale_multiplier = 544.0f / 800.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1024 wide scaled to 723 wide (field)
-  // 800 wide scaled to 565 wide (visible frame)
-  uint32_t horiz_active_area = 544;
-  uint32_t vert_active_area = 608;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 11 (back border), so front porch side left by 0.. Which centers the image.
-    // Well, alright then.
-    *(volatile uint32_t*)0xa05f80ec = 0x00000092; // ok: 146 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x000d000d; // ok: 13 & 13 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02bc0000; // ok: 700 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x000d026d; // ok: 13, 621 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x008702bc; // ok: 135, 700 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x026f02d2; // ok: 722x623 (723x624) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x000d026d; // ok: 13, 621 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x0369a437; // ok: 13 (14,- 1), 666 (723 - 56,- 1), 4 (4:3), 55 (56,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_CVT_PVR], fbuffer_color_mode);
 }
 
 // 1024x768 @ 60Hz (4:3, DMT)
@@ -899,64 +966,7 @@ void STARTUP_800x600_VGA_CVT_PVR(uint8_t fbuffer_color_mode)
 // This one actually uses negative/negative polarity, too!
 void STARTUP_1024x768_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1024.0f / 425.0f;
-  STARTUP_video_params.video_scale_multiplier = 425.0f / 1024.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1024;
-  STARTUP_video_params.video_height = 768;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1344 wide scaled to 558 wide (field)
-  // 1024 wide scaled to 425 wide (visible frame)
-  uint32_t horiz_active_area = 425;
-  uint32_t vert_active_area = 768;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000007b; // ok: 123 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00230023; // ok: 35 & 35 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02240000; // ok: 548 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00230323; // ok: 35, 803 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x007b0224; // ok: 123, 548 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x0325022D; // ok: 557x805 (558x806) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00230323; // ok: 35, 803 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x035f5637; // ok: 13 (14,- 1), 501 (558 - 56,- 1), 6 (per DMT), 55 (56,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1024x768_VGA], fbuffer_color_mode);
 }
 
 // 1024x768 @ 60Hz (4:3, DMT) - PVR 32x32
@@ -967,65 +977,7 @@ void STARTUP_1024x768_VGA(uint8_t fbuffer_color_mode)
 // sides.
 void STARTUP_1024x768_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1024.0f / 416.0f;
-  STARTUP_video_params.video_scale_multiplier = 416.0f / 1024.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1024;
-  STARTUP_video_params.video_height = 768;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1344 wide scaled to 558 wide (field)
-  // 1024 wide scaled to 425 wide (visible frame)
-  uint32_t horiz_active_area = 416;
-  uint32_t vert_active_area = 768;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 4 (back border), so front porch side left by 5 appears to actually center the image
-    *(volatile uint32_t*)0xa05f80ec = 0x0000007f; // ok: 127 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00230023; // ok: 35 & 35 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02240000; // ok: 548 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00230323; // ok: 35, 803 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x007b0224; // ok: 123, 548 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x0325022D; // ok: 557x805 (558x806) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00230323; // ok: 35, 803 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x035f5637; // ok: 13 (14,- 1), 501 (558 - 56,- 1), 6 (per DMT), 55 (56,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1024x768_VGA_PVR], fbuffer_color_mode);
 }
 
 // 1152x864 @ 60Hz (4:3, CVT)
@@ -1033,64 +985,7 @@ void STARTUP_1024x768_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.329861111x
 void STARTUP_1152x864_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1152.0f / 380.0f;
-  STARTUP_video_params.video_scale_multiplier = 380.0f / 1152.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1152;
-  STARTUP_video_params.video_height = 864;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1520 wide scaled to 502 wide (field)
-  // 1152 wide scaled to 380 wide (visible frame)
-  uint32_t horiz_active_area = 380;
-  uint32_t vert_active_area = 864;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000065; // ok: 101 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001e001e; // ok: 30 & 30 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01e10000; // ok: 481 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001e037e; // ok: 30, 894 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006501e1; // ok: 101, 481 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x038001f5; // ok: 501x896 (502x897) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001e037e; // ok: 30, 894 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025cd427; // ok: 9 (10,- 1), 461 (502 - 40,- 1), 4 (4:3), 39 (40,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1152x864_VGA], fbuffer_color_mode);
 }
 
 // 1152x864 @ 60Hz (4:3, CVT) - PVR 32x32
@@ -1101,64 +996,7 @@ void STARTUP_1152x864_VGA(uint8_t fbuffer_color_mode)
 // on one side).
 void STARTUP_1152x864_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1152.0f / 384.0f;
-  STARTUP_video_params.video_scale_multiplier = 384.0f / 1152.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1152;
-  STARTUP_video_params.video_height = 864;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1520 wide scaled to 502 wide (field)
-  // 1152 wide scaled to 380 wide (visible frame)
-  uint32_t horiz_active_area = 384;
-  uint32_t vert_active_area = 864;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000063; // ok: 99 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001e001e; // ok: 30 & 30 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01e30000; // ok: 483 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001e037e; // ok: 30, 894 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006301e3; // ok: 99, 483 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x038001f5; // ok: 501x896 (502x897) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001e037e; // ok: 30, 894 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025cd427; // ok: 9 (10,- 1), 461 (502 - 40,- 1), 4 (4:3), 39 (40,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1152x864_VGA_PVR], fbuffer_color_mode);
 }
 
 // 720p60 (16:9, DMT & CTA-861) - for HDTVs
@@ -1166,64 +1004,7 @@ void STARTUP_1152x864_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.36328125x (exact)
 void STARTUP_720p_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 465.0f;
-  STARTUP_video_params.video_scale_multiplier = 465.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 720;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1650 wide scaled to 600 wide (field)
-  // 1280 wide scaled to 465 wide (visible frame)
-  uint32_t horiz_active_area = 465;
-  uint32_t vert_active_area = 720;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000005f; // ok: 95 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00190019; // ok: 25 & 25 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02300000; // ok: 560 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001902e9; // ok: 25, 745 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x005f0230; // ok: 95, 560 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02ed0257; // ok: 599x749 (600x750) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001902e9; // ok: 25, 745 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00e4850e; // ok: 3 (4,- 1), 584 (600 - 15,- 1), 5 (16:9), 14 (15,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_720p_VGA], fbuffer_color_mode);
 }
 
 // 720p60 (16:9, DMT & CTA-861) - for HDTVs - PVR 32x32
@@ -1236,66 +1017,7 @@ void STARTUP_720p_VGA(uint8_t fbuffer_color_mode)
 // of this mode's framebuffer.
 void STARTUP_720p_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 448.0f;
-  STARTUP_video_params.video_scale_multiplier = 448.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 720;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1650 wide scaled to 600 wide (field)
-  // 1280 wide scaled to 465 wide (visible frame)
-  uint32_t horiz_active_area = 448;
-  uint32_t vert_active_area = 704;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 8 (back border), so h front porch side left by 9 appears to actually center the image
-    // Push down by 8 (back border), v front porch side up by 8 appears to actually center the image
-    *(volatile uint32_t*)0xa05f80ec = 0x00000067; // ok: 103 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00210021; // ok: 33 & 33 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02300000; // ok: 560 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001902e9; // ok: 25, 745 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x005f0230; // ok: 95, 560 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02ed0257; // ok: 599x749 (600x750) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001902e9; // ok: 25, 745 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00e4850e; // ok: 3 (4,- 1), 584 (600 - 15,- 1), 5 (16:9), 14 (15,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_720p_VGA_PVR], fbuffer_color_mode);
 }
 
 // 1280x720 (16:9, CVT) - for monitors that need this instead of HDTV 720p60
@@ -1303,64 +1025,7 @@ void STARTUP_720p_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.3625x (exact)
 void STARTUP_1280x720_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 464.0f;
-  STARTUP_video_params.video_scale_multiplier = 464.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 720;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1664 wide scaled to 603 wide (field)
-  // 1280 wide scaled to 464 wide (visible frame)
-  uint32_t horiz_active_area = 464;
-  uint32_t vert_active_area = 720;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000074; // ok: 116 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00190019; // ok: 25 & 25 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02440000; // ok: 580 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001902e9; // ok: 25, 745 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00740244; // ok: 116, 580 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02eb025a; // ok: 602x747 (603x748) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001902e9; // ok: 25, 745 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x02e2c52d; // ok: 11 (12,- 1), 556 (603 - 46,- 1), 5 (16:9), 45 (46,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1280x720_VGA], fbuffer_color_mode);
 }
 
 // 1280x720 (16:9, CVT) - for monitors that need this instead of HDTV 720p60 - PVR 32x32
@@ -1371,66 +1036,7 @@ void STARTUP_1280x720_VGA(uint8_t fbuffer_color_mode)
 // the horizontal sides and 16 rows of blank pixels on the vertical sides.
 void STARTUP_1280x720_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 448.0f;
-  STARTUP_video_params.video_scale_multiplier = 448.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 720;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1664 wide scaled to 603 wide (field)
-  // 1280 wide scaled to 464 wide (visible frame)
-  uint32_t horiz_active_area = 448;
-  uint32_t vert_active_area = 704;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 8 (back border), so h front porch side left by 8 appears to actually center the image
-    // Push down by 8 (back border), v front porch side up by 8 appears to actually center the image
-    *(volatile uint32_t*)0xa05f80ec = 0x0000007c; // ok: 124 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00210021; // ok: 33 & 33 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02440000; // ok: 580 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001902e9; // ok: 25, 745 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00740244; // ok: 116, 580 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x02eb025a; // ok: 602x747 (603x748) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001902e9; // ok: 25, 745 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x02e2c52d; // ok: 11 (12,- 1), 556 (603 - 46,- 1), 5 (16:9), 45 (46,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1280x720_VGA_PVR], fbuffer_color_mode);
 }
 
 // 1280x800 @ 60Hz (16:10, DMT & CVT)
@@ -1438,64 +1044,7 @@ void STARTUP_1280x720_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.3234375x (exact)
 void STARTUP_1280x800_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 414.0f;
-  STARTUP_video_params.video_scale_multiplier = 414.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 800;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1680 wide scaled to 543 wide (field)
-  // 1280 wide scaled to 414 wide (visible frame)
-  uint32_t horiz_active_area = 414;
-  uint32_t vert_active_area = 800;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000006a; // ok: 106 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001c001c; // ok: 28 & 28 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02080000; // ok: 520 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001c033c; // ok: 28, 828 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006a0208; // ok: 106, 520 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x033e021e; // ok: 542x830 (543x831) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001c033c; // ok: 28, 828 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025f5628; // ok: 9 (10,- 1), 501 (543 - 41,- 1), 6 (16:10), 40 (41,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1280x800_VGA], fbuffer_color_mode);
 }
 
 // 1280x800 @ 60Hz (16:10, DMT & CVT) - PVR 32x32
@@ -1507,64 +1056,7 @@ void STARTUP_1280x800_VGA(uint8_t fbuffer_color_mode)
 // it might even be 1 on each side depending on the monitor.
 void STARTUP_1280x800_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1280.0f / 416.0f;
-  STARTUP_video_params.video_scale_multiplier = 416.0f / 1280.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 800;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1680 wide scaled to 543 wide (field)
-  // 1280 wide scaled to 414 wide (visible frame)
-  uint32_t horiz_active_area = 416;
-  uint32_t vert_active_area = 800;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000069; // ok: 105 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001c001c; // ok: 28 & 28 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02090000; // ok: 521 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001c033c; // ok: 28, 828 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00690209; // ok: 105, 521 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x033e021e; // ok: 542x830 (543x831) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001c033c; // ok: 28, 828 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025f5628; // ok: 9 (10,- 1), 501 (543 - 41,- 1), 6 (16:10), 40 (41,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1280x800_VGA_PVR], fbuffer_color_mode);
 }
 
 // 1280x960 @ 60Hz (4:3, DMT) - PVR 32x32
@@ -1572,129 +1064,15 @@ void STARTUP_1280x800_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.25x (exact)
 void STARTUP_1280x960_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 4.0f;
-  STARTUP_video_params.video_scale_multiplier = 0.25f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1280;
-  STARTUP_video_params.video_height = 960;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1800 wide scaled to 450 wide (field)
-  // 1280 wide scaled to 320 wide (visible frame)
-  uint32_t horiz_active_area = 320;
-  uint32_t vert_active_area = 960;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000006a; // ok: 106 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00270027; // ok: 39 & 39 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01aa0000; // ok: 426 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x002703e7; // ok: 39, 999 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006a01aa; // ok: 106, 426 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x03e701c1; // ok: 449x999 (450x1000) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x002703e7; // ok: 39, 999 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x019a531b; // ok: 6 (7,- 1), 421 (450 - 28,- 1), 3 (DMT/GTF/legacy), 27 (28,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
-}
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1280x960_VGA], fbuffer_color_mode);
+}
 
 // 1440x900 @ 60Hz (16:10, DMT & CVT)
 // Framebuffer: 365x900
 // Horizontal scale: 0.253472222x
 void STARTUP_1440x900_VGA(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1440.0f / 365.0f;
-  STARTUP_video_params.video_scale_multiplier = 365.0f / 1440.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1440;
-  STARTUP_video_params.video_height = 900;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1904 wide scaled to 483 wide (field)
-  // 1440 wide scaled to 365 wide (visible frame)
-  uint32_t horiz_active_area = 365;
-  uint32_t vert_active_area = 900;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000062; // ok: 98 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001f001f; // ok: 31 & 31 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01cf0000; // ok: 463 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001f03a3; // ok: 31, 931 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006201cf; // ok: 98, 463 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x03a501e2; // ok: 482x933 (483x934) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001f03a3; // ok: 31, 931 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025bc626; // ok: 9 (10,- 1), 444 (483 - 38,- 1), 6 (16:10), 38 (39,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1440x900_VGA], fbuffer_color_mode);
 }
 
 // 1440x900 @ 60Hz (16:10, DMT & CVT) - PVR 32x32
@@ -1705,66 +1083,7 @@ void STARTUP_1440x900_VGA(uint8_t fbuffer_color_mode)
 // the horizontal sides and 4 rows of blank pixels on the vertical sides.
 void STARTUP_1440x900_VGA_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1440.0f / 352.0f;
-  STARTUP_video_params.video_scale_multiplier = 352.0f / 1440.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1440;
-  STARTUP_video_params.video_height = 900;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 1904 wide scaled to 483 wide (field)
-  // 1440 wide scaled to 365 wide (visible frame)
-  uint32_t horiz_active_area = 352;
-  uint32_t vert_active_area = 896;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 6 (back border), so h front porch side left by 7 appears to actually center the image
-    // Push down by 2 (back border), v front porch side up by 2 appears to actually center the image
-    *(volatile uint32_t*)0xa05f80ec = 0x00000068; // ok: 104 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00210021; // ok: 33 & 33 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01cf0000; // ok: 463 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001f03a3; // ok: 31, 931 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x006201cf; // ok: 98, 463 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x03a501e2; // ok: 482x933 (483x934) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001f03a3; // ok: 31, 931 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x025bc626; // ok: 9 (10,- 1), 444 (483 - 38,- 1), 6 (16:10), 38 (39,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1440x900_VGA_PVR], fbuffer_color_mode);
 }
 
 //------------------------------------------------------------------------------
@@ -1781,64 +1100,7 @@ void STARTUP_1440x900_VGA_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.85625x (exact)
 void STARTUP_640x480_VGA_75(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 640.0f / 548.0f;
-  STARTUP_video_params.video_scale_multiplier = 548.0f / 640.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 840 wide scaled to 720 wide (field)
-  // 640 wide scaled to 548 wide (visible frame)
-  uint32_t horiz_active_area = 548;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000009e; // ok: 158 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00130013; // ok: 19 & 19 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02c20000; // ok: 706 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001301f3; // ok: 19, 499 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x009e02c2; // ok: 158, 706 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01f302cf; // ok: 719x499 (720x500) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001301f3; // ok: 19, 499 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03698336; // ok: 13 (14,- 1), 664 (720 - 55,- 1), 3 (DMT/GTF/legacy), 54 (55,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_640x480_VGA_75], fbuffer_color_mode);
 }
 
 // 640x480 @ 75Hz (4:3, DMT) - PVR 32x32
@@ -1849,64 +1111,7 @@ void STARTUP_640x480_VGA_75(uint8_t fbuffer_color_mode)
 // one side).
 void STARTUP_640x480_VGA_75_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 640.0f / 544.0f;
-  STARTUP_video_params.video_scale_multiplier = 544.0f / 640.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 840 wide scaled to 720 wide (field)
-  // 640 wide scaled to 548 wide (visible frame)
-  uint32_t horiz_active_area = 544;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x000000a0; // ok: 160 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00130013; // ok: 19 & 19 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02c20000; // ok: 706 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001301f3; // ok: 19, 499 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x009e02c2; // ok: 158, 706 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01f302cf; // ok: 719x499 (720x500) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001301f3; // ok: 19, 499 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x03698336; // ok: 13 (14,- 1), 664 (720 - 55,- 1), 3 (DMT/GTF/legacy), 54 (55,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_640x480_VGA_75_PVR], fbuffer_color_mode);
 }
 
 // 800x600 @ 75Hz (4:3, DMT)
@@ -1914,64 +1119,7 @@ void STARTUP_640x480_VGA_75_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.545x (exact)
 void STARTUP_800x600_VGA_75(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 436.0f;
-  STARTUP_video_params.video_scale_multiplier = 436.0f / 800.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 1056 wide scaled to 576 wide (field)
-  // 800 wide scaled to 436 wide (visible frame)
-  uint32_t horiz_active_area = 436;
-  uint32_t vert_active_area = 600;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000083; // ok: 131 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00180018; // ok: 24 & 24 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02370000; // ok: 567 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00180270; // ok: 24, 624 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00830237; // ok: 131, 567 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x0270023f; // ok: 575x624 (576x625) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00180270; // ok: 24, 624 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x02a1332b; // ok: 10 (11,- 1), 531 (576 - 44,- 1), 3 (DMT/GTF/legacy), 43 (44,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_75], fbuffer_color_mode);
 }
 
 // 800x600 @ 75Hz (4:3, DMT) - PVR 32x32
@@ -1983,65 +1131,7 @@ void STARTUP_800x600_VGA_75(uint8_t fbuffer_color_mode)
 // vertical sides.
 void STARTUP_800x600_VGA_75_PVR(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 416.0f;
-  STARTUP_video_params.video_scale_multiplier = 416.0f / 800.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 1056 wide scaled to 576 wide (field)
-  // 800 wide scaled to 436 wide (visible frame)
-  uint32_t horiz_active_area = 416;
-  uint32_t vert_active_area = 608;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    // Push right by 10 (back border), so front porch side left by 10 appears to actually center the image
-    *(volatile uint32_t*)0xa05f80ec = 0x0000008d; // ok: 141 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00100010; // ok: 16 & 16 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02370000; // ok: 567 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00100270; // ok: 16, 624 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00830237; // ok: 131, 567 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x0270023f; // ok: 575x624 (576x625) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00100270; // ok: 16, 624 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x02a1332b; // ok: 10 (11,- 1), 531 (576 - 44,- 1), 3 (DMT/GTF/legacy), 43 (44,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_75_PVR], fbuffer_color_mode);
 }
 
 // 1024x768 @ 75Hz (4:3, DMT) - PVR 32x32
@@ -2049,64 +1139,7 @@ void STARTUP_800x600_VGA_75_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.34375x (exact)
 void STARTUP_1024x768_VGA_75(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1024.0f / 352.0f;
-  STARTUP_video_params.video_scale_multiplier = 352.0f / 1024.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1024;
-  STARTUP_video_params.video_height = 768;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 1312 wide scaled to 450 wide (field)
-  // 1024 wide scaled to 352 wide (visible frame)
-  uint32_t horiz_active_area = 352;
-  uint32_t vert_active_area = 768;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000005d; // ok: 93 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001f001f; // ok: 31 & 31 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01bd0000; // ok: 445 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001f031f; // ok: 31, 799 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x005d01bd; // ok: 93, 445 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x031f01c1; // ok: 449x799 (450x800) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001f031f; // ok: 31, 799 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x01da0320; // ok: 7 (8,- 1), 416 (450 - 33,- 1), 3 (DMT/GTF/legacy), 32 (33,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1024x768_VGA_75], fbuffer_color_mode);
 }
 
 // 1152x864 @ 75Hz (4:3, DMT) - PVR 32x32
@@ -2115,64 +1148,7 @@ void STARTUP_1024x768_VGA_75(uint8_t fbuffer_color_mode)
 // This is actually a standard, widely supported mode!
 void STARTUP_1152x864_VGA_75(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 4.0f;
-  STARTUP_video_params.video_scale_multiplier = 0.25f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1152;
-  STARTUP_video_params.video_height = 864;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 1600 wide scaled to 400 wide (field)
-  // 1152 wide scaled to 288 wide (visible frame)
-  uint32_t horiz_active_area = 288;
-  uint32_t vert_active_area = 864;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 75Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000060; // ok: 96 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00230023; // ok: 35 & 35 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01800000; // ok: 384 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00230383; // ok: 35, 899 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00600180; // ok: 96, 384 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x0383018f; // ok: 399x899 (400x900) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00230383; // ok: 35, 899 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x01d6f31f; // ok: 7 (8,- 1), 367 (400 - 32,- 1), 3 (DMT/GTF/legacy), 31 (32,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1152x864_VGA_75], fbuffer_color_mode);
 }
 
 //------------------------------------------------------------------------------
@@ -2186,202 +1162,31 @@ void STARTUP_1152x864_VGA_75(uint8_t fbuffer_color_mode)
 // correct, though.
 //
 
-// 480p @ 120Hz (4:3, CTA-861, 720x480) - for HDTVs - PVR 32x32
-// Framebuffer: 320x480
-// Horizontal scale: 0.5x (exact)
-void STARTUP_480p_VGA_120(uint8_t fbuffer_color_mode)
-{
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 2.0f;
-  STARTUP_video_params.video_scale_multiplier = 0.5f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 120;
-
-  // 858 wide scaled to 429 wide (field)
-  // 640 wide scaled to 320 wide (visible frame)
-  uint32_t horiz_active_area = 320;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000054; // ok: 84 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00280028; // ok: 40 & 40 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01a30000; // ok: 419 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00150208; // ok: 21, 520 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x003f01a3; // ok: 63, 419 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x020c01ac; // ok: 428x524 (429x525) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00150208; // ok: 40, 520 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x01d8c41f; // ok: 7 (8,- 1), 396 (429 - 32,- 1), 4 (4:3), 31 (32,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
-}
-
-// 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120
-// Framebuffer: 354x480
-// Horizontal scale: 0.553125x (exact)
-void STARTUP_640x480_VGA_120(uint8_t fbuffer_color_mode)
-{
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 640.0f / 354.0f;
-  STARTUP_video_params.video_scale_multiplier = 354.0f / 640.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 120;
-
-  // 800 wide scaled to 443 wide (field)
-  // 640 wide scaled to 354 wide (visible frame)
-  uint32_t horiz_active_area = 354;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000003e; // ok: 62 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001a001a; // ok: 26 & 26 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01a00000; // ok: 416 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001a01fa; // ok: 26, 506 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x003e01a0; // ok: 62, 416 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01fc01ba; // ok: 442x508 (443x509) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001a01fa; // ok: 26, 506 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00da8411; // ok: 3 (4,- 1), 424 (443 - 18,- 1), 4 (4:3), 17 (18,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
-}
-
-// 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120 - PVR 32x32
-// Framebuffer: 352x480
-// Horizontal scale: 0.55x (exact)
-// This mode has been shrunken by 2 columns for 32x32 framebuffer compatibility.
-// As a result, there may be 2 columns of blank pixels (1 on either side or 2 on
-// one side).
-void STARTUP_640x480_VGA_120_PVR(uint8_t fbuffer_color_mode)
-{
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 640.0f / 352.0f;
-  STARTUP_video_params.video_scale_multiplier = 352.0f / 640.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 120;
-
-  // 800 wide scaled to 443 wide (field)
-  // 640 wide scaled to 354 wide (visible frame)
-  uint32_t horiz_active_area = 352;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000003f; // ok: 63 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x001a001a; // ok: 26 & 26 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01a00000; // ok: 416 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x001a01fa; // ok: 26, 506 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x003e01a0; // ok: 62, 416 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01fc01ba; // ok: 442x508 (443x509) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x001a01fa; // ok: 26, 506 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00da8411; // ok: 3 (4,- 1), 424 (443 - 18,- 1), 4 (4:3), 17 (18,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
+// 480p @ 120Hz (4:3, CTA-861, 720x480) - for HDTVs - PVR 32x32
+// Framebuffer: 320x480
+// Horizontal scale: 0.5x (exact)
+void STARTUP_480p_VGA_120(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_480p_VGA_120], fbuffer_color_mode);
+}
 
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
+// 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120
+// Framebuffer: 354x480
+// Horizontal scale: 0.553125x (exact)
+void STARTUP_640x480_VGA_120(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_640x480_VGA_120], fbuffer_color_mode);
+}
 
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+// 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120 - PVR 32x32
+// Framebuffer: 352x480
+// Horizontal scale: 0.55x (exact)
+// This mode has been shrunken by 2 columns for 32x32 framebuffer compatibility.
+// As a result, there may be 2 columns of blank pixels (1 on either side or 2 on
+// one side).
+void STARTUP_640x480_VGA_120_PVR(uint8_t fbuffer_color_mode)
+{
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_640x480_VGA_120_PVR], fbuffer_color_mode);
 }
 
 // 800x600 @ 120Hz (4:3, DMT & CVT, RB)
@@ -2389,64 +1194,7 @@ void STARTUP_640x480_VGA_120_PVR(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.36875x (exact)
 void STARTUP_800x600_VGA_120(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 800.0f / 295.0f;
-  STARTUP_video_params.video_scale_multiplier = 295.0f / 800.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 800;
-  STARTUP_video_params.video_height = 600;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 120;
-
-  // 960 wide scaled to 354 wide (field)
-  // 800 wide scaled to 295 wide (visible frame)
-  uint32_t horiz_active_area = 295;
-  uint32_t vert_active_area = 600;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000029; // ok: 41 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00210021; // ok: 33 & 33 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x01500000; // ok: 336 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00210279; // ok: 33, 633 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00290150; // ok: 41, 336 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x027b0161; // ok: 353x635 (354x636) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00210279; // ok: 33, 633 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x0095540b; // ok: 2 (3,- 1), 341 (354 - 12,- 1), 4 (4:3), 11 (12,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_800x600_VGA_120], fbuffer_color_mode);
 }
 
 // 1024x768 @ 120Hz (4:3, DMT & CVT, RB)
@@ -2454,64 +1202,7 @@ void STARTUP_800x600_VGA_120(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.233398438x
 void STARTUP_1024x768_VGA_120(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1024.0f / 239.0f;
-  STARTUP_video_params.video_scale_multiplier = 239.0f / 1024.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 1024;
-  STARTUP_video_params.video_height = 768;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 120;
-
-  // 1184 wide scaled to 277 wide (field)
-  // 1024 wide scaled to 239 wide (visible frame)
-  uint32_t horiz_active_area = 239;
-  uint32_t vert_active_area = 768;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000011; // ok: 17 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x002a002a; // ok: 42 & 42 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x010a0000; // ok: 266 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x002a032a; // ok: 42, 810 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x0011010a; // ok: 17, 266 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x032c0114; // ok: 276x812 (277x813) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x002a032a; // ok: 42, 810 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x0050c407; // ok: 1 (2,- 1), 268 (277 - 8,- 1), 4 (4:3), 7 (8,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_1024x768_VGA_120], fbuffer_color_mode);
 }
 
 //------------------------------------------------------------------------------
@@ -2535,64 +1226,7 @@ void STARTUP_1024x768_VGA_120(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.25x (exact)
 void STARTUP_480p_VGA_240(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 4.0f;
-  STARTUP_video_params.video_scale_multiplier = 0.25f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 240;
-
-  // 858 wide scaled to 214 wide (field)
-  // 640 wide scaled to 160 wide (visible frame)
-  uint32_t horiz_active_area = 160;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000002a; // ok: 42 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00280028; // ok: 40 & 40 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x00d10000; // ok: 209 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00150208; // ok: 21, 520 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x001f00d1; // ok: 31, 209 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x020c00d5; // ok: 213x524 (214x525) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00150208; // ok: 40, 520 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00cc540f; // ok: 3 (4,- 1), 197 (214 - 16,- 1), 4 (4:3), 15 (16,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_480p_VGA_240], fbuffer_color_mode);
 }
 
 // 480p @ 239.76Hz (4:3, CTA-861, 720x480) - PVR 32x32
@@ -2600,64 +1234,7 @@ void STARTUP_480p_VGA_240(uint8_t fbuffer_color_mode)
 // Horizontal scale: 0.25x (exact)
 void STARTUP_480p_VGA_239(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 4.0f;
-  STARTUP_video_params.video_scale_multiplier = 0.25f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 240;
-
-  // 858 wide scaled to 215 wide (field)
-  // 640 wide scaled to 160 wide (visible frame)
-  uint32_t horiz_active_area = 160;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000002a; // ok: 42 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x00280028; // ok: 40 & 40 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x00d10000; // ok: 209 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x00150208; // ok: 21, 520 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x002000d1; // ok: 32, 209 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x020c00d6; // ok: 214x524 (215x525) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x00150208; // ok: 40, 520 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x00cc540f; // ok: 3 (4,- 1), 197 (214 - 16,- 1), 4 (4:3), 15 (16,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_480p_VGA_239], fbuffer_color_mode);
 }
 
 //------------------------------------------------------------------------------
@@ -2678,64 +1255,7 @@ void STARTUP_480p_VGA_239(uint8_t fbuffer_color_mode)
 // Horizontal scale: 1.0x (exact)
 void STARTUP_640x480_VGA_75_CVT_RBv2(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
-  STARTUP_video_params.video_scale = 1.0f;
-  STARTUP_video_params.video_scale_multiplier = 1.0f;
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 640;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 75;
-
-  // 720 wide scaled to 723 wide (field) for 75.00 Hz
-  // visible frame unchanged
-  uint32_t horiz_active_area = 640;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x0000004a; // ok: 74 ? 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x000e000e; // ok: 14 & 14 ? 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x02ca0000; // ok: 714 ? 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x000e01ee; // ok: 14, 494 ? 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x004a02ca; // ok: 74, 714 ? 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01f102d2; // ok: 722x497 (723x498) ? 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x000e01ee; // ok: 14, 494 ? 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x01eb281f; // ok: 7 (8,- 1), 690 (723 - 32,- 1), 8 (CVT), 31 (32,- 1) ? 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_640x480_VGA_75_CVT_RBv2], fbuffer_color_mode);
 }
 
 // 848x480 @ 60Hz (16:9, CVT, RBv2) - PVR 32x32
@@ -2745,68 +1265,10 @@ void STARTUP_640x480_VGA_75_CVT_RBv2(uint8_t fbuffer_color_mode)
 // Only took 15 years for the right standard to come along!
 void STARTUP_848x480_VGA_CVT_RBv2(uint8_t fbuffer_color_mode)
 {
-  // Set global scale factors
+  STARTUP_Set_Video_Mode(&STARTUP_video_timings[VIDEO_TIMING_848x480_VGA_CVT_RBv2], fbuffer_color_mode);
 #ifdef WIDESCREEN_SCALE_1X
+  // Treat this as a native 1.0x mode
   STARTUP_video_params.video_scale = 1.0f;
   STARTUP_video_params.video_scale_multiplier = 1.0f;
-#else
-  STARTUP_video_params.video_scale = 848.0f / 832.0f;
-  STARTUP_video_params.video_scale_multiplier = 832.0f / 848.0f;
 #endif
-
-  // Set global video output mode parameters
-  STARTUP_video_params.video_width = 848;
-  STARTUP_video_params.video_height = 480;
-  STARTUP_video_params.video_color_type = fbuffer_color_mode;
-  STARTUP_video_params.video_refresh_rate = 60;
-
-  // 928 wide scaled to 909 wide (field)
-  // 848 wide scaled to 832 wide (visible frame)
-  // Perfect for the DC because the DC does 32x32 tiles.
-  uint32_t horiz_active_area = 832;
-  uint32_t vert_active_area = 480;
-  // {RGB0555, RGB565} = 2Bpp, {RGB888} = 3Bpp, {RGB0888} = 4Bpp
-  uint32_t bpp_mode_size = fbuffer_color_mode + 1 + (0x1 ^ ((fbuffer_color_mode & 0x1) | (fbuffer_color_mode >> 1))); // Add another 1 only if 0b00
-
-  // Set global framebuffer parameters
-  STARTUP_video_params.fb_width = horiz_active_area;
-  STARTUP_video_params.fb_height = vert_active_area;
-  STARTUP_video_params.fb_color_bytes = bpp_mode_size;
-
-  if(!cable_mode) // VGA 848x480 @ 60Hz
-  {
-    *(volatile uint32_t*)0xa05f80e8 = 0x00160008;
-    *(volatile uint32_t*)0xa05f8044 = 0x00800000 | (fbuffer_color_mode << 2);
-
-    *(volatile uint32_t*)0xa05f804c = (horiz_active_area * bpp_mode_size) / 8; // for PVR to know active area width
-    *(volatile uint32_t*)0xa05f8040 = 0x00000000; // Border color in RGB0888 format (this mode has no border)
-    *(volatile uint32_t*)0xa05f805c = (1 << 20) | ((vert_active_area - 1) << 10) | (((horiz_active_area * bpp_mode_size) / 4) - 1); // progressive scan has a 1 since no lines are skipped
-
-    *(volatile uint32_t*)0xa05f80ec = 0x00000045; // ok: 69 ? mod: 68. CVT-RBv2: 72. Using 10 (no, 20).. Using 7 (no, 23). 168, default: 0x000000a8 (horiz)
-    *(volatile uint32_t*)0xa05f80f0 = 0x000e000e; // ok: 14 & 14 ? new: 11 & 11.. CVT-RBv2: 14 & 14. Using 31 & 31.. 40 & 40, default: 0x00280028 (vert)
-    *(volatile uint32_t*)0xa05f80c8 = 0x03850000; // ok: 901 ? mod: 900. CVT-RBv2: 920. Using 858 (no, 868; nah, 871).. Using 855. 837, default: 0x03450000 (horiz)
-    *(volatile uint32_t*)0xa05f80cc = 0x000e01ee; // ok: 14, 494 ? new: 11, 491.. CVT-RBv2: 14, 494. Using 21, 511.. Using 21, 512. 21, 520, default: 0x00150208 (vert)
-    *(volatile uint32_t*)0xa05f80d0 = 0x00000100;
-    *(volatile uint32_t*)0xa05f80d4 = 0x00450385; // ok: 69, 901 ? mod: 68, 900. CVT-RBv2: 72, 920. Using 10, 858 (no, 20, 868; nah, 23, 871).. Using 7, 855. 126, 837, default: 0x007e0345 (horiz)
-    *(volatile uint32_t*)0xa05f80d8 = 0x01ee038c; // ok: 908x494 (909x495) ? new: 906x493 (907x494).. mod: 906x494 (907x495) CVT-RBv2: 927x494 (928x495). May need to fudge with horiz scale for 27MHz. VESA: 1088x517, our max is 870x516 (871x517). 857x524 (858x525), default: 0x020c0359
-    *(volatile uint32_t*)0xa05f80dc = 0x000e01ee; // ok: 14, 494 ? new: 11, 491.. CVT-RBv2: 14, 494. Using 31, 511.. Using 40, 512. 40, 520, default: 0x00280208 (vert)
-    *(volatile uint32_t*)0xa05f80e0 = 0x01f6d81e; // ok: 7 (8,- 1), 877 (909 - 31,- 1), 8 (CVT), 30 (31,- 1) ? new: 7, 875 (907 - 31 - 1), 5 (for 16:9), 30.. mod: 7, 875 (907 - 31 - 1), 8, 30. CVT-RBv2: 15, 895 (928 - 32 - 1), 8, 31. Using 15, 854, 8, 15.. Using 15, 854, 3, 15. 15, 793, 3, 63, default: 0x03f1933f
-
-    uint32_t scan_area_size = horiz_active_area * vert_active_area;
-    uint32_t scan_area_size_bytes = scan_area_size * bpp_mode_size; // This will always be divisible by 4
-
-    // Reset framebuffer address
-    *(volatile uint32_t*)0xa05f8050 = 0x00000000; // BootROM sets this to 0x00200000 (framebuffer base is 0xa5000000 + this)
-    *(volatile uint32_t*)0xa05f8054 = 0x00000000; // Same for progressive, resetting the offset gets us 2MB VRAM back after BootROM is done with it
-
-    // zero out framebuffer area
-    for(uint32_t pixel_or_two = 0; pixel_or_two < scan_area_size_bytes; pixel_or_two += 4)
-    {
-      *(uint32_t*)(0xa5000000 + pixel_or_two) = 0;
-    }
-
-    // re-enable video
-    *(volatile uint32_t*)0xa05f80e8 &= ~8;
-    *(volatile uint32_t*)0xa05f8044 |= 1;
-  }
 }
@@ -0,0 +1,361 @@
+// ---- video_timings.c - Dreamcast Video Timing Table ----
+//
+// Version 1.0.0
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This support module is hereby released into the public domain in the hope that it
+// may prove useful.
+//
+// This file contains the timing table used by STARTUP_Set_Video_Mode() in
+// startup_support.c. It's plain data plus a lookup function, so it has no
+// hardware dependencies and can be compiled and checked on any machine.
+//
+
+#include "startup_support.h"
+
+// All horizontal values are in Dreamcast pixels (27MHz in VGA mode), so they're
+// already scaled for the analog video trick described in startup_support.h.
+// These are the same values the individual mode functions have always written
+// to the video registers.
+//
+// Columns:
+// video w, video h, refresh, fb w, fb h,
+// h total, v total, hblank start, hblank end, vblank start, vblank end,
+// vblank in int line, vblank out int line, start x, start y,
+// hsync width, vsync width, bp width, eq width
+const VIDEO_TIMING_STRUCT STARTUP_video_timings[VIDEO_TIMING_COUNT] = {
+  // 640x480 @ 60Hz (4:3, BootROM VGA timing, same as STARTUP_Set_Video())
+  [VIDEO_TIMING_640x480_VGA] = {640, 480, 60, 640, 480, 858, 525, 837, 126, 520, 40, 520, 21, 168, 40, 64, 3, 794, 16},
+  // 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync)
+  [VIDEO_TIMING_848x480_VGA] = {848, 480, 60, 678, 480, 870, 517, 857, 179, 511, 31, 511, 31, 179, 31, 64, 8, 806, 16},
+  // 848x480 @ 60Hz (16:9, DMT, but using a slightly-too-short hsync) - PVR 32x32
+  [VIDEO_TIMING_848x480_VGA_PVR] = {848, 480, 60, 672, 480, 870, 517, 857, 179, 511, 31, 511, 31, 182, 31, 64, 8, 806, 16},
+  // 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync)
+  [VIDEO_TIMING_800x600_VGA] = {800, 600, 60, 540, 600, 713, 628, 686, 146, 627, 27, 627, 27, 146, 27, 64, 4, 649, 16},
+  // 800x600 @ 60Hz (4:3, DMT, but using a slightly-too-short hsync) - PVR 32x32
+  [VIDEO_TIMING_800x600_VGA_PVR] = {800, 600, 60, 544, 608, 713, 628, 688, 144, 627, 19, 627, 19, 144, 19, 64, 4, 649, 16},
+  // 800x600 @ 60Hz (4:3, CVT)
+  [VIDEO_TIMING_800x600_VGA_CVT] = {800, 600, 60, 565, 600, 723, 624, 700, 135, 621, 21, 621, 21, 135, 21, 56, 4, 667, 14},
+  // 800x600 @ 60Hz (4:3, CVT) - PVR 32x32
+  [VIDEO_TIMING_800x600_VGA_CVT_PVR] = {800, 600, 60, 544, 608, 723, 624, 700, 135, 621, 13, 621, 13, 146, 13, 56, 4, 667, 14},
+  // 1024x768 @ 60Hz (4:3, DMT)
+  [VIDEO_TIMING_1024x768_VGA] = {1024, 768, 60, 425, 768, 558, 806, 548, 123, 803, 35, 803, 35, 123, 35, 56, 6, 502, 14},
+  // 1024x768 @ 60Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_1024x768_VGA_PVR] = {1024, 768, 60, 416, 768, 558, 806, 548, 123, 803, 35, 803, 35, 127, 35, 56, 6, 502, 14},
+  // 1152x864 @ 60Hz (4:3, CVT)
+  [VIDEO_TIMING_1152x864_VGA] = {1152, 864, 60, 380, 864, 502, 897, 481, 101, 894, 30, 894, 30, 101, 30, 40, 4, 462, 10},
+  // 1152x864 @ 60Hz (4:3, CVT) - PVR 32x32
+  [VIDEO_TIMING_1152x864_VGA_PVR] = {1152, 864, 60, 384, 864, 502, 897, 483, 99, 894, 30, 894, 30, 99, 30, 40, 4, 462, 10},
+  // 720p60 (16:9, DMT & CTA-861) - for HDTVs
+  [VIDEO_TIMING_720p_VGA] = {1280, 720, 60, 465, 720, 600, 750, 560, 95, 745, 25, 745, 25, 95, 25, 15, 5, 585, 4},
+  // 720p60 (16:9, DMT & CTA-861) - for HDTVs - PVR 32x32
+  [VIDEO_TIMING_720p_VGA_PVR] = {1280, 720, 60, 448, 704, 600, 750, 560, 95, 745, 25, 745, 25, 103, 33, 15, 5, 585, 4},
+  // 1280x720 (16:9, CVT) - for monitors that need this instead of HDTV 720p60
+  [VIDEO_TIMING_1280x720_VGA] = {1280, 720, 60, 464, 720, 603, 748, 580, 116, 745, 25, 745, 25, 116, 25, 46, 5, 557, 12},
+  // 1280x720 (16:9, CVT) - for monitors that need this instead of HDTV 720p60 - PVR 32x32
+  [VIDEO_TIMING_1280x720_VGA_PVR] = {1280, 720, 60, 448, 704, 603, 748, 580, 116, 745, 25, 745, 25, 124, 33, 46, 5, 557, 12},
+  // 1280x800 @ 60Hz (16:10, DMT & CVT)
+  [VIDEO_TIMING_1280x800_VGA] = {1280, 800, 60, 414, 800, 543, 831, 520, 106, 828, 28, 828, 28, 106, 28, 41, 6, 502, 10},
+  // 1280x800 @ 60Hz (16:10, DMT & CVT) - PVR 32x32
+  [VIDEO_TIMING_1280x800_VGA_PVR] = {1280, 800, 60, 416, 800, 543, 831, 521, 105, 828, 28, 828, 28, 105, 28, 41, 6, 502, 10},
+  // 1280x960 @ 60Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_1280x960_VGA] = {1280, 960, 60, 320, 960, 450, 1000, 426, 106, 999, 39, 999, 39, 106, 39, 28, 3, 422, 7},
+  // 1440x900 @ 60Hz (16:10, DMT & CVT)
+  [VIDEO_TIMING_1440x900_VGA] = {1440, 900, 60, 365, 900, 483, 934, 463, 98, 931, 31, 931, 31, 98, 31, 39, 6, 445, 10},
+  // 1440x900 @ 60Hz (16:10, DMT & CVT) - PVR 32x32
+  [VIDEO_TIMING_1440x900_VGA_PVR] = {1440, 900, 60, 352, 896, 483, 934, 463, 98, 931, 31, 931, 31, 104, 33, 39, 6, 445, 10},
+  // 640x480 @ 75Hz (4:3, DMT)
+  [VIDEO_TIMING_640x480_VGA_75] = {640, 480, 75, 548, 480, 720, 500, 706, 158, 499, 19, 499, 19, 158, 19, 55, 3, 665, 14},
+  // 640x480 @ 75Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_640x480_VGA_75_PVR] = {640, 480, 75, 544, 480, 720, 500, 706, 158, 499, 19, 499, 19, 160, 19, 55, 3, 665, 14},
+  // 800x600 @ 75Hz (4:3, DMT)
+  [VIDEO_TIMING_800x600_VGA_75] = {800, 600, 75, 436, 600, 576, 625, 567, 131, 624, 24, 624, 24, 131, 24, 44, 3, 532, 11},
+  // 800x600 @ 75Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_800x600_VGA_75_PVR] = {800, 600, 75, 416, 608, 576, 625, 567, 131, 624, 16, 624, 16, 141, 16, 44, 3, 532, 11},
+  // 1024x768 @ 75Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_1024x768_VGA_75] = {1024, 768, 75, 352, 768, 450, 800, 445, 93, 799, 31, 799, 31, 93, 31, 33, 3, 417, 8},
+  // 1152x864 @ 75Hz (4:3, DMT) - PVR 32x32
+  [VIDEO_TIMING_1152x864_VGA_75] = {1152, 864, 75, 288, 864, 400, 900, 384, 96, 899, 35, 899, 35, 96, 35, 32, 3, 368, 8},
+  // 480p @ 120Hz (4:3, CTA-861, 720x480) - for HDTVs - PVR 32x32
+  [VIDEO_TIMING_480p_VGA_120] = {640, 480, 120, 320, 480, 429, 525, 419, 63, 520, 21, 520, 21, 84, 40, 32, 4, 397, 8},
+  // 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120
+  [VIDEO_TIMING_640x480_VGA_120] = {640, 480, 120, 354, 480, 443, 509, 416, 62, 506, 26, 506, 26, 62, 26, 18, 4, 425, 4},
+  // 640x480 @ 120Hz (4:3, CVT, RB) - for monitors that need this instead of HDTV 480p120 - PVR 32x32
+  [VIDEO_TIMING_640x480_VGA_120_PVR] = {640, 480, 120, 352, 480, 443, 509, 416, 62, 506, 26, 506, 26, 63, 26, 18, 4, 425, 4},
+  // 800x600 @ 120Hz (4:3, DMT & CVT, RB)
+  [VIDEO_TIMING_800x600_VGA_120] = {800, 600, 120, 295, 600, 354, 636, 336, 41, 633, 33, 633, 33, 41, 33, 12, 4, 342, 3},
+  // 1024x768 @ 120Hz (4:3, DMT & CVT, RB)
+  [VIDEO_TIMING_1024x768_VGA_120] = {1024, 768, 120, 239, 768, 277, 813, 266, 17, 810, 42, 810, 42, 17, 42, 8, 4, 269, 2},
+  // 480p @ 240Hz (4:3, CTA-861, 720x480) - PVR 32x32
+  [VIDEO_TIMING_480p_VGA_240] = {640, 480, 240, 160, 480, 214, 525, 209, 31, 520, 21, 520, 21, 42, 40, 16, 4, 198, 4},
+  // 480p @ 239.76Hz (4:3, CTA-861, 720x480) - PVR 32x32
+  [VIDEO_TIMING_480p_VGA_239] = {640, 480, 239, 160, 480, 215, 525, 209, 32, 520, 21, 520, 21, 42, 40, 16, 4, 198, 4},
+  // 640x480 @ 75Hz (4:3, CVT, RBv2) - PVR 32x32
+  [VIDEO_TIMING_640x480_VGA_75_CVT_RBv2] = {640, 480, 75, 640, 480, 723, 498, 714, 74, 494, 14, 494, 14, 74, 14, 32, 8, 691, 8},
+  // 848x480 @ 60Hz (16:9, CVT, RBv2) - PVR 32x32
+  [VIDEO_TIMING_848x480_VGA_CVT_RBv2] = {848, 480, 60, 832, 480, 909, 495, 901, 69, 494, 14, 494, 14, 69, 14, 31, 8, 878, 8},
+};
+
+const VIDEO_TIMING_STRUCT * STARTUP_Find_Video_Timing(uint32_t video_width, uint32_t video_height, uint32_t refresh_rate, uint32_t pvr_32x32)
+{
+  for(uint32_t mode = 0; mode < VIDEO_TIMING_COUNT; mode++)
+  {
+    const VIDEO_TIMING_STRUCT * timing = &STARTUP_video_timings[mode];
+
+    if(
+      (timing->video_width == video_width)
+      &&
+      (timing->video_height == video_height)
+      &&
+      (timing->refresh_rate == refresh_rate)
+      &&
+      ( (!pvr_32x32) || ( !((timing->fb_width | timing->fb_height) & 0x1f) ) )
+    )
+    {
+      return timing;
+    }
+  }
+
+  return (const VIDEO_TIMING_STRUCT*)0;
+}
+
+//------------------------------------------------------------------------------
+// CVT Timing Generator
+//------------------------------------------------------------------------------
+//
+// This follows the VESA Coordinated Video Timings (CVT) 1.2 formulas to make
+// timings for the display, and then shrinks everything horizontal by
+// 27MHz / (CVT pixel clock), the same way the hand-made modes above were made.
+// The vertical timings don't need to change, since the Dreamcast's line rate
+// ends up the same as the display expects.
+//
+// The Dreamcast counts lines starting from vsync and pixels starting from hsync,
+// so the active area starts right after the back porch in both directions.
+//
+
+// Dreamcast pixel clock in VGA mode (MHz)
+#define CVT_DC_PIXEL_CLOCK 27.0f
+
+// Register limits: 10-bit line and pixel counters, 4-bit vsync width, and a
+// hsync width that tops out at 64 pixels
+#define CVT_MAX_TOTAL 1024
+#define CVT_MAX_HSYNC 64
+#define CVT_MAX_VSYNC 15
+
+// Minimum vsync + back porch time for standard CVT, and minimum vertical
+// blanking time for reduced blanking (microseconds)
+#define CVT_MIN_VSYNC_BP 550.0f
+#define CVT_RB_MIN_VBLANK 460.0f
+
+// CVT vsync width, which also encodes the aspect ratio for the display
+static uint32_t cvt_vsync_width(uint32_t width, uint32_t height)
+{
+  float aspect = (float)(int32_t)width / (float)(int32_t)height;
+
+  // Within about 1%, since widths like 848 and 1366 aren't exactly 16:9
+  if((aspect > 1.32f) && (aspect < 1.35f)) // 4:3
+  {
+    return 4;
+  }
+  else if((aspect > 1.76f) && (aspect < 1.79f)) // 16:9
+  {
+    return 5;
+  }
+  else if((aspect > 1.59f) && (aspect < 1.61f)) // 16:10
+  {
+    return 6;
+  }
+  else if( ((aspect > 1.24f) && (aspect < 1.26f)) || ((aspect > 1.66f) && (aspect < 1.68f)) ) // 5:4 and 15:9
+  {
+    return 7;
+  }
+
+  return 10;
+}
+
+float STARTUP_Generate_Video_Timing(VIDEO_TIMING_STRUCT * timing, uint32_t width, uint32_t height, uint32_t refresh_rate, uint32_t cvt_type)
+{
+  if((!width) || (!height) || (!refresh_rate) || (cvt_type > CVT_RBV2))
+  {
+    return 0.0f;
+  }
+
+  float refresh = (float)(int32_t)refresh_rate;
+  float frame_period = 1000000.0f / refresh; // usec
+  int32_t active_lines = (int32_t)height;
+
+  // Display timings, in display pixels and lines
+  int32_t active_pixels;
+  int32_t h_total;
+  int32_t hsync;
+  int32_t h_back_porch;
+  int32_t vsync;
+  int32_t v_back_porch;
+  int32_t v_total;
+  float pixel_clock; // MHz
+
+  if(cvt_type == CVT_STANDARD)
+  {
+    // 8-pixel character cells
+    active_pixels = (int32_t)(width & ~7);
+    vsync = (int32_t)cvt_vsync_width(width, height);
+
+    // 3 line front porch, at least 6 lines of back porch
+    float h_period = (frame_period - CVT_MIN_VSYNC_BP) / (float)(active_lines + 3);
+    int32_t vsync_bp = (int32_t)(CVT_MIN_VSYNC_BP / h_period) + 1;
+    if(vsync_bp < vsync + 6)
+    {
+      vsync_bp = vsync + 6;
+    }
+    v_back_porch = vsync_bp - vsync;
+    v_total = active_lines + vsync_bp + 3;
+
+    // Blanking is a duty cycle of the line period (C' = 30, M' = 300), in
+    // multiples of 2 cells
+    float duty_cycle = 30.0f - (300.0f * h_period / 1000.0f);
+    if(duty_cycle < 20.0f)
+    {
+      duty_cycle = 20.0f;
+    }
+    int32_t h_blank = (int32_t)((float)active_pixels * duty_cycle / (100.0f - duty_cycle) / 16.0f) * 16;
+    h_total = active_pixels + h_blank;
+
+    // 0.25MHz clock steps
+    pixel_clock = 0.25f * (float)(int32_t)((float)h_total / h_period / 0.25f);
+
+    // 8% hsync, with the sync ending in the middle of the blanking period
+    hsync = (int32_t)(0.08f * (float)h_total / 8.0f) * 8;
+    h_back_porch = h_blank / 2;
+  }
+  else
+  {
+    int32_t v_front_porch;
+
+    if(cvt_type == CVT_RB)
+    {
+      active_pixels = (int32_t)(width & ~7);
+      vsync = (int32_t)cvt_vsync_width(width, height);
+      // Fixed 160 pixel blanking: 48 front porch, 32 sync, 80 back porch
+      h_total = active_pixels + 160;
+      hsync = 32;
+      h_back_porch = 80;
+      v_front_porch = 3;
+    }
+    else // CVT_RBV2
+    {
+      active_pixels = (int32_t)width;
+      vsync = 8;
+      // Fixed 80 pixel blanking: 8 front porch, 32 sync, 40 back porch
+      h_total = active_pixels + 80;
+      hsync = 32;
+      h_back_porch = 40;
+      v_front_porch = 1;
+    }
+
+    float h_period = (frame_period - CVT_RB_MIN_VBLANK) / (float)active_lines;
+    int32_t vblank_lines = (int32_t)(CVT_RB_MIN_VBLANK / h_period) + 1;
+    if(vblank_lines < v_front_porch + vsync + 6)
+    {
+      vblank_lines = v_front_porch + vsync + 6;
+    }
+    v_total = active_lines + vblank_lines;
+
+    if(cvt_type == CVT_RB)
+    {
+      // Extra blanking goes to the back porch, and the clock is in 0.25MHz steps
+      v_back_porch = vblank_lines - v_front_porch - vsync;
+      pixel_clock = 0.25f * (float)(int32_t)(refresh * (float)v_total * (float)h_total / 1000000.0f / 0.25f);
+    }
+    else
+    {
+      // Extra blanking goes to the front porch, and the clock is in 1kHz steps
+      v_back_porch = 6;
+      pixel_clock = 0.001f * (float)(int32_t)(refresh * (float)v_total * (float)h_total / 1000000.0f / 0.001f);
+    }
+  }
+
+  // Widths under one 8-pixel cell leave nothing to scale, and a clock that
+  // rounded down to 0 can't be divided by
+  if((active_pixels <= 0) || (!(pixel_clock > 0.0f)))
+  {
+    return 0.0f;
+  }
+
+  //
+  // Now squish it to fit the Dreamcast's 27MHz pixel clock
+  //
+
+  float scale = CVT_DC_PIXEL_CLOCK / pixel_clock;
+
+  // Each part is rounded on its own, and the back porch starts after the whole
+  // hsync even if it gets capped below. That's how the table's CVT modes were
+  // made.
+  int32_t dc_h_total = (int32_t)((float)h_total * scale + 0.5f);
+  int32_t dc_hsync = (int32_t)((float)hsync * scale + 0.5f);
+  int32_t dc_hblank_end = dc_hsync + (int32_t)((float)h_back_porch * scale + 0.5f);
+  int32_t dc_active = (int32_t)((float)active_pixels * scale + 0.5f);
+
+  // The framebuffer can't be any wider than the mode. If the display's pixel
+  // clock is below 27MHz, the extra Dreamcast pixels just go to blanking.
+  if(dc_active > active_pixels)
+  {
+    dc_active = active_pixels;
+  }
+
+  if(dc_hsync > CVT_MAX_HSYNC)
+  {
+    dc_hsync = CVT_MAX_HSYNC;
+  }
+
+  int32_t dc_hblank_start = dc_hblank_end + dc_active;
+  int32_t vblank_end = vsync + v_back_porch;
+  int32_t vblank_start = vblank_end + active_lines;
+
+  if(
+    (dc_h_total > CVT_MAX_TOTAL)
+    ||
+    (v_total > CVT_MAX_TOTAL)
+    ||
+    (vsync > CVT_MAX_VSYNC)
+    ||
+    (dc_hsync < 4)
+    ||
+    (dc_active <= 0)
+    ||
+    (dc_hblank_start >= dc_h_total)
+  )
+  {
+    return 0.0f;
+  }
+
+  timing->video_width = (uint16_t)width;
+  timing->video_height = (uint16_t)height;
+  timing->refresh_rate = (uint16_t)refresh_rate;
+  timing->fb_width = (uint16_t)dc_active;
+  timing->fb_height = (uint16_t)height;
+  timing->h_total = (uint16_t)dc_h_total;
+  timing->v_total = (uint16_t)v_total;
+  timing->hblank_start = (uint16_t)dc_hblank_start;
+  timing->hblank_end = (uint16_t)dc_hblank_end;
+  timing->vblank_start = (uint16_t)vblank_start;
+  timing->vblank_end = (uint16_t)vblank_end;
+  timing->vblank_in_line = (uint16_t)vblank_start;
+  timing->vblank_out_line = (uint16_t)vblank_end;
+  timing->start_x = (uint16_t)dc_hblank_end;
+  timing->start_y = (uint16_t)vblank_end;
+  timing->hsync_width = (uint16_t)dc_hsync;
+  timing->vsync_width = (uint16_t)vsync;
+  timing->bp_width = (uint16_t)(dc_h_total - dc_hsync);
+  // A quarter of the hsync, rounded to nearest with ties to even
+  uint32_t eq_width = (uint32_t)dc_hsync >> 2;
+  if((((uint32_t)dc_hsync & 0x3) > 2) || ((((uint32_t)dc_hsync & 0x3) == 2) && (eq_width & 0x1)))
+  {
+    eq_width++;
+  }
+  timing->eq_width = (uint16_t)eq_width;
+
+  return (float)(int32_t)width / (float)dc_active;
+}
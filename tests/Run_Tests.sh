@@ -0,0 +1,70 @@
+#!/bin/bash
+#
+# Host Test Script
+#
+#
+# Made with special permission for DreamHAL.
+#
+
+#
+# set +v disables displaying all of the code you see here in the command line
+#
+
+set +v
+
+#
+# Each tests/*_test.c is a standalone host program. It gets built with the
+# host's GCC against the module or startup file named in its TEST_SOURCES line
+# (e.g. "// TEST_SOURCES: modules/rasterizer.c"), then run. A test passes if it
+# returns 0.
+#
+# Run this from the DreamHAL root folder (the one with Compile.sh in it).
+#
+# -fno-builtin is there because memfuncs.h declares DreamHAL's own memset() and
+# friends, whose types don't all match the host's built-in ones.
+#
+
+CurDir=$PWD
+HOST_GCC=gcc
+BuildDir=$CurDir/tests/build
+
+HFILES=-I$CurDir/inc/\ -I$CurDir/startup/\ -I$CurDir/modules/
+
+mkdir -p $BuildDir
+
+Failed=0
+
+for f in $CurDir/tests/*_test.c; do
+  name=$(basename "${f%.*}")
+  sources=$(sed -n 's|^// TEST_SOURCES: ||p' "$f")
+
+  echo
+  echo "Building $name..."
+
+  if ! $HOST_GCC -O2 --std=gnu11 $HFILES -fno-builtin -Wall -Wextra -Wdouble-promotion -Wpedantic -fsanitize=address,undefined -o "$BuildDir/$name" "$f" $(for s in $sources; do echo "$CurDir/$s"; done) -lm
+  then
+    echo "$name: build failed"
+    Failed=$((Failed + 1))
+    continue
+  fi
+
+  if ! "$BuildDir/$name"
+  then
+    Failed=$((Failed + 1))
+  fi
+done
+
+#
+# Display completion message and exit
+#
+
+echo
+
+if [ $Failed -ne 0 ]
+then
+  echo "$Failed test(s) failed."
+  exit 1
+fi
+
+echo "Done! All tests passed."
+echo
@@ -0,0 +1,692 @@
+// ---- print_test.c - Print Module Host Test ----
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This is a host program (see Run_Tests.sh) that checks the print module's
+// float and 64-bit formatting and its parsing functions against the host's C
+// library, and its cached formats against kvprintf(). It is hereby released
+// into the public domain in the hope that it may prove useful.
+//
+
+// TEST_SOURCES: modules/digits.c
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// print.c uses the same names as the host's C library, which is what it gets
+// checked against, so it's built right into this file with its names changed.
+#define printf dh_printf
+#define sprintf dh_sprintf
+#define snprintf dh_snprintf
+#define vprintf dh_vprintf
+#define vsprintf dh_vsprintf
+#define vsnprintf dh_vsnprintf
+#define strtoul dh_strtoul
+#define strtol dh_strtol
+#define strtof dh_strtof
+#define sscanf dh_sscanf
+#define vsscanf dh_vsscanf
+#define strlen dh_strlen
+#define ssize_t dh_ssize_t
+
+// fs_dcload.h casts pointers to 32-bit syscall arguments
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"
+#include "print.c"
+#pragma GCC diagnostic pop
+
+#undef printf
+#undef sprintf
+#undef snprintf
+#undef vprintf
+#undef vsprintf
+#undef vsnprintf
+#undef strtoul
+#undef strtol
+#undef strtof
+#undef sscanf
+#undef vsscanf
+#undef strlen
+#undef ssize_t
+
+// Nothing here goes through dcload or exits through startup.S
+int dcloadsyscall_wrapper(unsigned int syscall, unsigned int arg1, unsigned int arg2, unsigned int arg3)
+{
+  (void)syscall;
+  (void)arg1;
+  (void)arg2;
+  (void)arg3;
+
+  return 0;
+}
+
+uint32_t STARTUP_Add_Exit_Hook(STARTUP_EXIT_HOOK hook)
+{
+  (void)hook;
+
+  return 1;
+}
+
+// Parsing in base 10 reads whole aligned words (see print.h), so inputs are
+// copied into here instead of being parsed from string literals. There's
+// always room for the rest of the last word.
+static char test_input[256] __attribute__((aligned(4)));
+
+static uint32_t failures = 0;
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static char * test_copy(const char * input, uint32_t offset)
+{
+  memset(test_input, 0, sizeof(test_input));
+  memcpy(test_input + offset, input, strlen(input));
+
+  return test_input + offset;
+}
+
+static uint32_t float_to_bits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float bits_to_float(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static int leading_minus(const char * input)
+{
+  while(isspace(*input))
+  {
+    input++;
+  }
+
+  return *input == '-';
+}
+
+// The host's unsigned long is 64 bits, but the SH4's is 32
+static unsigned long reference_strtoul(const char * input, char ** endptr, int base)
+{
+  errno = 0;
+  unsigned long long value = strtoull(input, endptr, base);
+  unsigned long long magnitude = leading_minus(input) ? (0 - value) : value;
+
+  if((errno == ERANGE) || (magnitude > UINT32_MAX))
+  {
+    return UINT32_MAX;
+  }
+
+  return (uint32_t)value;
+}
+
+static long reference_strtol(const char * input, char ** endptr, int base)
+{
+  long long value = strtoll(input, endptr, base);
+
+  if(value > INT32_MAX)
+  {
+    return INT32_MAX;
+  }
+  if(value < INT32_MIN)
+  {
+    return INT32_MIN;
+  }
+
+  return (long)value;
+}
+
+//------------------------------------------------------------------------------
+// printf() floats and 64-bit ints
+//------------------------------------------------------------------------------
+
+// Floats get passed as doubles that hold a float's value, which is all there
+// is on the SH4
+static void check_printf(const char * format, ...)
+{
+  char expected[512];
+  char actual[512];
+  va_list ap, ap2;
+
+  va_start(ap, format);
+  va_copy(ap2, ap);
+  int expected_length = vsnprintf(expected, sizeof(expected), format, ap);
+  int actual_length = dh_vsnprintf(actual, sizeof(actual), format, ap2);
+  va_end(ap2);
+  va_end(ap);
+
+  if((actual_length != expected_length) || strcmp(actual, expected))
+  {
+    printf("FAIL: \"%s\": \"%s\" (%d), expected \"%s\" (%d)\n", format, actual, actual_length, expected, expected_length);
+    failures++;
+  }
+}
+
+static void test_printf(void)
+{
+  // Precision 0, which rounds half to even and drops the point
+  check_printf("%.0f %.0f %.0f %.0f %.0f", 0.5, 1.5, 2.5, 3.5, -0.5);
+  check_printf("%.0e %.0e %.0e", 0.5, 2.5, 15.0);
+  check_printf("%.0g %.0g %.0g", 0.5, 2.5, 15.0);
+  check_printf("%#.0f %#.0e %#.0g", 2.0, 2.0, 2.0);
+
+  // '#' keeps the point, and %g's trailing zeros
+  check_printf("%#g %#g %#g %#g", 1.0, 100.0, 0.0001, 123456789.0);
+  check_printf("%#.3g %#.3g %#.3g", 100.0, 1.0, 0.5);
+  check_printf("%#.1g %#.10g", 1.0, (double)0.1f);
+  check_printf("%g %g %g %g %g", 100000.0, 1000000.0, 0.0001, 0.00001, 0.0);
+
+  // Rounding that carries into the next digit
+  check_printf("%.3f", (double)9.9995f);
+  check_printf("%.2f %.2f %.1f %.1e", (double)9.995f, (double)0.125f, 9.96875, 9.96875);
+  check_printf("%.3g %.2g %g", 999.5, 99.5, 999999.5);
+  check_printf("%.3f %.3e", 0.0004999999, (double)1.0e-10f);
+
+  // inf and nan
+  check_printf("%f %F %e %E %g %G", (double)INFINITY, (double)INFINITY, (double)INFINITY, (double)INFINITY, (double)INFINITY, (double)INFINITY);
+  check_printf("%f %F %e %E %g %G", (double)-INFINITY, (double)-INFINITY, (double)-INFINITY, (double)-INFINITY, (double)-INFINITY, (double)-INFINITY);
+  check_printf("%f %F %e %E %g %G", (double)NAN, (double)NAN, (double)NAN, (double)NAN, (double)NAN, (double)NAN);
+  check_printf("%8f|%-8f|%+f|%08f", (double)INFINITY, (double)-INFINITY, (double)INFINITY, (double)NAN);
+
+  // Flags, widths, and signs
+  check_printf("%+08.2f|%-10e|%10.3g|%-+12.4E|%012G", 3.14159, -2.5, (double)1.0e-5f, 12345.0, -0.0625);
+  check_printf("%f %e %g %+f", -0.0, -0.0, -0.0, 0.0);
+  check_printf("%*.*f|%-*.*e", 12, 3, 2.75, 12, 2, -2.75);
+  check_printf("%.20f %.20e", (double)0.1f, (double)0.1f);
+  check_printf("%.64f", (double)1.0e-38f);
+  check_printf("%f %e %g", (double)3.40282347e38f, (double)3.40282347e38f, (double)3.40282347e38f);
+  check_printf("%f %e %g", (double)1.0e-45f, (double)1.0e-45f, (double)1.0e-45f);
+
+  // 64-bit ints
+  check_printf("%lld %lld %lld", (long long)INT64_MIN, (long long)INT64_MAX, 0LL);
+  check_printf("%d %d %hd %hhd", (int)INT32_MIN, (int)INT32_MAX, (int)INT16_MIN, (int)INT8_MIN);
+  check_printf("%llu %llx %llX %llo", (unsigned long long)UINT64_MAX, (unsigned long long)UINT64_MAX, 0x0123456789abcdefULL, (unsigned long long)UINT64_MAX);
+  check_printf("%25lld|%-25lld|%025lld|%.3lld", (long long)INT64_MIN, -1LL, (long long)INT64_MIN, -5LL);
+  check_printf("%#llx %#llo %.20lld %lld", 0xfedcba9876543210ULL, 8ULL, 12345LL, 1000000000LL);
+  // Powers of 3, up to 3^40, and their neighbours
+  uint64_t value = 1;
+  for(uint32_t i = 0; i <= 40; i++, value *= 3)
+  {
+    check_printf("%llu %lld %llx", (unsigned long long)value, -(long long)value, (unsigned long long)value);
+    check_printf("%llu %llu", (unsigned long long)(value - 1), (unsigned long long)(value * 10 - 1));
+    check_printf("%d %d %u", (int)value, -(int)(value & 0x7fffffff), (unsigned int)value);
+  }
+
+  // Floats in every binade, in every format
+  static const char * const formats[] = {
+    "%f", "%.0f", "%.3f", "%.9f", "%e", "%.0e", "%.3e", "%.8e", "%.12e", "%g",
+    "%.1g", "%.4g", "%.9g", "%#.6g", "%.17g"
+  };
+
+  for(uint64_t bits = 0; bits < 0x7f800000; bits += 65521)
+  {
+    double value = (double)bits_to_float((uint32_t)bits);
+
+    for(uint32_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+    {
+      check_printf(formats[i], value);
+      check_printf(formats[i], -value);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Cached formats
+//------------------------------------------------------------------------------
+
+// Both buffers start out the same and get compared whole, so a cached format
+// can't write a byte more or less than sprintf() (i.e. kvprintf()) does
+static void compare_cached(const char * format, const char * expected, int expected_length, const char * actual, int actual_length)
+{
+  if((actual_length != expected_length) || memcmp(actual, expected, 512))
+  {
+    printf("FAIL: cached \"%s\": \"%s\" (%d), expected \"%s\" (%d)\n", format, actual, actual_length, expected, expected_length);
+    failures++;
+  }
+}
+
+// Every use of this is its own PRINT_SPRINTF() call site with its own cache
+#define CHECK_CACHED(...) \
+  do { \
+    char expected_[512]; \
+    char actual_[512]; \
+    memset(expected_, 0x5a, sizeof(expected_)); \
+    memset(actual_, 0x5a, sizeof(actual_)); \
+    int expected_length_ = dh_sprintf(expected_, __VA_ARGS__); \
+    int actual_length_ = PRINT_SPRINTF(actual_, __VA_ARGS__); \
+    compare_cached(PRINT_FIRST_ARG(__VA_ARGS__), expected_, expected_length_, actual_, actual_length_); \
+  } while(0)
+
+// Same as above, but with a cache that's handed in
+#define CHECK_SHARED_CACHE(cache, ...) \
+  do { \
+    char expected_[512]; \
+    char actual_[512]; \
+    memset(expected_, 0x5a, sizeof(expected_)); \
+    memset(actual_, 0x5a, sizeof(actual_)); \
+    int expected_length_ = dh_sprintf(expected_, __VA_ARGS__); \
+    int actual_length_ = PRINT_Cached_Sprintf((cache), actual_, __VA_ARGS__); \
+    compare_cached(PRINT_FIRST_ARG(__VA_ARGS__), expected_, expected_length_, actual_, actual_length_); \
+  } while(0)
+
+static void test_cached(void)
+{
+  static const int ints[] = {0, 1, -1, 9, 10, -10, 12345, -99999, 1000000000, INT32_MAX, INT32_MIN};
+  static const char * const strings[] = {"", "a", "hello", "a longer string than the widths", NULL};
+  static const float floats[] = {0.0f, -0.0f, 0.5f, 1.0f, -2.5f, 3.14159265f, 9.9995f, 1.0e-7f, 123456.789f, 3.40282347e38f, INFINITY, NAN};
+
+  // The same call sites over and over with different arguments. The first
+  // time through parses each format, and the rest use what was parsed.
+  for(uint32_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++)
+  {
+    int value = ints[i];
+    const char * string = strings[i % (sizeof(strings) / sizeof(strings[0]))];
+    double number = (double)floats[i % (sizeof(floats) / sizeof(floats[0]))];
+    long long big = (long long)value * 1000000007LL;
+
+    // Plain fields, which are written straight into the buffer
+    CHECK_CACHED("%d", value);
+    CHECK_CACHED("%i%u%s", value, (unsigned int)value, string);
+    CHECK_CACHED("x=%d y=%d z=%u name=%s.", value, (int)(0u - (unsigned int)value), (unsigned int)value * 3u, string);
+
+    // Everything else, several fields to a format
+    CHECK_CACHED("%s=%d (0x%08x) %5.2f%%|%-6s|%c", string, value, (unsigned int)value, number, "ab", 'A' + (int)i);
+    CHECK_CACHED("[%5d|%-5d|%05d|%.3d|%8.3d|%-+4d]", value, value, value, value, value, value);
+    CHECK_CACHED("%x %X %#x %o %#o %08X", (unsigned int)value, (unsigned int)value, (unsigned int)value, (unsigned int)value, (unsigned int)value, (unsigned int)value);
+    CHECK_CACHED("%hd %hu %hhd %hhx %ld %lu", (short)value, (unsigned short)value, (signed char)value, (unsigned char)value, (long)value, (unsigned long)(unsigned int)value);
+    CHECK_CACHED("%lld %llu %llx %#llX %20lld|%-20llu|", big, (unsigned long long)big, (unsigned long long)big, (unsigned long long)big, big, (unsigned long long)big);
+    CHECK_CACHED("%f %e %g %E %G %F", number, number, number, number, number, number);
+    CHECK_CACHED("%.0f|%#.0e|%#g|%+.3f|%-12.4e|%012.3f", number, number, number, number, number, number);
+    CHECK_CACHED("%10s|%-10s|%.3s|%10.2s|%c%c|%3c|%-3c|", string, string, string, string, 'x', 'y', 'z', 'w');
+    CHECK_CACHED("%p %%", (void *)&ints[i]);
+
+    // PRINT_CACHE_FIELDS fields is as many as can be cached, and one more
+    // can't be
+    CHECK_CACHED("%d %d %d %d %d %d %d %d", value, 1, 2, 3, 4, 5, 6, value);
+    CHECK_CACHED("%d %d %d %d %d %d %d %d %d", value, 1, 2, 3, 4, 5, 6, 7, value);
+
+    // Neither can '*'
+    CHECK_CACHED("%*d|%-*.*f", (int)(i % 12), value, 10, (int)(i % 4), number);
+
+    // Nothing but text
+    CHECK_CACHED("no fields here");
+  }
+
+  // One cache, two formats: each change of format means parsing again, which
+  // mustn't leave anything of the other format behind
+  static PRINT_CACHE shared_cache;
+
+  for(uint32_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++)
+  {
+    int value = ints[i];
+    const char * string = strings[i % (sizeof(strings) / sizeof(strings[0]))];
+    double number = (double)floats[i % (sizeof(floats) / sizeof(floats[0]))];
+
+    CHECK_SHARED_CACHE(&shared_cache, "%d %s %8.3f %llx|", value, string, number, (unsigned long long)value);
+    CHECK_SHARED_CACHE(&shared_cache, "<%-6x>", (unsigned int)value);
+    CHECK_SHARED_CACHE(&shared_cache, "%d", value);
+    CHECK_SHARED_CACHE(&shared_cache, "%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, value);
+    CHECK_SHARED_CACHE(&shared_cache, "%u%s%c", (unsigned int)value, string, 'q');
+    CHECK_SHARED_CACHE(&shared_cache, "%*d", 6, value);
+    CHECK_SHARED_CACHE(&shared_cache, "%d", value);
+  }
+
+  // Make sure that last one really was cached
+  if(shared_cache.state != PRINT_CACHE_READY)
+  {
+    printf("FAIL: \"%%d\" wasn't cached\n");
+    failures++;
+  }
+}
+
+//------------------------------------------------------------------------------
+// strtoul() and strtol()
+//------------------------------------------------------------------------------
+
+static void check_strtol(const char * input, int base)
+{
+  // Every alignment, so that both the word-at-a-time and byte-at-a-time paths
+  // see every part of the input
+  for(uint32_t offset = 0; offset < 4; offset++)
+  {
+    char * in = test_copy(input, offset);
+    char * expected_end;
+    char * actual_end;
+
+    unsigned long expected_u = reference_strtoul(in, &expected_end, base);
+    unsigned long actual_u = dh_strtoul(in, &actual_end, base);
+
+    if((actual_u != expected_u) || (actual_end != expected_end))
+    {
+      printf("FAIL: strtoul(\"%s\", %d) at +%u: %lu ending at %td, expected %lu ending at %td\n", input, base, offset, actual_u, actual_end - in, expected_u, expected_end - in);
+      failures++;
+    }
+
+    long expected_s = reference_strtol(in, &expected_end, base);
+    long actual_s = dh_strtol(in, &actual_end, base);
+
+    if((actual_s != expected_s) || (actual_end != expected_end))
+    {
+      printf("FAIL: strtol(\"%s\", %d) at +%u: %ld ending at %td, expected %ld ending at %td\n", input, base, offset, actual_s, actual_end - in, expected_s, expected_end - in);
+      failures++;
+    }
+  }
+
+  // No endptr is fine too
+  if(dh_strtol(test_copy(input, 0), NULL, base) != reference_strtol(test_input, NULL, base))
+  {
+    printf("FAIL: strtol(\"%s\", %d) without endptr\n", input, base);
+    failures++;
+  }
+}
+
+static void test_strtol(void)
+{
+  static const char * const inputs[] = {
+    "0", "7", "123", "-123", "+42", "  \t\n+42abc", "00012345678", "1234.5",
+    // Saturation
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295",
+    "4294967296", "-4294967295", "-4294967296", "99999999999999999999",
+    "-99999999999999999999", "12345678901234567890123456789",
+    // Prefixes
+    "0x7fffffff", "0x80000000", "-0x80000000", "0X1f", "0xffffffff",
+    "0x100000000", "0x", "0xg", "0x 1", "077", "0777777777777", "08", "-0",
+    // Nothing to parse
+    "", "   ", "-", "+", "- 1", "z", "Zz", "~"
+  };
+  static const int bases[] = {0, 2, 8, 10, 16, 36};
+
+  for(uint32_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+  {
+    for(uint32_t j = 0; j < sizeof(bases) / sizeof(bases[0]); j++)
+    {
+      check_strtol(inputs[i], bases[j]);
+    }
+  }
+
+  // Bases that don't exist parse nothing. glibc leaves endptr alone then, so
+  // it can't be the reference.
+  static const int bad_bases[] = {-1, 1, 37};
+  for(uint32_t i = 0; i < sizeof(bad_bases) / sizeof(bad_bases[0]); i++)
+  {
+    char * in = test_copy("123", 0);
+    char * end = NULL;
+
+    if((dh_strtoul(in, &end, bad_bases[i]) != 0) || (end != in) || (dh_strtol(in, &end, bad_bases[i]) != 0) || (end != in))
+    {
+      printf("FAIL: strtol(\"123\", %d) should parse nothing\n", bad_bases[i]);
+      failures++;
+    }
+  }
+
+  // Every length of digit run, so 4-digit chunks end everywhere
+  char digits[32];
+  for(uint32_t length = 1; length < 24; length++)
+  {
+    for(uint32_t i = 0; i < length; i++)
+    {
+      digits[i] = (char)('1' + (i * 7) % 9);
+    }
+    digits[length] = ' ';
+    digits[length + 1] = '\0';
+
+    check_strtol(digits, 10);
+    check_strtol(digits, 0);
+  }
+}
+
+//------------------------------------------------------------------------------
+// strtof()
+//------------------------------------------------------------------------------
+
+static void check_strtof(const char * input)
+{
+  for(uint32_t offset = 0; offset < 4; offset++)
+  {
+    char * in = test_copy(input, offset);
+    char * expected_end;
+    char * actual_end;
+
+    float expected = strtof(in, &expected_end);
+    float actual = dh_strtof(in, &actual_end);
+
+    int same = isnan(expected) ? isnan(actual) : (float_to_bits(actual) == float_to_bits(expected));
+
+    if((!same) || (actual_end != expected_end))
+    {
+      printf("FAIL: strtof(\"%s\") at +%u: %.9g (0x%08x) ending at %td, expected %.9g (0x%08x) ending at %td\n", input, offset, (double)actual, float_to_bits(actual), actual_end - in, (double)expected, float_to_bits(expected), expected_end - in);
+      failures++;
+      return;
+    }
+  }
+}
+
+static void test_strtof(void)
+{
+  static const char * const inputs[] = {
+    "0", "-0", "1", "-1", "0.1", ".5", "5.", "1e10", "1E-10", "+1.5e+3xyz",
+    "  \t3.25", "123456789", "0.000001", "1e", "1e+", "1.5e-x", ".", "-.", "e5",
+    "-", "", "00000000000000000000000001.5", "1.000000000000000000000000000001",
+    // Halfway between two floats, which rounds to the even one
+    "16777217", "16777219", "16777217.000000000000000000001",
+    "0.500000029802322387695312500", "0.500000089406967163085937500",
+    "1.00000005960464477539062500", "1.000000059604644775390625000000001",
+    "1.0000000596046447753906249999999",
+    // Subnormals and underflow
+    "1e-45", "-1e-45", "1.4e-45", "7e-46", "7.006492321624085e-46",
+    "7.0064923216240862e-46", "7.0064923216240860e-46", "2.9387358770557188e-39",
+    "1.17549421e-38", "1.1754942e-38", "1.17549435e-38", "1.1754943508222875e-38",
+    "1e-50", "-1e-50", "1e-400",
+    // The top end and overflow
+    "3.4028235e38", "3.40282346638528859811704183484516925440e38",
+    "3.40282356779733661637539395458142568448e38",
+    "3.40282356779733661637539395458142568447e38", "3.4028236e38", "1e39",
+    "-1e39", "1e400", "123456789e30", "0.0000000001e48",
+    // inf and nan, in any case, and how much of them gets used
+    "inf", "-INF", "Inf", "infinity", "-Infinity", "INFINITYx", "infinit", "in",
+    "nan", "NAN", "-nan", "nanx", "na"
+  };
+
+  for(uint32_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+  {
+    check_strtof(inputs[i]);
+  }
+
+  // Hex floats aren't supported: the 0 parses and the 'x' is left
+  char * end;
+  float value = dh_strtof(test_copy("0x10", 0), &end);
+  if((value != 0.0f) || (end != test_input + 1))
+  {
+    printf("FAIL: strtof(\"0x10\") should stop at the x\n");
+    failures++;
+  }
+
+  // Floats in every binade, and the exact halfway points between them and the
+  // next float up, printed with few and many digits
+  char buffer[128];
+
+  for(uint64_t bits = 0; bits < 0x7f800000; bits += 65521)
+  {
+    float low = bits_to_float((uint32_t)bits);
+    float high = bits_to_float((uint32_t)bits + 1);
+    double halfway = ((double)low + (double)high) / 2.0;
+
+    static const int precisions[] = {2, 5, 8, 11, 16};
+    for(uint32_t i = 0; i < sizeof(precisions) / sizeof(precisions[0]); i++)
+    {
+      snprintf(buffer, sizeof(buffer), "%.*e", precisions[i], (double)low);
+      check_strtof(buffer);
+      snprintf(buffer, sizeof(buffer), "%.*e", precisions[i], halfway);
+      check_strtof(buffer);
+    }
+
+    // Exactly halfway, and just either side of it
+    snprintf(buffer, sizeof(buffer), "%.70e", halfway);
+    check_strtof(buffer);
+    snprintf(buffer, sizeof(buffer), "%.70e", nextafter(halfway, 0.0));
+    check_strtof(buffer);
+    snprintf(buffer, sizeof(buffer), "%.70e", nextafter(halfway, INFINITY));
+    check_strtof(buffer);
+
+    // Plain decimals too
+    snprintf(buffer, sizeof(buffer), "%.20f", (double)low);
+    check_strtof(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+// sscanf()
+//------------------------------------------------------------------------------
+
+static void check_sscanf_ints(const char * input, const char * format)
+{
+  int expected[3] = {-7, -7, -7};
+  int actual[3] = {-7, -7, -7};
+
+  int expected_count = sscanf(input, format, &expected[0], &expected[1], &expected[2]);
+  int actual_count = dh_sscanf(test_copy(input, 0), format, &actual[0], &actual[1], &actual[2]);
+
+  if((actual_count != expected_count) || memcmp(actual, expected, sizeof(actual)))
+  {
+    printf("FAIL: sscanf(\"%s\", \"%s\"): %d {%d, %d, %d}, expected %d {%d, %d, %d}\n", input, format, actual_count, actual[0], actual[1], actual[2], expected_count, expected[0], expected[1], expected[2]);
+    failures++;
+  }
+}
+
+static void check_sscanf_floats(const char * input, const char * format)
+{
+  float expected[3] = {-7.0f, -7.0f, -7.0f};
+  float actual[3] = {-7.0f, -7.0f, -7.0f};
+
+  int expected_count = sscanf(input, format, &expected[0], &expected[1], &expected[2]);
+  int actual_count = dh_sscanf(test_copy(input, 0), format, &actual[0], &actual[1], &actual[2]);
+
+  int same = (actual_count == expected_count);
+  for(uint32_t i = 0; i < 3; i++)
+  {
+    same &= isnan(expected[i]) ? isnan(actual[i]) : (float_to_bits(actual[i]) == float_to_bits(expected[i]));
+  }
+
+  if(!same)
+  {
+    printf("FAIL: sscanf(\"%s\", \"%s\"): %d {%g, %g, %g}, expected %d {%g, %g, %g}\n", input, format, actual_count, (double)actual[0], (double)actual[1], (double)actual[2], expected_count, (double)expected[0], (double)expected[1], (double)expected[2]);
+    failures++;
+  }
+}
+
+// Strings and characters. The buffers start out full of '#' since %c doesn't
+// add a terminator.
+static void check_sscanf_strings(const char * input, const char * format)
+{
+  char expected[2][16];
+  char actual[2][16];
+  memset(expected, '#', sizeof(expected));
+  memset(actual, '#', sizeof(actual));
+
+  int expected_count = sscanf(input, format, expected[0], expected[1]);
+  int actual_count = dh_sscanf(test_copy(input, 0), format, actual[0], actual[1]);
+
+  if((actual_count != expected_count) || memcmp(actual, expected, sizeof(actual)))
+  {
+    printf("FAIL: sscanf(\"%s\", \"%s\"): %d \"%.16s\" \"%.16s\", expected %d \"%.16s\" \"%.16s\"\n", input, format, actual_count, actual[0], actual[1], expected_count, expected[0], expected[1]);
+    failures++;
+  }
+}
+
+static void test_sscanf(void)
+{
+  // Return counts
+  check_sscanf_ints("1 2 3", "%d %d %d");
+  check_sscanf_ints("1 2", "%d %d %d");
+  check_sscanf_ints("1 x", "%d %d");
+  check_sscanf_ints("x", "%d");
+  check_sscanf_ints("", "%d");
+  check_sscanf_ints("   ", "%d");
+  check_sscanf_ints("12:34", "%d:%d");
+  check_sscanf_ints("12-34", "%d:%d");
+  check_sscanf_ints("12 : 34", "%d : %d");
+  check_sscanf_ints("5 6", "%*d %d");
+  check_sscanf_ints("7%", "%d%%");
+  check_sscanf_ints("7 %8", "%d %%%d");
+  check_sscanf_ints("42 ", "%d%n");
+  check_sscanf_ints("  42", "%n%d%n");
+  check_sscanf_ints("1", "%d %n");
+
+  // Widths
+  check_sscanf_ints("12345", "%3d%2d");
+  check_sscanf_ints("123456", "%2d%*2d%d");
+  check_sscanf_ints("-12345", "%3d%d");
+  check_sscanf_ints("  987654321", "%4d%4d%4d");
+  check_sscanf_ints("0x1f 0x1f", "%3i %i");
+  check_sscanf_ints("ffff", "%2x%x");
+  check_sscanf_ints("12345678901", "%10d%d");
+
+  // Bases and signs
+  check_sscanf_ints("0x1A 077 10", "%i %i %i");
+  check_sscanf_ints("-0x10 -010 -10", "%i %i %i");
+  check_sscanf_ints("ff 17 FF", "%x %o %X");
+  check_sscanf_ints("+7 -7", "%u %d");
+  check_sscanf_ints("2147483647 -2147483648", "%d %d");
+
+  check_sscanf_floats("3.14159 2.5e3", "%f %e");
+  check_sscanf_floats("3.14159", "%4f%f");
+  check_sscanf_floats("-1.5e-3,2", "%g,%f");
+  check_sscanf_floats("1e40 -1e-50 inf", "%f %f %f");
+  check_sscanf_floats("nan -INFINITY 0.1", "%G %E %F");
+  check_sscanf_floats("  .5 5. x", "%f %f %f");
+  check_sscanf_floats("1.25 2", "%*f %f");
+
+  check_sscanf_strings("hello world", "%s %s");
+  check_sscanf_strings("hello world", "%3s%s");
+  check_sscanf_strings("  hi", "%s");
+  check_sscanf_strings("abc", "%2c%c");
+  check_sscanf_strings("  x", "%c");
+  check_sscanf_strings("a b", "%c %c");
+  check_sscanf_strings("x", "%s %s");
+
+  // Length modifiers
+  signed char expected_char = 0, actual_char = 0;
+  short expected_short = 0, actual_short = 0;
+  double expected_double = 0.0, actual_double = 0.0;
+  unsigned long expected_long = 0, actual_long = 0;
+
+  int expected_count = sscanf("300 70000 0.1 4000000000", "%hhd %hd %lf %lu", &expected_char, &expected_short, &expected_double, &expected_long);
+  int actual_count = dh_sscanf(test_copy("300 70000 0.1 4000000000", 0), "%hhd %hd %lf %lu", &actual_char, &actual_short, &actual_double, &actual_long);
+
+  // The double only has a float's worth of precision
+  if((actual_count != expected_count) || (actual_char != expected_char) || (actual_short != expected_short) || (actual_double != (double)0.1f) || (actual_long != expected_long))
+  {
+    printf("FAIL: sscanf length modifiers: %d %d %d %.9g %lu\n", actual_count, actual_char, actual_short, actual_double, actual_long);
+    failures++;
+  }
+}
+
+int main(void)
+{
+  test_printf();
+  test_cached();
+  test_strtol();
+  test_strtof();
+  test_sscanf();
+
+  if(failures)
+  {
+    printf("print_test: %u failures\n", failures);
+    return 1;
+  }
+
+  printf("print_test: passed\n");
+  return 0;
+}
@@ -0,0 +1,232 @@
+// ---- rasterizer_test.c - Software Rasterizer Host Test ----
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This is a host program (see Run_Tests.sh) that draws into memory buffers with
+// the rasterizer module and compares the results against simple pixel-at-a-time
+// reference images. It is hereby released into the public domain in the hope
+// that it may prove useful.
+//
+
+// TEST_SOURCES: modules/rasterizer.c
+
+#include <stdio.h>
+#include <string.h>
+#include "startup_support.h"
+#include "rasterizer.h"
+
+// rasterizer.c refers to this for RAST_Init_Target_Video()
+VIDEO_PARAMS_STRUCT STARTUP_video_params;
+
+#define TEST_WIDTH 67
+#define TEST_HEIGHT 9
+// Bytes around the target that must never be touched. The test colors don't
+// have any bytes that match TEST_GUARD_BYTE.
+#define TEST_GUARD 16
+#define TEST_GUARD_BYTE 0x11
+// Room for the biggest target at any offset from 0 to 31
+#define TEST_BUFFER_BYTES (TEST_WIDTH * TEST_HEIGHT * 4 + 2 * TEST_GUARD + 32)
+
+static uint8_t test_buffer[TEST_BUFFER_BYTES] __attribute__((aligned(32)));
+static uint8_t reference_buffer[TEST_BUFFER_BYTES] __attribute__((aligned(32)));
+
+static uint32_t failures = 0;
+
+//------------------------------------------------------------------------------
+// Reference images
+//------------------------------------------------------------------------------
+
+static void reference_put(const RAST_TARGET_STRUCT * target, uint8_t * base, int32_t x, int32_t y, uint32_t color)
+{
+  if((uint32_t)x >= target->width || (uint32_t)y >= target->height)
+  {
+    return;
+  }
+
+  uint8_t * pixel = base + (uint32_t)y * target->pitch + (uint32_t)x * target->bytes_per_pixel;
+  for(uint32_t i = 0; i < target->bytes_per_pixel; i++)
+  {
+    pixel[i] = (uint8_t)(color >> (i << 3));
+  }
+}
+
+static void reference_rect(const RAST_TARGET_STRUCT * target, uint8_t * base, int32_t x, int32_t y, int32_t width, int32_t height, uint32_t color)
+{
+  for(int32_t row = y; row < y + height; row++)
+  {
+    for(int32_t column = x; column < x + width; column++)
+    {
+      reference_put(target, base, column, row, color);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+// Fresh target and reference, both filled with the guard byte. 'offset' moves
+// the start of the target off of a 32-byte boundary.
+static void test_setup(RAST_TARGET_STRUCT * target, RAST_TARGET_STRUCT * reference, uint32_t color_mode, uint32_t offset)
+{
+  memset(test_buffer, TEST_GUARD_BYTE, TEST_BUFFER_BYTES);
+  memset(reference_buffer, TEST_GUARD_BYTE, TEST_BUFFER_BYTES);
+
+  RAST_Init_Target_Buffer(target, test_buffer + TEST_GUARD + offset, TEST_WIDTH, TEST_HEIGHT, color_mode);
+  RAST_Init_Target_Buffer(reference, reference_buffer + TEST_GUARD + offset, TEST_WIDTH, TEST_HEIGHT, color_mode);
+}
+
+static void test_compare(const char * name, uint32_t color_mode, uint32_t offset, int32_t a, int32_t b)
+{
+  if(memcmp(test_buffer, reference_buffer, TEST_BUFFER_BYTES))
+  {
+    for(uint32_t i = 0; i < TEST_BUFFER_BYTES; i++)
+    {
+      if(test_buffer[i] != reference_buffer[i])
+      {
+        printf("FAIL: %s, mode %u, offset %u, args %d %d: byte %u is 0x%02x, expected 0x%02x\n", name, color_mode, offset, a, b, i, test_buffer[i], reference_buffer[i]);
+        break;
+      }
+    }
+    failures++;
+  }
+}
+
+// 16-bit colors only keep their low 16 bits
+static uint32_t test_color(uint32_t color_mode)
+{
+  return (FB_BYTES_PER_PIXEL(color_mode) == 2) ? 0xc3a5 : 0x00c3a55a;
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+
+// Every span start and length on one row, which covers every head, body, and
+// tail combination for every pixel size
+static void test_spans(uint32_t color_mode, uint32_t offset)
+{
+  RAST_TARGET_STRUCT target, reference;
+  uint32_t color = test_color(color_mode);
+
+  for(int32_t x0 = -2; x0 < TEST_WIDTH; x0++)
+  {
+    for(int32_t x1 = x0; x1 <= TEST_WIDTH + 2; x1++)
+    {
+      test_setup(&target, &reference, color_mode, offset);
+
+      RAST_Fill_Span(&target, x0, x1, 3, color);
+      reference_rect(&reference, reference.base, x0, 3, x1 - x0, 1, color);
+
+      test_compare("span", color_mode, offset, x0, x1);
+    }
+  }
+}
+
+static void test_rects(uint32_t color_mode, uint32_t offset)
+{
+  RAST_TARGET_STRUCT target, reference;
+  uint32_t color = test_color(color_mode);
+
+  for(int32_t x = -3; x < TEST_WIDTH; x += 5)
+  {
+    for(int32_t width = 0; width < TEST_WIDTH + 6; width += 3)
+    {
+      test_setup(&target, &reference, color_mode, offset);
+
+      RAST_Fill_Rect(&target, x, -1, width, TEST_HEIGHT, color);
+      reference_rect(&reference, reference.base, x, -1, width, TEST_HEIGHT, color);
+
+      test_compare("rect", color_mode, offset, x, width);
+    }
+  }
+
+  test_setup(&target, &reference, color_mode, offset);
+  RAST_Clear(&target, color);
+  reference_rect(&reference, reference.base, 0, 0, TEST_WIDTH, TEST_HEIGHT, color);
+  test_compare("clear", color_mode, offset, 0, 0);
+}
+
+static void test_pixels(uint32_t color_mode, uint32_t offset)
+{
+  RAST_TARGET_STRUCT target, reference;
+  uint32_t color = test_color(color_mode);
+
+  test_setup(&target, &reference, color_mode, offset);
+
+  for(int32_t y = -1; y <= TEST_HEIGHT; y++)
+  {
+    for(int32_t x = -1 - y; x <= TEST_WIDTH; x += 4)
+    {
+      RAST_Put_Pixel(&target, x, y, color);
+      reference_put(&reference, reference.base, x, y, color);
+    }
+  }
+
+  test_compare("pixels", color_mode, offset, 0, 0);
+}
+
+// Two triangles that split a rectangle along its diagonal have to cover it
+// exactly, with no pixel drawn twice
+static void test_shared_edge(uint32_t color_mode)
+{
+  RAST_TARGET_STRUCT target, reference;
+  uint32_t color = test_color(color_mode);
+  static uint8_t first[TEST_BUFFER_BYTES];
+
+  test_setup(&target, &reference, color_mode, 0);
+  RAST_Fill_Triangle(&target, 3.0f, 1.0f, 60.25f, 1.0f, 60.25f, 8.0f, color);
+  memcpy(first, test_buffer, TEST_BUFFER_BYTES);
+
+  test_setup(&target, &reference, color_mode, 0);
+  RAST_Fill_Triangle(&target, 3.0f, 1.0f, 3.0f, 8.0f, 60.25f, 8.0f, color);
+
+  for(uint32_t i = 0; i < TEST_BUFFER_BYTES; i++)
+  {
+    if((first[i] != TEST_GUARD_BYTE) && (test_buffer[i] != TEST_GUARD_BYTE))
+    {
+      printf("FAIL: triangles, mode %u: byte %u drawn by both\n", color_mode, i);
+      failures++;
+      break;
+    }
+  }
+
+  // Combine them, which has to give the rectangle. Pixel centers are at +0.5,
+  // so columns 3-59 and rows 1-7 are covered.
+  for(uint32_t i = 0; i < TEST_BUFFER_BYTES; i++)
+  {
+    if(first[i] != TEST_GUARD_BYTE)
+    {
+      test_buffer[i] = first[i];
+    }
+  }
+
+  reference_rect(&reference, reference.base, 3, 1, 57, 7, color);
+  test_compare("triangles", color_mode, 0, 0, 0);
+}
+
+int main(void)
+{
+  for(uint32_t color_mode = FB_RGB0555; color_mode <= FB_RGB0888; color_mode++)
+  {
+    for(uint32_t offset = 0; offset < 32; offset += FB_BYTES_PER_PIXEL(color_mode) == 3 ? 4 : 8)
+    {
+      test_spans(color_mode, offset);
+      test_rects(color_mode, offset);
+      test_pixels(color_mode, offset);
+    }
+
+    test_shared_edge(color_mode);
+  }
+
+  if(failures)
+  {
+    printf("rasterizer_test: %u failures\n", failures);
+    return 1;
+  }
+
+  printf("rasterizer_test: passed\n");
+  return 0;
+}
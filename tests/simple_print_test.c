@@ -0,0 +1,279 @@
+// ---- simple_print_test.c - Simple Print Host Test ----
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This is a host program (see Run_Tests.sh) that checks float_to_string()
+// against the host's own float formatting and parsing over a sweep of float
+// bit patterns. It is hereby released into the public domain in the hope that
+// it may prove useful.
+//
+
+// TEST_SOURCES: modules/simple_print.c modules/digits.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "simple_print.h"
+
+// Bit patterns to skip between checks. Prime, so that every mantissa and
+// exponent bit gets some variety.
+#define TEST_STRIDE 40009
+
+// The documented buffer size. The output goes into a heap block of exactly this
+// size, so ASan catches anything written past it.
+#define TEST_OUT_BYTES 16
+
+static char * test_out;
+static uint32_t failures = 0;
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static float bits_to_float(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static uint32_t float_to_bits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Fewest significant digits that read back as the same float, going by the
+// host's correctly rounded %.*g
+static int shortest_digits(float value)
+{
+  char buffer[64];
+
+  for(int digits = 1; digits < 9; digits++)
+  {
+    snprintf(buffer, sizeof(buffer), "%.*g", digits, (double)value);
+    if(float_to_bits(strtof(buffer, NULL)) == float_to_bits(value))
+    {
+      return digits;
+    }
+  }
+
+  return 9;
+}
+
+// Significant digits in one of float_to_string()'s outputs
+static int count_digits(const char * string)
+{
+  char digits[64];
+  int length = 0;
+
+  for(; *string && (*string != 'e'); string++)
+  {
+    if((*string >= '0') && (*string <= '9'))
+    {
+      digits[length++] = *string;
+    }
+  }
+
+  int first = 0;
+  while((first < length - 1) && (digits[first] == '0'))
+  {
+    first++;
+  }
+  while((length > first + 1) && (digits[length - 1] == '0'))
+  {
+    length--;
+  }
+
+  return length - first;
+}
+
+// What float_to_string() should print for 'digits' significant digits: the
+// host's %.*e digits, in %g's layout but without %g's precision rules
+static void reference_string(float value, int digits, char * out)
+{
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*e", digits - 1, (double)value);
+
+  const char * in = buffer;
+  if(*in == '-')
+  {
+    *out++ = *in++;
+  }
+
+  char mantissa[16];
+  int length = 0;
+  for(; *in != 'e'; in++)
+  {
+    if(*in != '.')
+    {
+      mantissa[length++] = *in;
+    }
+  }
+  int magnitude = atoi(in + 1);
+
+  if((magnitude < -4) || (magnitude >= 9))
+  {
+    sprintf(out, "%c%s%.*se%c%02d", mantissa[0], (length > 1) ? "." : "", length - 1, mantissa + 1, (magnitude < 0) ? '-' : '+', abs(magnitude));
+  }
+  else if(magnitude < 0)
+  {
+    *out++ = '0';
+    *out++ = '.';
+    for(int i = -1; i > magnitude; i--)
+    {
+      *out++ = '0';
+    }
+    sprintf(out, "%.*s", length, mantissa);
+  }
+  else
+  {
+    for(int i = 0; i < length; i++)
+    {
+      if(i == magnitude + 1)
+      {
+        *out++ = '.';
+      }
+      *out++ = mantissa[i];
+    }
+    for(int i = length; i <= magnitude; i++)
+    {
+      *out++ = '0';
+    }
+    *out = '\0';
+  }
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+
+static void test_finite(uint32_t bits)
+{
+  float value = bits_to_float(bits);
+  float_to_string(value, test_out);
+
+  if(strlen(test_out) >= TEST_OUT_BYTES)
+  {
+    printf("FAIL: 0x%08x: \"%s\" doesn't fit in %u bytes\n", bits, test_out, TEST_OUT_BYTES);
+    failures++;
+    return;
+  }
+
+  // Has to read back exactly, sign of zero included
+  if(float_to_bits(strtof(test_out, NULL)) != bits)
+  {
+    printf("FAIL: 0x%08x (%.9g): \"%s\" doesn't read back\n", bits, (double)value, test_out);
+    failures++;
+    return;
+  }
+
+  if(value == 0.0f)
+  {
+    return;
+  }
+
+  int digits = count_digits(test_out);
+  int shortest = shortest_digits(value);
+
+  // The round-trip interval of a power of 2 is lopsided, so it can hold a
+  // shorter number than the one nearest the float. That's the only time
+  // float_to_string() can beat the nearest n-digit number.
+  uint32_t power_of_2 = !(bits & 0x007fffff);
+
+  if((digits > shortest) || ((digits < shortest) && !power_of_2))
+  {
+    printf("FAIL: 0x%08x (%.9g): \"%s\" has %d digits, shortest is %d\n", bits, (double)value, test_out, digits, shortest);
+    failures++;
+    return;
+  }
+
+  if(digits == shortest)
+  {
+    char reference[64];
+    reference_string(value, digits, reference);
+
+    if(strcmp(test_out, reference))
+    {
+      printf("FAIL: 0x%08x (%.9g): \"%s\", expected \"%s\"\n", bits, (double)value, test_out, reference);
+      failures++;
+    }
+  }
+}
+
+static void test_exact(float value, const char * expected)
+{
+  float_to_string(value, test_out);
+
+  if(strcmp(test_out, expected))
+  {
+    printf("FAIL: %.9g: \"%s\", expected \"%s\"\n", (double)value, test_out, expected);
+    failures++;
+  }
+}
+
+int main(void)
+{
+  test_out = malloc(TEST_OUT_BYTES);
+
+  uint32_t checked = 0;
+
+  for(uint64_t bits = 0; bits <= 0xffffffffULL; bits += TEST_STRIDE)
+  {
+    if(((bits >> 23) & 0xff) != 0xff)
+    {
+      test_finite((uint32_t)bits);
+      checked++;
+    }
+  }
+
+  // Both ends of every exponent, with both signs
+  for(uint32_t exponent = 0; exponent < 0xff; exponent++)
+  {
+    for(uint32_t sign = 0; sign < 2; sign++)
+    {
+      uint32_t bits = (sign << 31) | (exponent << 23);
+      test_finite(bits);
+      test_finite(bits | 1);
+      test_finite(bits | 0x007fffff);
+      checked += 3;
+    }
+  }
+
+  // The 16-byte worst case is 9 digits with a sign, in either layout
+  test_exact(bits_to_float(0xb8d1b718), "-0.000100000005");
+  test_exact(bits_to_float(0x83aa242d), "-1.00000075e-36");
+  test_exact(-1.17549435e-38f, "-1.1754944e-38");
+  test_finite(0xb8d1b718);
+  test_finite(0x83aa242d);
+  test_finite(float_to_bits(-1.17549435e-38f));
+  test_finite(0x80000001); // -1e-45
+
+  // Layout switches
+  test_exact(100000000.0f, "100000000");
+  test_exact(1e9f, "1e+09");
+  test_exact(0.0001f, "0.0001");
+  test_exact(0.00001f, "1e-05");
+  test_exact(0.0f, "0");
+  test_exact(-0.0f, "-0");
+
+  test_exact(bits_to_float(0x7f800000), "Inf");
+  test_exact(bits_to_float(0xff800000), "-Inf");
+  test_exact(bits_to_float(0x7fc00000), "NaN");
+  test_exact(bits_to_float(0xffc00001), "NaN");
+
+  free(test_out);
+
+  if(failures)
+  {
+    printf("simple_print_test: %u failures in %u floats\n", failures, checked);
+    return 1;
+  }
+
+  printf("simple_print_test: passed (%u floats)\n", checked);
+  return 0;
+}
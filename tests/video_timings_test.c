@@ -0,0 +1,162 @@
+// ---- video_timings_test.c - CVT Timing Generator Host Test ----
+//
+// This file is part of the DreamHAL project, a hardware abstraction library
+// primarily intended for use on the SH7091 found in hardware such as the SEGA
+// Dreamcast game console.
+//
+// This is a host program (see Run_Tests.sh) that checks
+// STARTUP_Generate_Video_Timing() against the CVT-derived entries in
+// STARTUP_video_timings, and STARTUP_Find_Video_Timing() on a few entries. It
+// is hereby released into the public domain in the hope that it may prove
+// useful.
+//
+
+// TEST_SOURCES: startup/video_timings.c
+
+#include <stdio.h>
+#include "startup_support.h"
+
+#define FIELD_COUNT (sizeof(VIDEO_TIMING_STRUCT) / sizeof(uint16_t))
+
+static const char * const field_names[FIELD_COUNT] = {
+  "video_width", "video_height", "refresh_rate", "fb_width", "fb_height",
+  "h_total", "v_total", "hblank_start", "hblank_end", "vblank_start", "vblank_end",
+  "vblank_in_line", "vblank_out_line", "start_x", "start_y",
+  "hsync_width", "vsync_width", "bp_width", "eq_width"
+};
+
+// Table entry, CVT type, and the largest difference allowed in any field, in
+// pixels or lines. These are the tolerances documented for
+// STARTUP_Generate_Video_Timing() in startup_support.h.
+typedef struct {
+  uint32_t mode;
+  uint32_t cvt_type;
+  uint32_t tolerance;
+} TEST_CASE_STRUCT;
+
+static const TEST_CASE_STRUCT test_cases[] = {
+  {VIDEO_TIMING_800x600_VGA_CVT, CVT_STANDARD, 0},
+  {VIDEO_TIMING_1152x864_VGA, CVT_STANDARD, 0},
+  {VIDEO_TIMING_1280x720_VGA, CVT_STANDARD, 0},
+  {VIDEO_TIMING_1280x800_VGA, CVT_STANDARD, 0},
+  // The table's bp_width is 1 more than h_total - hsync_width
+  {VIDEO_TIMING_1440x900_VGA, CVT_STANDARD, 1},
+  {VIDEO_TIMING_640x480_VGA_120, CVT_RB, 0},
+  {VIDEO_TIMING_800x600_VGA_120, CVT_RB, 0},
+  // Hand-tuned in the table: 8 pixel hsync and the active area 9 pixels
+  // further left
+  {VIDEO_TIMING_1024x768_VGA_120, CVT_RB, 9},
+  // The table's RBv2 modes are the PVR 32x32 versions, so the framebuffer width
+  // and blanking are moved around by a pixel or two
+  {VIDEO_TIMING_640x480_VGA_75_CVT_RBv2, CVT_RBV2, 2},
+  {VIDEO_TIMING_848x480_VGA_CVT_RBv2, CVT_RBV2, 1}
+};
+
+#define TEST_CASE_COUNT (sizeof(test_cases) / sizeof(test_cases[0]))
+
+static uint32_t failures = 0;
+
+static void test_table_entry(const TEST_CASE_STRUCT * test)
+{
+  const VIDEO_TIMING_STRUCT * expected = &STARTUP_video_timings[test->mode];
+  VIDEO_TIMING_STRUCT generated = {0};
+
+  float scale = STARTUP_Generate_Video_Timing(&generated, expected->video_width, expected->video_height, expected->refresh_rate, test->cvt_type);
+
+  if(scale == 0.0f)
+  {
+    printf("FAIL: %ux%u@%u: no timing generated\n", expected->video_width, expected->video_height, expected->refresh_rate);
+    failures++;
+    return;
+  }
+
+  const uint16_t * expected_fields = (const uint16_t*)expected;
+  const uint16_t * generated_fields = (const uint16_t*)&generated;
+  uint32_t worst = 0;
+
+  for(uint32_t i = 0; i < FIELD_COUNT; i++)
+  {
+    int32_t difference = (int32_t)generated_fields[i] - (int32_t)expected_fields[i];
+    uint32_t magnitude = (uint32_t)((difference < 0) ? -difference : difference);
+
+    if(magnitude > worst)
+    {
+      worst = magnitude;
+    }
+
+    if(magnitude > test->tolerance)
+    {
+      printf("FAIL: %ux%u@%u: %s is %u, table has %u\n", expected->video_width, expected->video_height, expected->refresh_rate, field_names[i], generated_fields[i], expected_fields[i]);
+      failures++;
+    }
+  }
+
+  // Keep the documented tolerances honest in both directions
+  if(worst < test->tolerance)
+  {
+    printf("FAIL: %ux%u@%u: off by at most %u, but the tolerance is %u\n", expected->video_width, expected->video_height, expected->refresh_rate, worst, test->tolerance);
+    failures++;
+  }
+}
+
+// STARTUP_Find_Video_Timing() has to return the given entry for its own
+// resolution and refresh rate
+static void test_find(uint32_t mode, uint32_t pvr_32x32)
+{
+  const VIDEO_TIMING_STRUCT * timing = &STARTUP_video_timings[mode];
+
+  if(STARTUP_Find_Video_Timing(timing->video_width, timing->video_height, timing->refresh_rate, pvr_32x32) != timing)
+  {
+    printf("FAIL: mode %u (%ux%u@%u) can't be found\n", mode, timing->video_width, timing->video_height, timing->refresh_rate);
+    failures++;
+  }
+}
+
+static void test_rejected(uint32_t width, uint32_t height, uint32_t refresh_rate, uint32_t cvt_type)
+{
+  VIDEO_TIMING_STRUCT timing = {0};
+
+  if(STARTUP_Generate_Video_Timing(&timing, width, height, refresh_rate, cvt_type) != 0.0f)
+  {
+    printf("FAIL: %ux%u@%u type %u should have been rejected\n", width, height, refresh_rate, cvt_type);
+    failures++;
+  }
+
+  if(timing.h_total)
+  {
+    printf("FAIL: %ux%u@%u type %u wrote to the timing\n", width, height, refresh_rate, cvt_type);
+    failures++;
+  }
+}
+
+int main(void)
+{
+  for(uint32_t i = 0; i < TEST_CASE_COUNT; i++)
+  {
+    test_table_entry(&test_cases[i]);
+  }
+
+  test_find(VIDEO_TIMING_480p_VGA_240, 1);
+  test_find(VIDEO_TIMING_480p_VGA_239, 1);
+  test_find(VIDEO_TIMING_640x480_VGA, 0);
+  test_find(VIDEO_TIMING_848x480_VGA_PVR, 1);
+
+  // More than 1024 lines
+  test_rejected(1920, 1080, 60, CVT_STANDARD);
+  // Bad arguments
+  test_rejected(0, 480, 60, CVT_STANDARD);
+  test_rejected(640, 480, 0, CVT_RB);
+  test_rejected(640, 480, 60, CVT_RBV2 + 1);
+  // Less than one 8-pixel cell wide
+  test_rejected(4, 480, 60, CVT_STANDARD);
+  test_rejected(4, 480, 60, CVT_RB);
+
+  if(failures)
+  {
+    printf("video_timings_test: %u failures\n", failures);
+    return 1;
+  }
+
+  printf("video_timings_test: passed\n");
+  return 0;
+}
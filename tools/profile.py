@@ -0,0 +1,350 @@
+#!/usr/bin/env python3
+#
+# ---- profile.py - Sampling Profiler Host Tool ----
+#
+# Version 1.0.0
+#
+# This file is part of the DreamHAL project, a hardware abstraction library
+# primarily intended for use on the SH7091 found in hardware such as the SEGA
+# Dreamcast game console.
+#
+# This tool reads a sample file written by the profiler module (see
+# modules/profiler.h), matches the samples to functions using program.elf and
+# output.map, and prints flat and call-graph profiles. It is hereby released
+# into the public domain in the hope that it may prove useful.
+#
+# Usage:
+#  python3 tools/profile.py samples.prof [--elf program.elf] [--map output.map]
+#    [--top N] [--min-percent P]
+#
+# Notes:
+# - Compile.sh links with -s, which strips program.elf's symbol table. When
+#  that happens the symbols come from output.map instead, which only lists
+#  global symbols, so samples in static functions get counted toward whichever
+#  global function comes before them in the same object file. Remove -s from
+#  the link command to get every function by name.
+# - The call graph only goes one level deep: each sample's PR is taken as the
+#  caller, which is right for leaf functions and for functions that haven't
+#  called anything yet. Samples where PR points back into the same function
+#  aren't counted as calls.
+# - Addresses are compared with the P0-P3 area bits masked off, so code running
+#  from a cached or uncached mirror still matches.
+#
+
+import argparse
+import bisect
+import re
+import struct
+import sys
+
+PROF_FILE_MAGIC = 0x46504844
+PROF_FILE_VERSION = 1
+PROF_DROPPED_MARKER = 0xFFFFFFFF
+
+ADDRESS_MASK = 0x1FFFFFFF
+
+# Output sections in shlelf.xc that hold code
+CODE_SECTIONS = ('.text', '.init', '.fini')
+
+#------------------------------------------------------------------------------
+# Samples
+#------------------------------------------------------------------------------
+
+def read_samples(filename):
+  with open(filename, 'rb') as f:
+    data = f.read()
+
+  if len(data) < 16:
+    sys.exit('%s: too short to be a sample file' % filename)
+
+  magic, version, rate, _ = struct.unpack_from('<4I', data, 0)
+  if magic != PROF_FILE_MAGIC:
+    sys.exit('%s: not a sample file' % filename)
+  if version != PROF_FILE_VERSION:
+    sys.exit('%s: unsupported version %d' % (filename, version))
+
+  samples = []
+  dropped = 0
+
+  # A partial pair at the end means the stream wasn't closed cleanly
+  end = 16 + ((len(data) - 16) & ~7)
+  for pc, pr in struct.iter_unpack('<2I', data[16:end]):
+    if pc == PROF_DROPPED_MARKER:
+      dropped += pr
+    else:
+      samples.append((pc & ADDRESS_MASK, pr & ADDRESS_MASK))
+
+  return rate, samples, dropped
+
+#------------------------------------------------------------------------------
+# Symbols
+#------------------------------------------------------------------------------
+
+class SymbolTable:
+  def __init__(self):
+    # (start, end, name), sorted and non-overlapping once finish() is called
+    self.ranges = []
+    self.starts = []
+
+  def add(self, start, end, name, fallback=False):
+    if end > start:
+      self.ranges.append((start & ADDRESS_MASK, fallback, end & ADDRESS_MASK, name))
+
+  def finish(self):
+    # Each range ends where the next one starts, so symbols inside an input
+    # section take over from the section's own name. When two start at the same
+    # place, the one that isn't a fallback wins.
+    self.ranges.sort()
+    ranges = []
+    for start, fallback, end, name in self.ranges:
+      if ranges and ranges[-1][0] == start:
+        continue
+      if ranges and ranges[-1][1] > start:
+        ranges[-1] = (ranges[-1][0], start, ranges[-1][2])
+      ranges.append((start, end, name))
+    self.ranges = ranges
+    self.starts = [r[0] for r in ranges]
+
+  def lookup(self, address):
+    i = bisect.bisect_right(self.starts, address) - 1
+    if i >= 0:
+      start, end, name = self.ranges[i]
+      if address < end:
+        return name
+    return '0x%08x' % (address | 0x80000000)
+
+def demangle(name):
+  # SH C symbols have a leading underscore
+  if name.startswith('_') and not name.startswith('__'):
+    return name[1:]
+  return name
+
+def read_elf_symbols(filename, table):
+  with open(filename, 'rb') as f:
+    data = f.read()
+
+  if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+    sys.exit('%s: not a 32-bit little endian ELF file' % filename)
+
+  shoff, = struct.unpack_from('<I', data, 0x20)
+  shentsize, shnum = struct.unpack_from('<2H', data, 0x2E)
+
+  sections = []
+  for i in range(shnum):
+    sections.append(struct.unpack_from('<10I', data, shoff + i * shentsize))
+
+  # sh_type 2 is SHT_SYMTAB, sh_flags 4 is SHF_EXECINSTR
+  found = 0
+  for sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link, sh_info, sh_addralign, sh_entsize in sections:
+    if sh_type != 2:
+      continue
+
+    strtab_offset = sections[sh_link][4]
+    for offset in range(sh_offset, sh_offset + sh_size, 16):
+      st_name, st_value, st_size, st_info, st_other, st_shndx = struct.unpack_from('<3I2BH', data, offset)
+      st_type = st_info & 0xF
+
+      # Functions, plus untyped labels from assembly (like the VBR table)
+      if st_type not in (0, 2) or st_shndx == 0 or st_shndx >= len(sections):
+        continue
+      if not (sections[st_shndx][2] & 4):
+        continue
+
+      end = data.index(b'\0', strtab_offset + st_name)
+      name = data[strtab_offset + st_name:end].decode('ascii', 'replace')
+      if not name or name.startswith('.L'):
+        continue
+
+      # Untyped labels have no size, so give them a token one and let the next
+      # symbol cut it short
+      table.add(st_value, st_value + (st_size if st_size else 0x10000), demangle(name))
+      found += 1
+
+  return found
+
+MAP_OUTPUT_SECTION = re.compile(r'^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+MAP_OUTPUT_SECTION_NAME = re.compile(r'^(\.\S+)\s*$')
+MAP_INPUT_SECTION = re.compile(r'^ (\.\S+|\*fill\*)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$')
+MAP_INPUT_SECTION_NAME = re.compile(r'^ (\.\S+)\s*$')
+MAP_CONTINUATION = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$')
+MAP_SYMBOL = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$')
+
+def read_map_symbols(filename, table):
+  with open(filename, 'r', errors='replace') as f:
+    lines = f.read().splitlines()
+
+  # Skip everything before the memory map itself
+  for i, line in enumerate(lines):
+    if line.startswith('Linker script and memory map'):
+      lines = lines[i + 1:]
+      break
+
+  in_code = False
+  pending_output = None
+  pending_input = None
+  # Symbols within the current input section, which end where it does
+  section_end = 0
+  symbols = []
+  found = 0
+
+  def flush_symbols():
+    nonlocal found
+    symbols.sort()
+    for i, (address, name) in enumerate(symbols):
+      end = symbols[i + 1][0] if i + 1 < len(symbols) else section_end
+      table.add(address, end, name)
+      found += 1
+    symbols.clear()
+
+  for line in lines:
+    # Long section names push the address onto the next line
+    if pending_output is not None:
+      m = MAP_CONTINUATION.match(line)
+      line = '%s %s' % (pending_output, line.strip()) if m else line
+      pending_output = None
+    if pending_input is not None:
+      m = MAP_CONTINUATION.match(line)
+      line = ' %s %s' % (pending_input, line.strip()) if m else line
+      pending_input = None
+
+    m = MAP_OUTPUT_SECTION_NAME.match(line)
+    if m:
+      pending_output = m.group(1)
+      continue
+
+    m = MAP_OUTPUT_SECTION.match(line)
+    if m:
+      flush_symbols()
+      in_code = m.group(1) in CODE_SECTIONS
+      continue
+
+    if line and not line[0].isspace():
+      flush_symbols()
+      in_code = False
+      continue
+
+    if not in_code:
+      continue
+
+    m = MAP_INPUT_SECTION_NAME.match(line)
+    if m:
+      pending_input = m.group(1)
+      continue
+
+    m = MAP_INPUT_SECTION.match(line)
+    if m:
+      flush_symbols()
+      start = int(m.group(2), 16)
+      size = int(m.group(3), 16)
+      section_end = start + size
+      if m.group(1) != '*fill*' and size:
+        # Anything in the section before its first symbol is named after the
+        # object file
+        obj = m.group(4).strip() or '?'
+        table.add(start, section_end, '%s(%s)' % (obj.split('/')[-1], m.group(1)), True)
+      continue
+
+    m = MAP_SYMBOL.match(line)
+    if m:
+      symbols.append((int(m.group(1), 16), demangle(m.group(2))))
+
+  flush_symbols()
+  return found
+
+#------------------------------------------------------------------------------
+# Reports
+#------------------------------------------------------------------------------
+
+def percent(count, total):
+  return 100.0 * count / total if total else 0.0
+
+def print_flat(self_counts, total, rate, top, min_percent):
+  print('Flat profile (%d samples, %.3f seconds at %d samples per second)' % (total, total / rate if rate else 0.0, rate))
+  print()
+  print('  %self  cumul%   samples  function')
+
+  cumulative = 0
+  shown = 0
+  for name, count in sorted(self_counts.items(), key=lambda item: (-item[1], item[0])):
+    if shown == top or percent(count, total) < min_percent:
+      break
+    cumulative += count
+    print('%7.2f %7.2f %9d  %s' % (percent(count, total), percent(cumulative, total), count, name))
+    shown += 1
+  print()
+
+def print_call_graph(self_counts, edges, total, top, min_percent):
+  callers = {}
+  callees = {}
+  for (caller, callee), count in edges.items():
+    callers.setdefault(callee, []).append((count, caller))
+    callees.setdefault(caller, []).append((count, callee))
+
+  print('Call graph (one level, from PR at each sample)')
+  print()
+
+  shown = 0
+  for name, count in sorted(self_counts.items(), key=lambda item: (-item[1], item[0])):
+    if shown == top or percent(count, total) < min_percent:
+      break
+    shown += 1
+
+    for edge_count, caller in sorted(callers.get(name, []), key=lambda item: (-item[0], item[1])):
+      print('              %9d    <- %s' % (edge_count, caller))
+    print('%7.2f %5s %9d  %s' % (percent(count, total), '', count, name))
+    for edge_count, callee in sorted(callees.get(name, []), key=lambda item: (-item[0], item[1])):
+      print('              %9d    -> %s' % (edge_count, callee))
+    print('-' * 60)
+  print()
+
+#------------------------------------------------------------------------------
+# Main
+#------------------------------------------------------------------------------
+
+def main():
+  parser = argparse.ArgumentParser(description='Symbolize DreamHAL profiler samples.')
+  parser.add_argument('samples', help='sample file written by PROF_Open_Stream()')
+  parser.add_argument('--elf', default='program.elf', help='linked program (default: program.elf)')
+  parser.add_argument('--map', default='output.map', help='linker map (default: output.map)')
+  parser.add_argument('--top', type=int, default=50, help='functions to show (default: 50)')
+  parser.add_argument('--min-percent', type=float, default=0.0, help='hide functions below this share of samples')
+  args = parser.parse_args()
+
+  rate, samples, dropped = read_samples(args.samples)
+
+  table = SymbolTable()
+  found = 0
+  try:
+    found = read_elf_symbols(args.elf, table)
+  except FileNotFoundError:
+    pass
+  if not found:
+    try:
+      found = read_map_symbols(args.map, table)
+    except FileNotFoundError:
+      pass
+  if not found:
+    print('warning: no symbols found in %s or %s' % (args.elf, args.map), file=sys.stderr)
+  table.finish()
+
+  self_counts = {}
+  edges = {}
+  for pc, pr in samples:
+    callee = table.lookup(pc)
+    self_counts[callee] = self_counts.get(callee, 0) + 1
+
+    # PR is the address after the call's delay slot; back up into the call so a
+    # call at the very end of a function still lands in that function
+    caller = table.lookup(pr - 2) if pr else None
+    if caller and caller != callee:
+      edges[(caller, callee)] = edges.get((caller, callee), 0) + 1
+
+  total = len(samples)
+  print_flat(self_counts, total, rate, args.top, args.min_percent)
+  print_call_graph(self_counts, edges, total, args.top, args.min_percent)
+
+  if dropped:
+    print('%d samples were dropped because the ring buffer was full (%.2f%%).' % (dropped, percent(dropped, total + dropped)))
+
+if __name__ == '__main__':
+  main()
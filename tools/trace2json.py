@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# ---- trace2json.py - Trace Event Converter Host Tool ----
+#
+# Version 1.0.0
+#
+# This file is part of the DreamHAL project, a hardware abstraction library
+# primarily intended for use on the SH7091 found in hardware such as the SEGA
+# Dreamcast game console.
+#
+# This tool converts a trace file written by the trace module (see
+# modules/trace.h) into Chrome trace event JSON, which Perfetto
+# (ui.perfetto.dev) and chrome://tracing can open. It is hereby released into
+# the public domain in the hope that it may prove useful.
+#
+# Usage:
+#  python3 tools/trace2json.py trace.bin [-o trace.json]
+#
+# Notes:
+# - Timestamps are converted from CPU cycles to microseconds using the rate in
+#  the file header. The 48-bit cycle count wrapping (after about 16 days) is
+#  handled.
+# - Events recorded in interrupt handlers are shown on their own track.
+# - Dropped events show up as instant events called "dropped events" with the
+#  count in their arguments.
+#
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_FILE_MAGIC = 0x52544844
+TRACE_FILE_VERSION = 1
+
+TRACE_TYPE_BEGIN = 1
+TRACE_TYPE_END = 2
+TRACE_TYPE_INSTANT = 3
+TRACE_TYPE_COUNTER = 4
+TRACE_TYPE_NAME = 5
+TRACE_TYPE_DROPPED = 6
+
+TRACK_NAMES = {0: 'main', 1: 'interrupts'}
+
+RECORD = struct.Struct('<IHBBII')
+
+def convert(data):
+  if len(data) < 16:
+    sys.exit('too short to be a trace file')
+
+  magic, version, rate, _ = struct.unpack_from('<4I', data, 0)
+  if magic != TRACE_FILE_MAGIC:
+    sys.exit('not a trace file')
+  if version != TRACE_FILE_VERSION:
+    sys.exit('unsupported version %d' % version)
+  if not rate:
+    sys.exit('bad timestamp rate')
+
+  names = {}
+  events = []
+  tracks = set()
+
+  # Cycle counts are 48 bits, so keep track of wraps
+  last_cycles = 0
+  wrap_offset = 0
+  first_cycles = None
+
+  offset = 16
+  while offset + RECORD.size <= len(data):
+    low, high, kind, track, name, value = RECORD.unpack_from(data, offset)
+    offset += RECORD.size
+
+    if kind == TRACE_TYPE_NAME:
+      text = data[offset:offset + low].decode('utf-8', 'replace')
+      names[name] = text
+      offset += (low + 3) & ~3
+      continue
+
+    if kind == TRACE_TYPE_DROPPED:
+      ts = ((last_cycles - first_cycles) if first_cycles is not None else 0) * 1e6 / rate
+      events.append({'name': 'dropped events', 'ph': 'i', 's': 'g', 'ts': ts, 'pid': 1, 'tid': 0, 'args': {'count': value}})
+      continue
+
+    cycles = (high << 32) | low
+    if cycles + wrap_offset < last_cycles - (1 << 47):
+      wrap_offset += 1 << 48
+    cycles += wrap_offset
+    last_cycles = cycles
+    if first_cycles is None:
+      first_cycles = cycles
+
+    ts = (cycles - first_cycles) * 1e6 / rate
+    label = names.get(name, '0x%08x' % name)
+    tracks.add(track)
+
+    event = {'name': label, 'ts': ts, 'pid': 1, 'tid': track}
+    if kind == TRACE_TYPE_BEGIN:
+      event['ph'] = 'B'
+    elif kind == TRACE_TYPE_END:
+      event['ph'] = 'E'
+    elif kind == TRACE_TYPE_INSTANT:
+      event['ph'] = 'i'
+      event['s'] = 't'
+    elif kind == TRACE_TYPE_COUNTER:
+      event['ph'] = 'C'
+      event['args'] = {label: value}
+    else:
+      continue
+
+    events.append(event)
+
+  if offset != len(data):
+    print('warning: trace ends with a partial record (stream not closed?)', file=sys.stderr)
+
+  metadata = [{'name': 'process_name', 'ph': 'M', 'pid': 1, 'args': {'name': 'Dreamcast'}}]
+  for track in sorted(tracks | {0}):
+    metadata.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': track, 'args': {'name': TRACK_NAMES.get(track, 'track %d' % track)}})
+
+  return {'traceEvents': metadata + events, 'displayTimeUnit': 'ms'}
+
+def main():
+  parser = argparse.ArgumentParser(description='Convert a DreamHAL trace file to Chrome trace event JSON.')
+  parser.add_argument('trace', help='trace file written by TRACE_Open_Stream()')
+  parser.add_argument('-o', '--output', help='output file (default: standard output)')
+  args = parser.parse_args()
+
+  with open(args.trace, 'rb') as f:
+    result = convert(f.read())
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(result, f)
+  else:
+    json.dump(result, sys.stdout)
+    print()
+
+if __name__ == '__main__':
+  main()